@@ -96,6 +96,7 @@ void HPL_warn(FILE *, int, const char *, const char *, ...);
 void HPL_abort(int, const char *, const char *, ...);
 void HPL_dlacpy(const int, const int, const double *, const int, double *, const int, int );
 void HPL_dlatcpy(const int, const int, const double *, const int, double *, const int);
+int HPL_dlatcpy_streaming(const int, const int);
 double HPL_dlange(const HPL_T_NORM, const int, const int, const double *, const int);
 double HPL_dlamch(const HPL_T_MACH);
 
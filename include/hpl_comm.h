@@ -64,6 +64,7 @@
  */
 #include "hpl_pmisc.h"
 #include "hpl_panel.h"
+#include "util_runtimeconfig.h"
 /*
  * ---------------------------------------------------------------------
  * #typedefs and data structures
@@ -121,50 +122,50 @@ int HPL_bcast_blonM ( HPL_T_panel *);
 int HPL_binit_mpi ( HPL_T_panel * );
 int HPL_bcast_mpi ( HPL_T_panel *);
 
-#ifndef HPL_MAX_MPI_SEND_SIZE
-#define HPL_MAX_MPI_SEND_SIZE (4 * 1024 * 1024)
-#endif
-#ifndef HPL_MAX_MPI_BCAST_SIZE 
-#define HPL_MAX_MPI_BCAST_SIZE HPL_MAX_MPI_SEND_SIZE
-#endif
+//Chunk sizes of the MPI wrappers, the compile time defaults HPL_MAX_MPI_SEND_SIZE and HPL_MAX_MPI_BCAST_SIZE are applied in HPL_pdinfo
+#define HPL_MPI_SEND_CHUNK (global_runtime_config.max_mpi_send_size)
+#define HPL_MPI_BCAST_CHUNK (global_runtime_config.max_mpi_bcast_size ? global_runtime_config.max_mpi_bcast_size : HPL_MPI_SEND_CHUNK)
 
 #if defined(HPL_NO_MPI_DATATYPE) & defined(HPL_MPI_WRAPPERS)
 static inline int MPI_Send_Mod(void *buf, const int count, MPI_Datatype datatype, const int dest, const int tag, MPI_Comm comm)
 {
+	const int chunk = HPL_MPI_SEND_CHUNK;
 	int i, retval = MPI_SUCCESS;
-	for (i = 0;i < count;i += HPL_MAX_MPI_SEND_SIZE)
+	for (i = 0;i < count;i += chunk)
 	{
-		retval = MPI_Send((void*) ((char*) buf + i * sizeof(double)), count - i < HPL_MAX_MPI_SEND_SIZE ? count - i : HPL_MAX_MPI_SEND_SIZE, datatype, dest, tag, comm);
+		retval = MPI_Send((void*) ((char*) buf + i * sizeof(double)), count - i < chunk ? count - i : chunk, datatype, dest, tag, comm);
 	}
 	return(retval);
 }
 
 static inline int MPI_Recv_Mod(void *buf, const int count, MPI_Datatype datatype, const int source, const int tag, MPI_Comm comm, MPI_Status *status)
 {
+	const int chunk = HPL_MPI_SEND_CHUNK;
 	int i, retval = MPI_SUCCESS;
-	for (i = 0;i < count;i += HPL_MAX_MPI_SEND_SIZE)
+	for (i = 0;i < count;i += chunk)
 	{
-		retval = MPI_Recv((void*) ((char*) buf + i * sizeof(double)), count - i < HPL_MAX_MPI_SEND_SIZE ? count - i : HPL_MAX_MPI_SEND_SIZE, datatype, source, tag, comm, status);
+		retval = MPI_Recv((void*) ((char*) buf + i * sizeof(double)), count - i < chunk ? count - i : chunk, datatype, source, tag, comm, status);
 	}
 	return(retval);
 }
 
 static inline int MPI_Sendrecv_Mod(void *sbuf, const int scount, MPI_Datatype sdatatype, const int dest, const int stag, void *rbuf, const int rcount, MPI_Datatype rdatatype, const int source, const int rtag, MPI_Comm comm, MPI_Status *status)
 {
+	const int chunk = HPL_MPI_SEND_CHUNK;
 	int i, retval = MPI_SUCCESS;
-	for (i = 0;i < (scount > rcount ? scount : rcount);i += HPL_MAX_MPI_SEND_SIZE)
+	for (i = 0;i < (scount > rcount ? scount : rcount);i += chunk)
 	{
 		if (i < scount && i < rcount)
 		{
-			retval = MPI_Sendrecv((void*) ((char*) sbuf + i * sizeof(double)), scount - i < HPL_MAX_MPI_SEND_SIZE ? scount - i : HPL_MAX_MPI_SEND_SIZE, sdatatype, dest, stag, (void*) ((char*) rbuf + i * sizeof(double)), rcount - i < HPL_MAX_MPI_SEND_SIZE ? rcount - i : HPL_MAX_MPI_SEND_SIZE, rdatatype, source, rtag, comm, status);
+			retval = MPI_Sendrecv((void*) ((char*) sbuf + i * sizeof(double)), scount - i < chunk ? scount - i : chunk, sdatatype, dest, stag, (void*) ((char*) rbuf + i * sizeof(double)), rcount - i < chunk ? rcount - i : chunk, rdatatype, source, rtag, comm, status);
 		}
 		else if (i < scount)
 		{
-			retval = MPI_Send((void*) ((char*) sbuf + i * sizeof(double)), scount - i < HPL_MAX_MPI_SEND_SIZE ? scount - i : HPL_MAX_MPI_SEND_SIZE, sdatatype, dest, stag, comm);
+			retval = MPI_Send((void*) ((char*) sbuf + i * sizeof(double)), scount - i < chunk ? scount - i : chunk, sdatatype, dest, stag, comm);
 		}
 		else
 		{
-			retval = MPI_Recv((void*) ((char*) rbuf + i * sizeof(double)), rcount - i < HPL_MAX_MPI_SEND_SIZE ? rcount - i : HPL_MAX_MPI_SEND_SIZE, rdatatype, source, rtag, comm, status);
+			retval = MPI_Recv((void*) ((char*) rbuf + i * sizeof(double)), rcount - i < chunk ? rcount - i : chunk, rdatatype, source, rtag, comm, status);
 		}
 	}
 	return(retval);
@@ -172,10 +173,11 @@ static inline int MPI_Sendrecv_Mod(void *sbuf, const int scount, MPI_Datatype sd
 
 static inline int MPI_Bcast_Mod(void *buffer, const int count, MPI_Datatype datatype, const int root, MPI_Comm comm)
 {
+	const int chunk = HPL_MPI_BCAST_CHUNK;
 	int i, retval = MPI_SUCCESS;
-	for (i = 0;i < count;i += HPL_MAX_MPI_BCAST_SIZE)
+	for (i = 0;i < count;i += chunk)
 	{
-		retval = MPI_Bcast((void*) ((char*) buffer + i * sizeof(double)), count - i < HPL_MAX_MPI_SEND_SIZE ? count - i : HPL_MAX_MPI_SEND_SIZE, datatype, root, comm);
+		retval = MPI_Bcast((void*) ((char*) buffer + i * sizeof(double)), count - i < chunk ? count - i : chunk, datatype, root, comm);
 	}
 	return(retval);
 }
@@ -104,6 +104,13 @@ typedef struct HPL_S_grid
 	int col_mask; /* col_ip2m1 procs hypercube mask */
 	int* col_mapping;
 	int* mcols_per_pcol;
+	int* col_count; /* columns of process column q before NB block k at [k * npcol + q] */
+	int* col_prev; /* previous NB block of the same process column as NB block k, -1 if none */
+	int* block_offset; /* first column of the variable width blocks, NULL for uniform NB */
+	int nblocks; /* number of variable width blocks */
+	int* row_mapping; /* process row of every NB block of rows, NULL for block-cyclic rows */
+	int* row_count; /* rows of process row p before NB block k at [k * nprow + p] */
+	int row_blocks; /* number of NB blocks in row_mapping */
 } HPL_T_grid;
 
 /*
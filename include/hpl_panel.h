@@ -119,8 +119,11 @@ void HPL_pdpanel_init( HPL_T_grid *, HPL_T_palg *, const int, const int, const i
 int HPL_pdpanel_disp( HPL_T_panel * *);
 int HPL_pdpanel_free( HPL_T_panel * );
 
-size_t panel_estimate_max_size(HPL_T_grid* GRID, HPL_T_palg* ALGO, int N, int M, int JB);
+size_t panel_estimate_max_size(HPL_T_grid* GRID, HPL_T_palg* ALGO, int N, int NB);
 void panel_preset_pointers(double* base_ptr);
+void panel_arena_release(HPL_T_panel* PANEL);
+size_t panel_arena_reserved();
+size_t panel_arena_peak();
 
 #endif
 /*
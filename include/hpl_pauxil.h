@@ -83,9 +83,13 @@
 			proc_ = grid->col_mapping[(ig_) / (nb_)]; \
 		 }
 
-#define Mindxg2p_row( ig_, inb_, nb_, proc_, nprocs_ ) \
+#define Mindxg2p_row( ig_, inb_, nb_, proc_, nprocs_, grid ) \
 		 { \
-		 if( ( (ig_) >= (inb_) ) && ( (nprocs_) > 1 ) ) \
+		 if( (grid)->row_mapping ) \
+			 { \
+			 proc_ = (grid)->row_mapping[(ig_) / (nb_)]; \
+			 } \
+		 else if( ( (ig_) >= (inb_) ) && ( (nprocs_) > 1 ) ) \
 			 { \
 			 proc_ = 1 + ( (ig_)-(inb_) ) / (nb_); \
 			 proc_ -= ( proc_ / (nprocs_) ) * (nprocs_); \
@@ -96,9 +100,13 @@
 			 } \
 		 }
 
-#define Mindxg2l_row( il_, ig_, inb_, nb_, proc_, nprocs_ ) \
+#define Mindxg2l_row( il_, ig_, inb_, nb_, proc_, nprocs_, grid ) \
 		 { \
-		 if( ( (ig_) < (inb_) ) || ( (nprocs_) == 1 ) ) { il_ = (ig_); } \
+		 if( (grid)->row_mapping ) \
+			 { \
+			 il_ = HPL_rowcount( (ig_), (nb_), (grid)->row_mapping[(ig_) / (nb_)], (grid) ); \
+			 } \
+		 else if( ( (ig_) < (inb_) ) || ( (nprocs_) == 1 ) ) { il_ = (ig_); } \
 			 else \
 			 { \
 			 int i__, j__; \
@@ -113,9 +121,13 @@
  * Mindxl2g computes the global index ig_ corresponding to the local
  * index il_ in process proc_.
  */
-#define Mindxl2g_row( ig_, il_, inb_, nb_, proc_, nprocs_ ) \
+#define Mindxl2g_row( ig_, il_, inb_, nb_, proc_, nprocs_, grid ) \
 		 { \
-		 if( ( (nprocs_) > 1 ) ) \
+		 if( (grid)->row_mapping ) \
+			 { \
+			 ig_ = HPL_rowl2g( (il_), (nb_), (proc_), (grid) ); \
+			 } \
+		 else if( ( (nprocs_) > 1 ) ) \
 			 { \
 			 if( (proc_) == 0 ) \
 				 { \
@@ -143,9 +155,14 @@
  * src_, and that the indexes are distributed from src_ using the para-
  * meters inb_, nb_ and nprocs_.
  */
-#define MnumrowI( np_, n_, i_, nb_, proc_, nprocs_ ) \
+#define MnumrowI( np_, n_, i_, nb_, proc_, nprocs_, grid ) \
 		 { \
-		 if( ( (nprocs_) > 1 ) ) \
+		 if( (grid)->row_mapping ) \
+			 { \
+			 np_ = HPL_rowcount( (i_) + (n_), (nb_), (proc_), (grid) ) - \
+			 HPL_rowcount( (i_), (nb_), (proc_), (grid) ); \
+			 } \
+		 else if( ( (nprocs_) > 1 ) ) \
 			 { \
 			 int inb__, mydist__, n__, nblk__, quot__, src__; \
 			 if( ( inb__ = (nb_) - (i_) ) <= 0 ) \
@@ -227,8 +244,8 @@
 			 } \
 		 }
 
-#define Mnumrow( np_, n_, nb_, proc_, nprocs_ ) \
-	MnumrowI( np_, n_, 0, nb_, proc_, nprocs_ )
+#define Mnumrow( np_, n_, nb_, proc_, nprocs_, grid ) \
+	MnumrowI( np_, n_, 0, nb_, proc_, nprocs_, grid )
 
 #define Mnumcol( np_, n_, nb_, proc_, grid ) \
 	{ \
@@ -241,10 +258,20 @@
  */
 int HPL_indxg2p_col( const int, const int, const HPL_T_grid* );
 void HPL_infog2l( int, int, const int, const int, const int, const int, const int, const int, const int, const int, int *, int *, int *, int *, const HPL_T_grid* );
-int HPL_numrow( const int, const int, const int, const int );
-int HPL_numrowI( const int, const int, const int, const int, const int );
+int HPL_numrow( const int, const int, const int, const int, const HPL_T_grid* );
+int HPL_numrowI( const int, const int, const int, const int, const int, const HPL_T_grid* );
 int HPL_numcol( const int, const int, const int, const HPL_T_grid* );
 int HPL_numcolI( const int, const int, const int, const int, const HPL_T_grid* );
+int HPL_blockindex( const int, const int, const HPL_T_grid* );
+int HPL_blockstart( const int, const int, const HPL_T_grid* );
+int HPL_blockend( const int, const int, const HPL_T_grid* );
+int HPL_colcount( const int, const int, const int, const HPL_T_grid* );
+int HPL_rowcount( const int, const int, const int, const HPL_T_grid* );
+int HPL_rowl2g( const int, const int, const int, const HPL_T_grid* );
+int HPL_colmapping( FILE *, const HPL_T_grid*, const int, const int, const float*, const int, const int*, int*, int* );
+void HPL_colmapping_tables( HPL_T_grid*, const int, const int );
+void HPL_rowmapping( FILE *, const HPL_T_grid*, const int, const int, const float*, int*, int* );
+void HPL_rowmapping_tables( HPL_T_grid*, const int, const int );
 
 void HPL_dlaswp00N( const int, const int, double *, const int, const int * );
 void HPL_dlaswp10N( const int, const int, double *, const int, const int * );
@@ -259,11 +286,13 @@ void HPL_dlaswp05N( const int, const int, double *, const int, const double *, c
 void HPL_dlaswp05T( const int, const int, double *, const int, const double *, const int, const int *, const int * );
 void HPL_dlaswp06N( const int, const int, double *, const int, double *, const int, const int * );
 void HPL_dlaswp06T( const int, const int, double *, const int, double *, const int, const int * );
+void HPL_laswp_set_threads( const int );
 
 void HPL_pabort( int, const char *, const char *, ...);
 void HPL_pwarn( FILE *, int, const char *, const char *, ... );
 double HPL_pdlamch( MPI_Comm, const HPL_T_MACH );
 double HPL_pdlange( const HPL_T_grid *, const HPL_T_NORM, const int, const int, const int, const double *, const int );
+void HPL_pdlange_fused( const HPL_T_grid *, const int, const int, const int, const double *, const int, double * );
 
 #endif
 /*
@@ -129,23 +129,35 @@ typedef struct HPL_S_pmat
  * ---------------------------------------------------------------------
  */
 void HPL_pipid( HPL_T_panel *, int *, int * );
+int * HPL_pipid_rowmap( const int );
 void HPL_pdlaswp00N( HPL_T_panel *, int *, HPL_T_panel *, const int );
-void HPL_pdlaswp00T( HPL_T_panel *, int *, HPL_T_panel *, const int );
+void HPL_pdlaswp00T( HPL_T_panel *, const int, const int *, const int, double *, const int, double *, const int );
+size_t HPL_pdlaswp00T_memory( HPL_T_grid *, const int, const int );
+void HPL_pdlaswp00T_free( void );
 
 void HPL_perm( const int, int *, int *, int * );
 void HPL_logsort( const int, const int, int *, int *, int * );
 void HPL_plindx10( HPL_T_panel *, const int, const int *, int *, int *, int * );
 void HPL_plindx1( HPL_T_panel *, const int, const int *, int *, int *, int *, int *, int *, int *, int *, int * );
+void HPL_plindxrow( const int, const int *, const int, const int, const int *, int *, int * );
 void HPL_spreadT( HPL_T_panel *, const enum HPL_SIDE, const int, double *, const int, const int, const int *, const int *, const int * );
 int HPL_equil( HPL_T_panel *, const int, double *, const int, int *, const int *, const int *, int * );
 void HPL_rollT( HPL_T_panel *, const int, double *, const int, const int *, const int *, const int * );
 int* HPL_pdlaswp01T( HPL_T_panel *, const int );
 
-void HPL_pdgesv( HPL_T_grid *, HPL_T_palg *, HPL_T_pmat *, int warmup );
+void HPL_pdgesv( HPL_T_grid *, HPL_T_palg *, HPL_T_pmat *, int warmup, int jstart, int jend );
 void HPL_pdgesv_prepare_panel( HPL_T_grid *, HPL_T_palg *, HPL_T_pmat * );
+int HPL_pdgesv_get_nb( int, int );
+int HPL_pdgesv_get_width( const HPL_T_grid *, int, int, int );
 void HPL_pdgesv_delete_panel();
+void HPL_pdgesv_window( int *, int * );
+int HPL_pdgesv_iterations( const int **, const int **, const double ** );
  
 void HPL_pdtrsv( HPL_T_grid *, HPL_T_pmat * );
+void HPL_pdrebalance_begin( void );
+int HPL_pdrebalance( HPL_T_grid *, HPL_T_pmat *, const int, const double, const double );
+int HPL_pdrebalance_weights( const float ** );
+void HPL_pdtail( HPL_T_grid *, HPL_T_pmat *, const int );
 
 #endif
 /*
@@ -73,6 +73,8 @@
  * ---------------------------------------------------------------------
  */
 void HPL_pdmatgen( const HPL_T_grid *, const int, const int, const int, double *, const int, const int );
+void HPL_pdmatgen_cols( const HPL_T_grid *, const int, const int, const int, double *, const int, const int, const int, const int );
+void HPL_pdmatgen_counter( const HPL_T_grid *, const int, const int, const int, double *, const int, const int, const int, const int );
 
 #endif
 /*
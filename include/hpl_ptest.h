@@ -123,6 +123,8 @@ typedef struct HPL_S_test
 #define    HPL_TIMING_UBCAST     24
 #define    HPL_TIMING_PIPELINE   25
 #define    HPL_TIMING_PREPIPELINE   26
+#define    HPL_TIMING_PIVINDEX   27 /* pivot index arrays (pipid, plindx1) */
+#define    HPL_TIMING_OOCWAIT    28 /* waiting for out-of-core read-ahead */
 #endif
 /*
  * ---------------------------------------------------------------------
@@ -132,6 +134,17 @@ typedef struct HPL_S_test
 void HPL_pdinfo( HPL_T_test *, int *, int *, int *, int *, HPL_T_ORDER *, int *, int *, int *, int *, HPL_T_FACT *, int *, int *, int *, int *, int *,
    HPL_T_FACT *, int *, HPL_T_TOP *, int *, int *, int *, int * );
 void HPL_pdtest( HPL_T_test *, HPL_T_grid *, HPL_T_palg *, const int, const int, const int );
+size_t HPL_pdtest_memory( HPL_T_grid *, HPL_T_palg *, const int, const int );
+int HPL_pdtest_auto_n( HPL_T_grid *, HPL_T_palg *, const int, const int, const size_t );
+double HPL_pdtest_flops( const int, const int, const int );
+int HPL_pdtest_column( const int, const double );
+double HPL_pdtest_estimate( const HPL_T_grid *, const int, const int, const int, const int *, const int *, const double * );
+int HPL_pdtest_windows( HPL_T_grid *, HPL_T_palg *, const int, const int, const int, const int, const int *, const int *, double *, double * );
+void HPL_pddriver_mapping( HPL_T_test *, HPL_T_grid *, const HPL_T_ORDER, const int, const int );
+void HPL_pddriver_unmapping( HPL_T_grid * );
+void HPL_pdtune( HPL_T_test *, HPL_T_grid *, const HPL_T_ORDER, const int, const int, const int, const int *, const int, const int *, const int, const int *,
+   const int, const HPL_T_FACT *, const int, const HPL_T_FACT *, const int, const HPL_T_TOP *, const int, const int *, const int );
+void HPL_pdcalibrate( HPL_T_test *, const int );
 void HPL_readruntimeconfig(void);
 
 #endif
@@ -69,6 +69,8 @@ void CALDGEMM_reset();
 void CALDGEMM_Wait(int n);
 void CALDGEMM_Finish();
 void CALDGEMM_UpdateParameters();
+double CALDGEMM_set_gpu_ratio(double ratio);
+void CALDGEMM_set_num_devices(int num);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,134 @@
+/**
+ * Utility header for capturing kernel calls
+ *
+ * Copyright 2010:
+ *  - David Rohr (drohr@jwdt.org)
+ *  - Matthias Bach (bach@compeng.uni-frankfurt.de)
+ *  - Matthias Kretz (kretz@compeng.uni-frankfurt.de)
+ *
+ * This file is part of HPL-GPU.
+ *
+ * HPL-GPU is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * HPL-GPU is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with HPL-GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition to the rules layed out by the GNU General Public License
+ * the following exception is granted:
+ *
+ * Use with the Original BSD License.
+ *
+ * Notwithstanding any other provision of the GNU General Public License
+ * Version 3, you have permission to link or combine any covered work with
+ * a work licensed under the 4-clause BSD license into a single combined
+ * work, and to convey the resulting work.  The terms of this License will
+ * continue to apply to the part which is the covered work, but the special
+ * requirements of the 4-clause BSD license, clause 3, concerning the
+ * requirement of acknowledgement in advertising materials will apply to
+ * the combination as such.
+ */
+
+#ifndef UTIL_CAPTURE_H
+#define UTIL_CAPTURE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Kernels that can be captured. The numbers are stored in the capture file,
+ * so only append new entries.
+ */
+enum capture_kernel
+{
+	CAPTURE_ITERATION = 0,	/* marker at the start of an iteration: j, n, jb */
+	CAPTURE_DLASWP00N = 1,	/* M, N, LDA; IPIV[M] */
+	CAPTURE_DLASWP01T = 2,	/* M, N, LDA, LDU; LINDXA[M], LINDXAU[M] */
+	CAPTURE_DLASWP06T = 3,	/* M, N, LDA, LDU; LINDXA[M] */
+	CAPTURE_DLASWP10N = 4,	/* M, N, LDA; IPIV[N] */
+	CAPTURE_DLATCPY   = 5,	/* M, N, LDA, LDB */
+	CAPTURE_DLACPY    = 6,	/* M, N, LDA, LDB, multithread */
+	CAPTURE_DTRSM2    = 7,	/* ORDER, SIDE, UPLO, TRANS, DIAG, M, N, LDA, LDB, gpu */
+	CAPTURE_PDMXSWP   = 8,	/* n0, nprow, mydist, ip2, hdim, cnt_, cnt0 (message sizes in doubles) */
+	CAPTURE_KERNEL_COUNT
+};
+
+/**
+ * Layout of the capture file: a capture_file_header followed by records. Each
+ * record is a capture_record_header followed by nargs ints of arguments, n1 ints
+ * of the first and n2 ints of the second index array.
+ */
+#define CAPTURE_FILE_MAGIC "HPLCAPT1"
+
+typedef struct capture_file_header
+{
+	char magic[8];
+	int32_t rank;
+	int32_t run;
+} capture_file_header_t;
+
+typedef struct capture_record_header
+{
+	int32_t kernel;
+	int32_t nargs;
+	int32_t n1;
+	int32_t n2;
+	uint64_t duration;	/* wall time of the call in ns */
+} capture_record_header_t;
+
+/**
+ * Nonzero while a capture file is open.
+ */
+extern volatile int util_capture_enabled;
+
+/**
+ * Monotonic timestamp in ns.
+ */
+uint64_t util_captureTimestamp( void );
+
+/**
+ * Opens a capture file whose name is derived from the arguments and enables
+ * capturing.
+ */
+void openCaptureFile( const char *basename, const int run, const int rank );
+
+/**
+ * Disables capturing and closes the capture file.
+ */
+void closeCaptureFile();
+
+/**
+ * Writes one record, start is the util_captureTimestamp() at the beginning of the call.
+ */
+void captureCall( const int kernel, const uint64_t start, const int nargs, const int *args,
+	const int n1, const int *idx1, const int n2, const int *idx2 );
+
+/**
+ * Utility macros, CAPTURE_START at the beginning of the function, CAPTURE_CALL
+ * at the end. Calls that return early are not captured.
+ */
+#define CAPTURE_START \
+const uint64_t capture_start = util_capture_enabled ? util_captureTimestamp() : 0;
+
+#define CAPTURE_CALL( KERNEL, N1, IDX1, N2, IDX2, ... ) \
+if( __builtin_expect( util_capture_enabled, 0 ) ) \
+{ \
+	const int capture_args[] = { __VA_ARGS__ }; \
+	captureCall( KERNEL, capture_start, sizeof( capture_args ) / sizeof( capture_args[0] ), capture_args, N1, IDX1, N2, IDX2 ); \
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,90 @@
+/**
+ * Memory policy layer for the matrix and panel allocations
+ *
+ * Copyright 2010:
+ *  - David Rohr (drohr@jwdt.org)
+ *  - Matthias Bach (bach@compeng.uni-frankfurt.de)
+ *  - Matthias Kretz (kretz@compeng.uni-frankfurt.de)
+ *
+ * This file is part of HPL-GPU.
+ *
+ * HPL-GPU is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * HPL-GPU is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with HPL-GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition to the rules layed out by the GNU General Public License
+ * the following exception is granted:
+ *
+ * Use with the Original BSD License.
+ *
+ * Notwithstanding any other provision of the GNU General Public License
+ * Version 3, you have permission to link or combine any covered work with
+ * a work licensed under the 4-clause BSD license into a single combined
+ * work, and to convey the resulting work.  The terms of this License will
+ * continue to apply to the part which is the covered work, but the special
+ * requirements of the 4-clause BSD license, clause 3, concerning the
+ * requirement of acknowledgement in advertising materials will apply to
+ * the combination as such.
+ */
+
+#ifndef UTIL_MEMPOLICY_H
+#define UTIL_MEMPOLICY_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Page sizes selectable with HPL_MEM_HUGEPAGES. Explicit hugetlbfs sizes fall
+ * back to the next smaller size, then to THP, then to normal pages.
+ */
+enum mem_hugepages
+{
+	MEM_HUGEPAGES_BACKEND = 0,	/* let CALDGEMM_alloc decide (HPL_HUGE_TABLES) */
+	MEM_HUGEPAGES_THP     = 1,	/* transparent huge pages via madvise */
+	MEM_HUGEPAGES_2M      = 2,	/* 2 MiB hugetlbfs pages */
+	MEM_HUGEPAGES_1G      = 3	/* 1 GiB hugetlbfs pages */
+};
+
+/**
+ * NUMA placement selectable per region with HPL_MEM_PLACEMENT_MATRIX and
+ * HPL_MEM_PLACEMENT_PANEL.
+ */
+enum mem_placement
+{
+	MEM_PLACEMENT_BACKEND     = 0,	/* default policy, or the backend interleave flag */
+	MEM_PLACEMENT_INTERLEAVE  = 1,	/* interleave pages over all nodes */
+	MEM_PLACEMENT_FIRST_TOUCH = 2,	/* first touch by the LASWP worker threads (panel: by the calling thread) */
+	MEM_PLACEMENT_BIND        = 3	/* bind block columns round robin to the nodes (panel: to the node of the calling thread) */
+};
+
+/**
+ * Allocate the matrix followed by the panel workspace. The matrix consists of
+ * block columns of col_block_bytes each. Without any policy set this is just
+ * CALDGEMM_alloc(matrix_bytes + panel_bytes, interleave).
+ */
+void* HPL_mem_alloc( size_t matrix_bytes, size_t panel_bytes, size_t col_block_bytes, int interleave );
+void HPL_mem_free( void* ptr );
+
+/**
+ * Print the page sizes and the NUMA node distribution actually obtained for
+ * [ptr, ptr + size).
+ */
+void HPL_mem_report( const char* name, const void* ptr, size_t size, int myrow, int mycol );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
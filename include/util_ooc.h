@@ -0,0 +1,78 @@
+/**
+ * Out-of-core storage of the local matrix in a memory-mapped file
+ *
+ * Copyright 2010:
+ *  - David Rohr (drohr@jwdt.org)
+ *  - Matthias Bach (bach@compeng.uni-frankfurt.de)
+ *  - Matthias Kretz (kretz@compeng.uni-frankfurt.de)
+ *
+ * This file is part of HPL-GPU.
+ *
+ * HPL-GPU is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * HPL-GPU is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with HPL-GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition to the rules layed out by the GNU General Public License
+ * the following exception is granted:
+ *
+ * Use with the Original BSD License.
+ *
+ * Notwithstanding any other provision of the GNU General Public License
+ * Version 3, you have permission to link or combine any covered work with
+ * a work licensed under the 4-clause BSD license into a single combined
+ * work, and to convey the resulting work.  The terms of this License will
+ * continue to apply to the part which is the covered work, but the special
+ * requirements of the 4-clause BSD license, clause 3, concerning the
+ * requirement of acknowledgement in advertising materials will apply to
+ * the combination as such.
+ */
+
+#ifndef UTIL_OOC_H
+#define UTIL_OOC_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Map a temporary file of size bytes in the directory HPL_OOC_PATH and start
+ * the I/O thread. The file is unlinked right away, so it disappears with the
+ * mapping.
+ */
+void* HPL_ooc_alloc( size_t size );
+void HPL_ooc_free( void* ptr );
+int HPL_ooc_active( void );
+
+/**
+ * Queue read-ahead of a range of the mapping, and write-back plus release of
+ * a range that is not needed anymore. Ranges outside the mapping are ignored.
+ * HPL_ooc_wait blocks until all queued read-ahead starting below end has
+ * completed, or all queued read-ahead if end is NULL.
+ */
+void HPL_ooc_prefetch( const void* ptr, size_t size );
+void HPL_ooc_evict( const void* ptr, size_t size );
+void HPL_ooc_wait( const void* end );
+
+/**
+ * Seconds the I/O thread was busy, seconds HPL_ooc_wait blocked, and bytes
+ * read and written back since the last reset.
+ */
+void HPL_ooc_reset_stats( void );
+void HPL_ooc_stats( double* busy, double* stall, double* read, double* written );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
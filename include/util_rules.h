@@ -0,0 +1,76 @@
+/**
+ * Per-iteration parameter rules read from HPL_RULE lines of HPL-GPU.conf
+ *
+ * Copyright 2010:
+ *  - David Rohr (drohr@jwdt.org)
+ *  - Matthias Bach (bach@compeng.uni-frankfurt.de)
+ *  - Matthias Kretz (kretz@compeng.uni-frankfurt.de)
+ *
+ * This file is part of HPL-GPU.
+ *
+ * HPL-GPU is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * HPL-GPU is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with HPL-GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition to the rules layed out by the GNU General Public License
+ * the following exception is granted:
+ *
+ * Use with the Original BSD License.
+ *
+ * Notwithstanding any other provision of the GNU General Public License
+ * Version 3, you have permission to link or combine any covered work with
+ * a work licensed under the 4-clause BSD license into a single combined
+ * work, and to convey the resulting work.  The terms of this License will
+ * continue to apply to the part which is the covered work, but the special
+ * requirements of the 4-clause BSD license, clause 3, concerning the
+ * requirement of acknowledgement in advertising materials will apply to
+ * the combination as such.
+ */
+
+#ifndef UTIL_RULES_H
+#define UTIL_RULES_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct HPL_S_palg;
+
+/**
+ * Parse the newline separated HPL_RULE lines of the runtime config. Each rule
+ * has the form "cond [&& cond ...] => action [, action ...]", conditions
+ * compare j, n, m_remain or iter with a constant. Returns nonzero and prints
+ * the offending rule on a syntax error.
+ */
+int HPL_rules_parse( const char* text );
+int HPL_rules_active( void );
+
+/**
+ * HPL_rules_begin saves the parameters rules may change, HPL_rules_end
+ * restores them. HPL_rules_apply evaluates all rules in order at the start
+ * of an iteration; values set by a matching rule persist until another rule
+ * changes them.
+ */
+void HPL_rules_begin( struct HPL_S_palg* ALGO );
+void HPL_rules_apply( struct HPL_S_palg* ALGO, int iter, int j, int n, int m_remain );
+void HPL_rules_end( struct HPL_S_palg* ALGO );
+
+/**
+ * Lookahead depth requested by the rules, -1 if no rule has set it.
+ */
+int HPL_rules_lookahead( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -47,10 +47,19 @@ extern "C"
 struct runtime_config_options
 {
     char* paramdefs;
+    char* rules;
     int mpi_affinity[HPL_MAX_RUNTIME_CONFIG_ARRAY];
     int mpi_affinity_count;
     int interleave_memory;
+    int mem_hugepages;
+    int mem_placement_matrix;
+    int mem_placement_panel;
+    int mem_report;
     int warmup;
+    int warmup_n;
+    int n_auto;
+    char* ooc_path;
+    int ooc_window;
     int fastrand;
     int disable_lookahead;
     int lookahead2_turnoff;
@@ -65,6 +74,41 @@ struct runtime_config_options
     int hpl_nb_multiplier_count;
     int hpl_nb_multiplier_threshold[HPL_MAX_RUNTIME_CONFIG_ARRAY];
     int hpl_nb_multiplier_factor[HPL_MAX_RUNTIME_CONFIG_ARRAY];
+    int kernel_capture;
+    int streaming_verify;
+    int lookahead_2b;
+    int lookahead_2b_fixed_stepsize;
+    int lookahead_2b_multiplier;
+    int locswp_depth;
+    int max_mpi_send_size;
+    int max_mpi_bcast_size;
+    int restrict_cpus;
+    int half_blocking;
+    int start_percentage;
+    int start_col;
+    int end_n;
+    int async_dlatcpy;
+    int copyl_during_fact;
+    double pause;
+    int autotune;
+    int autotune_window;
+    int autotune_segments;
+    int autotune_lookahead2_turnoff[HPL_MAX_RUNTIME_CONFIG_ARRAY];
+    int autotune_lookahead2_turnoff_count;
+    int autotune_lookahead3_turnoff[HPL_MAX_RUNTIME_CONFIG_ARRAY];
+    int autotune_lookahead3_turnoff_count;
+    int autotune_nb_multiplier_scale[HPL_MAX_RUNTIME_CONFIG_ARRAY];
+    int autotune_nb_multiplier_scale_count;
+    int adaptive_nb;
+    int adaptive_nb_interval;
+    int adaptive_nb_ratio;
+    int rebalance;
+    int rebalance_threshold;
+    int rebalance_reserve;
+    int calibrate;
+    int tail_gather;
+    int swap;
+    int swap_threshold;
 };
 
 extern struct runtime_config_options global_runtime_config;
@@ -62,6 +62,7 @@
 #define STD_OUT stdout
 #endif
 #include "util_trace.h"
+#include "util_capture.h"
 
 #include "../pauxil/helpers.h"
 #include <tbb/parallel_for.h>
@@ -151,6 +152,7 @@ class HPL_dlacpy_impl
 extern "C" void HPL_dlacpy(const int _M, const int _N, const double *A, const int _LDA, double *B, const int _LDB, int multithread)
 {
    START_TRACE( DLACPY )
+   CAPTURE_START
 
    if ( _M <= 0 || _N <= 0 ) {
 	  return;
@@ -198,6 +200,7 @@ Unaligned:
    }
 
    END_TRACE
+   CAPTURE_CALL( CAPTURE_DLACPY, 0, NULL, 0, NULL, _M, _N, _LDA, _LDB, multithread )
 #ifdef TRACE_LASWP
    char filename[256];
    snprintf(filename, 256, "dlacpy.%04d.%05d.%05d.%05d.%7.4fs.dat", M, N, LDA, LDB, laswp_time);
@@ -62,223 +62,199 @@
 #define STD_OUT stdout
 #endif
 #include "util_trace.h"
+#include "util_capture.h"
 
 #include "../pauxil/helpers.h"
 #include <tbb/parallel_for.h>
+#include <tbb/blocked_range2d.h>
 
-typedef MyRange<8, 16> Range;
+/*
+ * The transpose is done cache-obliviously: a tile is halved along its larger
+ * dimension until it is at most HPL_DLATCPY_LEAF x HPL_DLATCPY_LEAF, the leaf
+ * tiles are transposed in 8x8 blocks. Split points are multiples of 8, so
+ * only the last tiles in either dimension have a scalar remainder. With
+ * non-temporal stores nothing of B is reused, the leaves are then made
+ * streamLeafAspect times longer along the columns of A, which gives the
+ * hardware prefetcher longer read streams.
+ *
+ * Transposes of up to HPL_DLATCPY_INCACHE_SIZE bytes (the panel copies in
+ * the recursive factorizations) are written with regular stores, the result
+ * is read again right away. Larger ones (the U writeback) use non-temporal
+ * stores. Transposes of less than HPL_DLATCPY_SERIAL_SIZE bytes are done by
+ * the calling thread.
+ */
+#ifndef HPL_DLATCPY_LEAF
+#define HPL_DLATCPY_LEAF 32
+#endif
+#ifndef HPL_DLATCPY_INCACHE_SIZE
+#define HPL_DLATCPY_INCACHE_SIZE (8 * 1024 * 1024)
+#endif
+#ifndef HPL_DLATCPY_SERIAL_SIZE
+#define HPL_DLATCPY_SERIAL_SIZE (128 * 1024)
+#endif
 
-class HPL_dlatcpy_impl
+namespace
 {
-    private:
-        const size_t N;
-        const size_t LDA;
-        const size_t LDB;
-        const double *__restrict__ const A;
-        double *__restrict__ const B;
+    const size_t leafSize = HPL_DLATCPY_LEAF < 8 ? 8 : (HPL_DLATCPY_LEAF & ~7);
+    const size_t taskSize = 256;    // edge of the tiles handed to TBB, in elements
+    const size_t streamLeafAspect = 8;
 
-    public:
-        HPL_dlatcpy_impl(size_t _N, const double *_A, size_t _LDA,
-                double *_B, size_t _LDB)
-            : N(_N), LDA(_LDA), LDB(_LDB),
-            A(_A), B(_B)
+    template <bool STREAM> struct dlatcpy_store
+    {
+        static inline void store( double *dst, const __m128d v )
         {
+            if ( STREAM ) _mm_stream_pd( dst, v ); else _mm_store_pd( dst, v );
         }
-
-        void operator()(const Range &range) const
+#ifdef HPL_LASWP_AVX
+        static inline void store( double *dst, const __m256d v )
         {
-            const size_t end = range.begin() + range.N();
-            for ( size_t i = range.begin(); i < end; i += 8 )
-            {
-                double *__restrict__ B_ij = &B[ i ];
-                const double *__restrict__ A_ji = &A[ i * LDA ];
-                size_t j = 0;
-                for ( ; j < (N & ~7); j += 8 )
-                {
-                    _mm_prefetch( &A_ji[ 8 + 0 * LDA ], _MM_HINT_NTA );
-                    _mm_prefetch( &A_ji[ 8 + 1 * LDA ], _MM_HINT_NTA );
-#ifdef HPL_HAVE_PREFETCHW
-#define prefetchw(addr) _m_prefetchw(addr)
-#else
-#define prefetchw(addr) _mm_prefetch(addr, _MM_HINT_NTA )
+            if ( STREAM ) _mm256_stream_pd( dst, v ); else _mm256_store_pd( dst, v );
+        }
 #endif
-                    prefetchw( &B_ij[ 8 + 0 * LDB ] );
-                    prefetchw( &B_ij[ 8 + 1 * LDB ] );
-                    prefetchw( &B_ij[ 8 + 2 * LDB ] );
-                    prefetchw( &B_ij[ 8 + 3 * LDB ] );
-                    prefetchw( &B_ij[ 8 + 4 * LDB ] );
-                    prefetchw( &B_ij[ 8 + 5 * LDB ] );
-                    prefetchw( &B_ij[ 8 + 6 * LDB ] );
-                    prefetchw( &B_ij[ 8 + 7 * LDB ] );
-#undef prefetchw
+        static inline void copy( double *dst, const double *src )
+        {
+            if ( STREAM ) streamingCopy( dst, src ); else *dst = *src;
+        }
+    };
 
-                    _mm_prefetch( &A_ji[ 8 + 2 * LDA ], _MM_HINT_T1 );
-                    _mm_prefetch( &A_ji[ 8 + 3 * LDA ], _MM_HINT_T1 );
-                    _mm_prefetch( &A_ji[ 8 + 4 * LDA ], _MM_HINT_T1 );
-                    _mm_prefetch( &A_ji[ 8 + 5 * LDA ], _MM_HINT_T1 );
-                    _mm_prefetch( &A_ji[ 8 + 6 * LDA ], _MM_HINT_T1 );
-                    _mm_prefetch( &A_ji[ 8 + 7 * LDA ], _MM_HINT_T1 );
+    // B[i..i+7, j..j+7] = A[j..j+7, i..i+7]^T
+    template <bool STREAM>
+    static inline void dlatcpy_block8( const double *__restrict__ A_ji, const size_t LDA,
+            double *__restrict__ B_ij, const size_t LDB, const bool avx )
+    {
+        typedef dlatcpy_store<STREAM> S;
 #ifdef HPL_LASWP_AVX
-                        for ( size_t i2 = 0; i2 < 8; i2 += 4 )
-                        {
-                            const __m256d tmp0 = _mm256_load_pd( &A_ji[ i2 * LDA + 0 * LDA] );
-                            const __m256d tmp1 = _mm256_load_pd( &A_ji[ i2 * LDA + 1 * LDA ] );
-                            const __m256d tmp2 = _mm256_load_pd( &A_ji[ i2 * LDA + 2 * LDA ] );
-                            const __m256d tmp3 = _mm256_load_pd( &A_ji[ i2 * LDA + 3 * LDA ] );
-                            const __m256d tmp0a = _mm256_load_pd( &A_ji[ i2 * LDA + 0 * LDA + 4 ] );
-                            const __m256d tmp1a = _mm256_load_pd( &A_ji[ i2 * LDA + 1 * LDA + 4 ] );
-                            const __m256d tmp2a = _mm256_load_pd( &A_ji[ i2 * LDA + 2 * LDA + 4 ] );
-                            const __m256d tmp3a = _mm256_load_pd( &A_ji[ i2 * LDA + 3 * LDA + 4 ] );
-                            _mm_prefetch( &A_ji[ (i2 + 4) * LDA ], _MM_HINT_T0 );
-                            _mm_prefetch( &A_ji[ (i2 + 5) * LDA ], _MM_HINT_T0 );
-                            _mm_prefetch( &A_ji[ (i2 + 6) * LDA ], _MM_HINT_T0 );
-                            _mm_prefetch( &A_ji[ (i2 + 7) * LDA ], _MM_HINT_T0 );
-                            const __m256d __t0 = _mm256_unpacklo_pd(tmp0, tmp1);
-                            const __m256d __t1 = _mm256_unpackhi_pd(tmp0, tmp1);
-                            const __m256d __t2 = _mm256_unpacklo_pd(tmp2, tmp3);
-                            const __m256d __t3 = _mm256_unpackhi_pd(tmp2, tmp3);
-                            const __m256d __t0a = _mm256_unpacklo_pd(tmp0a, tmp1a);
-                            const __m256d __t1a = _mm256_unpackhi_pd(tmp0a, tmp1a);
-                            const __m256d __t2a = _mm256_unpacklo_pd(tmp2a, tmp3a);
-                            const __m256d __t3a = _mm256_unpackhi_pd(tmp2a, tmp3a);
-                            _mm256_store_pd( &B_ij[ i2 + 0 * LDB ], _mm256_permute2f128_pd(__t0, __t2, _MM_SHUFFLE(0, 2, 0, 0)));
-                            _mm256_store_pd( &B_ij[ i2 + 1 * LDB ], _mm256_permute2f128_pd(__t1, __t3, _MM_SHUFFLE(0, 2, 0, 0)));
-                            _mm256_store_pd( &B_ij[ i2 + 2 * LDB ], _mm256_permute2f128_pd(__t0, __t2, _MM_SHUFFLE(0, 3, 0, 1)));
-                            _mm256_store_pd( &B_ij[ i2 + 3 * LDB ], _mm256_permute2f128_pd(__t1, __t3, _MM_SHUFFLE(0, 3, 0, 1)));
-                            _mm256_store_pd( &B_ij[ i2 + 4 * LDB ], _mm256_permute2f128_pd(__t0a, __t2a, _MM_SHUFFLE(0, 2, 0, 0)));
-                            _mm256_store_pd( &B_ij[ i2 + 5 * LDB ], _mm256_permute2f128_pd(__t1a, __t3a, _MM_SHUFFLE(0, 2, 0, 0)));
-                            _mm256_store_pd( &B_ij[ i2 + 6 * LDB ], _mm256_permute2f128_pd(__t0a, __t2a, _MM_SHUFFLE(0, 3, 0, 1)));
-                            _mm256_store_pd( &B_ij[ i2 + 7 * LDB ], _mm256_permute2f128_pd(__t1a, __t3a, _MM_SHUFFLE(0, 3, 0, 1)));
-                        }
-#else
-                    for ( size_t i2 = 0; i2 < 8; i2 += 2 )
-                    {
-                       const __m128d tmp0 = _mm_load_pd( &A_ji[ (i2 + 0) * LDA     ] );
-                       const __m128d tmp1 = _mm_load_pd( &A_ji[ (i2 + 1) * LDA     ] );
-                       const __m128d tmp2 = _mm_load_pd( &A_ji[ (i2 + 0) * LDA + 2 ] );
-                       const __m128d tmp3 = _mm_load_pd( &A_ji[ (i2 + 1) * LDA + 2 ] );
-                       const __m128d tmp4 = _mm_load_pd( &A_ji[ (i2 + 0) * LDA + 4 ] );
-                       const __m128d tmp5 = _mm_load_pd( &A_ji[ (i2 + 1) * LDA + 4 ] );
-                       const __m128d tmp6 = _mm_load_pd( &A_ji[ (i2 + 0) * LDA + 6 ] );
-                       const __m128d tmp7 = _mm_load_pd( &A_ji[ (i2 + 1) * LDA + 6 ] );
-                       _mm_prefetch( &A_ji[ (i2 + 2) * LDA ], _MM_HINT_T0 );
-                       _mm_prefetch( &A_ji[ (i2 + 3) * LDA ], _MM_HINT_T0 );
-                       _mm_store_pd( &B_ij[ i2           ], _mm_unpacklo_pd( tmp0, tmp1 ) );
-                       _mm_store_pd( &B_ij[ i2 + 1 * LDB ], _mm_unpackhi_pd( tmp0, tmp1 ) );
-                       _mm_store_pd( &B_ij[ i2 + 2 * LDB ], _mm_unpacklo_pd( tmp2, tmp3 ) );
-                       _mm_store_pd( &B_ij[ i2 + 3 * LDB ], _mm_unpackhi_pd( tmp2, tmp3 ) );
-                       _mm_store_pd( &B_ij[ i2 + 4 * LDB ], _mm_unpacklo_pd( tmp4, tmp5 ) );
-                       _mm_store_pd( &B_ij[ i2 + 5 * LDB ], _mm_unpackhi_pd( tmp4, tmp5 ) );
-                       _mm_store_pd( &B_ij[ i2 + 6 * LDB ], _mm_unpacklo_pd( tmp6, tmp7 ) );
-                       _mm_store_pd( &B_ij[ i2 + 7 * LDB ], _mm_unpackhi_pd( tmp6, tmp7 ) );
-                    }
-#endif
-                    B_ij += 8 * LDB;
-                    A_ji += 8;
-                }
-                for ( ; j < N; ++j )
+        if ( avx )
+        {
+            for ( size_t j2 = 0; j2 < 8; j2 += 4 )
+            {
+                for ( size_t i2 = 0; i2 < 8; i2 += 4 )
                 {
-                   streamingCopy( &B_ij[ 0 ], &A_ji[ 0 * LDA ] );
-                   streamingCopy( &B_ij[ 1 ], &A_ji[ 1 * LDA ] );
-                   streamingCopy( &B_ij[ 2 ], &A_ji[ 2 * LDA ] );
-                   streamingCopy( &B_ij[ 3 ], &A_ji[ 3 * LDA ] );
-                   streamingCopy( &B_ij[ 4 ], &A_ji[ 4 * LDA ] );
-                   streamingCopy( &B_ij[ 5 ], &A_ji[ 5 * LDA ] );
-                   streamingCopy( &B_ij[ 6 ], &A_ji[ 6 * LDA ] );
-                   streamingCopy( &B_ij[ 7 ], &A_ji[ 7 * LDA ] );
-
-                   B_ij += LDB;
-                   ++A_ji;
+                    const __m256d tmp0 = _mm256_loadu_pd( &A_ji[ j2 + (i2 + 0) * LDA ] );   //a0, b0, c0, d0
+                    const __m256d tmp1 = _mm256_loadu_pd( &A_ji[ j2 + (i2 + 1) * LDA ] );   //a1, b1, c1, d1
+                    const __m256d tmp2 = _mm256_loadu_pd( &A_ji[ j2 + (i2 + 2) * LDA ] );   //a2, b2, c2, d2
+                    const __m256d tmp3 = _mm256_loadu_pd( &A_ji[ j2 + (i2 + 3) * LDA ] );   //a3, b3, c3, d3
+                    const __m256d __t0 = _mm256_unpacklo_pd( tmp0, tmp1 );                  //a0, a1, c0, c1
+                    const __m256d __t1 = _mm256_unpackhi_pd( tmp0, tmp1 );                  //b0, b1, d0, d1
+                    const __m256d __t2 = _mm256_unpacklo_pd( tmp2, tmp3 );                  //a2, a3, c2, c3
+                    const __m256d __t3 = _mm256_unpackhi_pd( tmp2, tmp3 );                  //b2, b3, d2, d3
+                    S::store( &B_ij[ i2 + (j2 + 0) * LDB ], _mm256_permute2f128_pd( __t0, __t2, _MM_SHUFFLE( 0, 2, 0, 0 ) ) );
+                    S::store( &B_ij[ i2 + (j2 + 1) * LDB ], _mm256_permute2f128_pd( __t1, __t3, _MM_SHUFFLE( 0, 2, 0, 0 ) ) );
+                    S::store( &B_ij[ i2 + (j2 + 2) * LDB ], _mm256_permute2f128_pd( __t0, __t2, _MM_SHUFFLE( 0, 3, 0, 1 ) ) );
+                    S::store( &B_ij[ i2 + (j2 + 3) * LDB ], _mm256_permute2f128_pd( __t1, __t3, _MM_SHUFFLE( 0, 3, 0, 1 ) ) );
                 }
             }
-            _mm_sfence();
+            return;
         }
-};
-
-class HPL_dlatcpy_impl2
-{
-    private:
-        const size_t N;
-        const size_t LDA;
-        const size_t LDB;
-        const double *__restrict__ const A;
-        double *__restrict__ const B;
+#endif
+        // Unaligned loads: the fused copy in HPL_pdgesv_swap starts at arbitrary row offsets of U
+        for ( size_t j2 = 0; j2 < 8; j2 += 2 )
+        {
+            for ( size_t i2 = 0; i2 < 8; i2 += 2 )
+            {
+                const __m128d tmp0 = _mm_loadu_pd( &A_ji[ j2 + (i2 + 0) * LDA ] );
+                const __m128d tmp1 = _mm_loadu_pd( &A_ji[ j2 + (i2 + 1) * LDA ] );
+                S::store( &B_ij[ i2 + (j2 + 0) * LDB ], _mm_unpacklo_pd( tmp0, tmp1 ) );
+                S::store( &B_ij[ i2 + (j2 + 1) * LDB ], _mm_unpackhi_pd( tmp0, tmp1 ) );
+            }
+        }
+    }
 
-    public:
-        HPL_dlatcpy_impl2(size_t _N, const double *_A, size_t _LDA,
-                double *_B, size_t _LDB)
-            : N(_N), LDA(_LDA), LDB(_LDB),
-            A(_A), B(_B)
+    // B[i0..i1-1, j0..j1-1] = A[j0..j1-1, i0..i1-1]^T, i0 and j0 are multiples of 8
+    template <bool STREAM>
+    static void dlatcpy_leaf( const double *A, const size_t LDA, double *B, const size_t LDB,
+            const size_t i0, const size_t i1, const size_t j0, const size_t j1, const bool avx )
+    {
+        const size_t i8 = i0 + ( (i1 - i0) & ~7 );
+        const size_t j8 = j0 + ( (j1 - j0) & ~7 );
+        for ( size_t i = i0; i < i8; i += 8 )
+        {
+            for ( size_t j = j0; j < j8; j += 8 )
+            {
+                dlatcpy_block8<STREAM>( &A[ j + i * LDA ], LDA, &B[ i + j * LDB ], LDB, avx );
+            }
+        }
+        for ( size_t j = j8; j < j1; ++j )
+        {
+            for ( size_t i = i0; i < i8; ++i )
+            {
+                dlatcpy_store<STREAM>::copy( &B[ i + j * LDB ], &A[ j + i * LDA ] );
+            }
+        }
+        for ( size_t j = j0; j < j1; ++j )
         {
+            for ( size_t i = i8; i < i1; ++i )
+            {
+                dlatcpy_store<STREAM>::copy( &B[ i + j * LDB ], &A[ j + i * LDA ] );
+            }
         }
+    }
 
-        void operator()(const Range &range) const
+    template <bool STREAM>
+    static void dlatcpy_recursive( const double *A, const size_t LDA, double *B, const size_t LDB,
+            const size_t i0, const size_t i1, const size_t j0, const size_t j1, const bool avx )
+    {
+        const size_t aspect = STREAM ? streamLeafAspect : 1;
+        const size_t m = i1 - i0;
+        const size_t n = j1 - j0;
+        if ( m <= leafSize && n <= leafSize * aspect )
         {
-            const size_t end = range.begin() + range.N();
-            for (size_t i = range.begin(); i < end; i += 8) {
-                double *__restrict__ B_ij = &B[ i ];
-                const double *__restrict__ A_ji = &A[ i * LDA ];
-                size_t j = 0;
-                for ( ; j < (N & ~7); j += 8 )
-                {
-                    _mm_prefetch( &A_ji[ 8 + 0 * LDA ], _MM_HINT_NTA );
-                    _mm_prefetch( &A_ji[ 8 + 1 * LDA ], _MM_HINT_NTA );
-                    _mm_prefetch( &A_ji[ 8 + 2 * LDA ], _MM_HINT_T1 );
-                    _mm_prefetch( &A_ji[ 8 + 3 * LDA ], _MM_HINT_T1 );
-                    _mm_prefetch( &A_ji[ 8 + 4 * LDA ], _MM_HINT_T1 );
-                    _mm_prefetch( &A_ji[ 8 + 5 * LDA ], _MM_HINT_T1 );
-                    _mm_prefetch( &A_ji[ 8 + 6 * LDA ], _MM_HINT_T1 );
-                    _mm_prefetch( &A_ji[ 8 + 7 * LDA ], _MM_HINT_T1 );
-#ifdef HPL_LASWP_AVX
-                    for ( size_t j2 = 0; j2 < 8; j2 += 4 )
-                    {
-                        for ( size_t i2 = 0; i2 < 8; i2 += 4 )
-                        {
-                            const __m256d tmp0 = _mm256_load_pd( &A_ji[ i2 * LDA ] );              //a0, b0, c0, d0
-                            const __m256d tmp1 = _mm256_load_pd( &A_ji[ i2 * LDA + 1 * LDA ] );    //a1, b1, c1, d1
-                            const __m256d tmp2 = _mm256_load_pd( &A_ji[ i2 * LDA + 2 * LDA ] );    //a2, b2, c2, d2
-                            const __m256d tmp3 = _mm256_load_pd( &A_ji[ i2 * LDA + 3 * LDA ] );    //a3, b3, c3, d3
-                            const __m256d __t0 = _mm256_unpacklo_pd(tmp0, tmp1);                   //a0, a1, c0, c1
-                            const __m256d __t1 = _mm256_unpackhi_pd(tmp0, tmp1);                   //b0, b1, d0, d1
-                            const __m256d __t2 = _mm256_unpacklo_pd(tmp2, tmp3);                   //a2, a3, c2, c3
-                            const __m256d __t3 = _mm256_unpackhi_pd(tmp2, tmp3);                   //b2, b3, d2, d3
-                            _mm256_stream_pd( &B_ij[ i2           ], _mm256_permute2f128_pd(__t0, __t2, _MM_SHUFFLE(0, 2, 0, 0)));
-                            _mm256_stream_pd( &B_ij[ i2 + 1 * LDB ], _mm256_permute2f128_pd(__t1, __t3, _MM_SHUFFLE(0, 2, 0, 0)));
-                            _mm256_stream_pd( &B_ij[ i2 + 2 * LDB ], _mm256_permute2f128_pd(__t0, __t2, _MM_SHUFFLE(0, 3, 0, 1)));
-                            _mm256_stream_pd( &B_ij[ i2 + 3 * LDB ], _mm256_permute2f128_pd(__t1, __t3, _MM_SHUFFLE(0, 3, 0, 1)));
-                        }
-                        B_ij += 4 * LDB;
-                        A_ji += 4;
-                    }
-#else
-                    for ( size_t j2 = 0; j2 < 8; j2 += 2 )
-                    {
-                        for ( size_t i2 = 0; i2 < 8; i2 += 2 )
-                        {
-                            const __m128d tmp0 = _mm_load_pd( &A_ji[ i2 * LDA ] );
-                            const __m128d tmp1 = _mm_load_pd( &A_ji[ i2 * LDA + LDA ] );
-                            _mm_stream_pd( &B_ij[ i2       ], _mm_unpacklo_pd( tmp0, tmp1 ) );
-                            _mm_stream_pd( &B_ij[ i2 + LDB ], _mm_unpackhi_pd( tmp0, tmp1 ) );
-                        }
-                        B_ij += 2 * LDB;
-                        A_ji += 2;
-                    }
-#endif
-                }
-                for ( ; j < N; ++j )
-                {
-                    for ( size_t i2 = 0; i2 < 8; ++i2 )
-                    {
-                        streamingCopy( &B_ij[ i2 ], &A_ji[ i2 * LDA ] );
-                    }
+            dlatcpy_leaf<STREAM>( A, LDA, B, LDB, i0, i1, j0, j1, avx );
+        }
+        else if ( m > leafSize && m * aspect >= n )
+        {
+            const size_t half = ( m / 2 + 7 ) & ~7;
+            dlatcpy_recursive<STREAM>( A, LDA, B, LDB, i0, i0 + half, j0, j1, avx );
+            dlatcpy_recursive<STREAM>( A, LDA, B, LDB, i0 + half, i1, j0, j1, avx );
+        }
+        else
+        {
+            const size_t half = ( n / 2 + 7 ) & ~7;
+            dlatcpy_recursive<STREAM>( A, LDA, B, LDB, i0, i1, j0, j0 + half, avx );
+            dlatcpy_recursive<STREAM>( A, LDA, B, LDB, i0, i1, j0 + half, j1, avx );
+        }
+    }
 
-                    B_ij += LDB;
-                    ++A_ji;
-                }
+    // The range counts blocks of 8 rows / columns of B
+    template <bool STREAM>
+    class HPL_dlatcpy_impl
+    {
+        private:
+            const size_t M;
+            const size_t N;
+            const size_t LDA;
+            const size_t LDB;
+            const double *__restrict__ const A;
+            double *__restrict__ const B;
+            const bool avx;
+
+        public:
+            HPL_dlatcpy_impl(size_t _M, size_t _N, const double *_A, size_t _LDA,
+                    double *_B, size_t _LDB, bool _avx)
+                : M(_M), N(_N), LDA(_LDA), LDB(_LDB),
+                A(_A), B(_B), avx(_avx)
+            {
             }
-            _mm_sfence();
-        }
-};
+
+            void operator()(const tbb::blocked_range2d<size_t> &range) const
+            {
+                const size_t i1 = range.rows().end() * 8;
+                const size_t j1 = range.cols().end() * 8;
+                dlatcpy_recursive<STREAM>( A, LDA, B, LDB, range.rows().begin() * 8, i1 < M ? i1 : M,
+                        range.cols().begin() * 8, j1 < N ? j1 : N, avx );
+                if ( STREAM ) _mm_sfence();
+            }
+    };
+}
+
+/*
+ * HPL_dlatcpy_streaming returns whether HPL_dlatcpy writes an M x N result
+ * with non-temporal stores.
+ */
+extern "C" int HPL_dlatcpy_streaming(const int M, const int N)
+{
+   return( (size_t) M * (size_t) N * sizeof(double) > (size_t) HPL_DLATCPY_INCACHE_SIZE );
+}
 
 /**
  * Purpose
@@ -318,6 +294,7 @@ class HPL_dlatcpy_impl2
 extern "C" void HPL_dlatcpy(const int _M, const int _N, const double *A, const int _LDA, double *B, const int _LDB)
 {
    START_TRACE( DLATCPY )
+   CAPTURE_START
 
    if ( _M <= 0 || _N <= 0 ) {
       return;
@@ -329,38 +306,35 @@ extern "C" void HPL_dlatcpy(const int _M, const int _N, const double *A, const i
    }
 
    const size_t M = _M;
-   const size_t MM = M & ~7;
    const size_t N = _N;
    const size_t LDA = _LDA;
    const size_t LDB = _LDB;
 
    // B_ij = A_ji
+   // 32 byte stores into B need an aligned B and a multiple of 4 as LDB, the loads are unaligned
+   const bool avx = ( ( (size_t) B & 31 ) == 0 ) && ( ( LDB & 3 ) == 0 );
+   const size_t bytes = M * N * sizeof(double);
 
-   size_t BS = 16;
-   if (N < 1024) {
-      // BS * N ~ 512kB ~ 60k doubles => BS ~ 60000 / N
-      BS = 60000 / N;
-      BS = BS > MM ? BS / 2 : BS;
-      tbb::parallel_for( Range(0, MM, BS), HPL_dlatcpy_impl( N, A, LDA, B, LDB ),
-            tbb::simple_partitioner() );
-   } else {
-      tbb::parallel_for( Range(0, MM), HPL_dlatcpy_impl2( N, A, LDA, B, LDB ),
-            tbb::simple_partitioner() );
+   if ( bytes <= (size_t) HPL_DLATCPY_SERIAL_SIZE )
+   {
+      dlatcpy_recursive<false>( A, LDA, B, LDB, 0, M, 0, N, avx );
    }
-
-   if ( M & 7 )
+   else
    {
-      for ( size_t j = 0; j < N; ++j )
+      const size_t grain = taskSize / 8;
+      const tbb::blocked_range2d<size_t> range( 0, ( M + 7 ) / 8, grain, 0, ( N + 7 ) / 8, grain );
+      if ( HPL_dlatcpy_streaming( _M, _N ) )
+      {
+         tbb::parallel_for( range, HPL_dlatcpy_impl<true>( M, N, A, LDA, B, LDB, avx ), tbb::simple_partitioner() );
+      }
+      else
       {
-         for ( size_t i = MM; i < M; ++i )
-         {
-            streamingCopy( &B[ i + j * LDB ], &A[ j + i * LDA ] );
-         }
+         tbb::parallel_for( range, HPL_dlatcpy_impl<false>( M, N, A, LDA, B, LDB, avx ), tbb::simple_partitioner() );
       }
-      _mm_sfence();
    }
 
    END_TRACE
+   CAPTURE_CALL( CAPTURE_DLATCPY, 0, NULL, 0, NULL, _M, _N, _LDA, _LDB )
 #ifdef TRACE_LASWP
    char filename[256];
    snprintf(filename, 256, "dlatcpy.%04d.%05d.%05d.%05d.%7.4fs.dat", M, N, LDA, LDB, laswp_time);
@@ -92,11 +92,7 @@ void HPL_copyL
 /* ..
  * .. Executable Statements ..
  */
-#ifdef HPL_COPYL_DURING_FACT
-   const int multithread = 1;
-#else
-   const int multithread = PANEL->algo->depth == 0;
-#endif
+   const int multithread = global_runtime_config.copyl_during_fact || PANEL->algo->depth == 0;
    if( PANEL->grid->mycol == PANEL->pcol )
    {
       jb = PANEL->jb; lda = PANEL->lda;
@@ -89,6 +89,7 @@ START_TRACE( PDPANEL_FREE )
  * .. Executable Statements ..
  */
    if( PANEL->pmat->info == 0 ) PANEL->pmat->info = *(PANEL->DINFO);
+   panel_arena_release( PANEL );
 
    //if( PANEL->WORK  ) free( PANEL->WORK  );
    //if( PANEL->IWORK ) free( PANEL->IWORK );
@@ -72,79 +72,187 @@
 #endif
 #endif
 
-size_t panel_max_lwork;
-size_t panel_max_ilwork;
+/*
+ * Panel workspace arena. WORK and IWORK of a panel are carved from the
+ * arena as one block of the size the panel actually needs and given back
+ * by HPL_pdpanel_free. At most two panels (the current one and the look-
+ * ahead panel) are alive at a time. The first block is placed at the
+ * start of the arena and every further block at the end opposite to the
+ * other live block, so the arena never fragments. Its size is the peak
+ * of the two live panels over the whole factorization.
+ */
+#define PANEL_ARENA_BLOCKS 2
+static char* panel_arena = NULL;
+static size_t panel_arena_size = 0, panel_arena_used = 0, panel_arena_max_used = 0;
+static HPL_T_panel* panel_arena_owner[PANEL_ARENA_BLOCKS];
+static size_t panel_arena_offset[PANEL_ARENA_BLOCKS], panel_arena_len[PANEL_ARENA_BLOCKS];
 
-#define PANEL_PREALLOC_COUNT 2
-double *p_lwork[PANEL_PREALLOC_COUNT], *p_ilwork[PANEL_PREALLOC_COUNT];
 void panel_preset_pointers(double* base_ptr)
 {
 	int i;
-	for (i = 0;i < PANEL_PREALLOC_COUNT;i++)
+	panel_arena = (char*) base_ptr;
+	for (i = 0;i < PANEL_ARENA_BLOCKS;i++) panel_arena_owner[i] = NULL;
+	panel_arena_used = panel_arena_max_used = 0;
+}
+
+size_t panel_arena_reserved()
+{
+	return(panel_arena_size);
+}
+
+size_t panel_arena_peak()
+{
+	return(panel_arena_max_used);
+}
+
+static size_t panel_round(size_t n)
+{
+	if (n % 1024) n += 1024 - n % 1024;
+	return(n);
+}
+
+static size_t panel_iwork_size(int JB, int nprow)
+{
+	/* See the description of IWORK in HPL_pdpanel_init */
+	int itmp1, lwork;
+	if( nprow == 1 ) { lwork = JB; }
+	else
 	{
-		p_lwork[i] = base_ptr;
-		base_ptr += panel_max_lwork;
-		p_ilwork[i] = base_ptr;
-		base_ptr += panel_max_ilwork * sizeof(int) / sizeof(double);
+		itmp1 = (JB << 1); lwork = nprow + 1; itmp1 = Mmax( itmp1, lwork );
+		lwork = 4 + (9 * JB) + (3 * nprow) + itmp1;
 	}
+	return(lwork);
 }
 
-size_t panel_estimate_max_size(HPL_T_grid* GRID, HPL_T_palg* ALGO, int N, int M, int JB)
+static size_t panel_block_size(size_t lwork, size_t ilwork)
 {
-	size_t len;
-	int npcol = GRID->npcol;
-	int nprow = GRID->nprow;
-	int myrow = GRID->myrow;
-	int mycol = GRID->mycol;
-	int nq = HPL_numcolI(N, 0, JB, mycol, GRID);
-	int mp = HPL_numrowI(M, 0, JB, myrow, nprow );
+	return(panel_round(lwork) * sizeof(double) + panel_round(ilwork) * sizeof(int));
+}
+
+static void panel_arena_acquire(HPL_T_panel* PANEL, size_t lwork, size_t ilwork)
+{
+	const size_t size = panel_block_size(lwork, ilwork);
+	size_t offset = 0;
+	int i, other = -1, slot = -1;
+	for (i = 0;i < PANEL_ARENA_BLOCKS;i++)
+	{
+		if (panel_arena_owner[i] == NULL) slot = i;
+		else other = i;
+	}
+	if (slot == -1) HPL_pabort( __LINE__, "HPL_pdpanel_init", "Too many panels in preallocated panel memory");
+	if (other != -1 && panel_arena_offset[other] == 0)
+	{
+		if (size > panel_arena_size) HPL_pabort( __LINE__, "HPL_pdpanel_init", "Problem with preallocated panel memory");
+		offset = panel_arena_size - size;
+	}
+	if (offset + size > panel_arena_size || (other != -1 && offset < panel_arena_offset[other] + panel_arena_len[other] && panel_arena_offset[other] < offset + size))
+	{
+		HPL_pabort( __LINE__, "HPL_pdpanel_init", "Problem with preallocated panel memory");
+	}
+	panel_arena_owner[slot] = PANEL;
+	panel_arena_offset[slot] = offset;
+	panel_arena_len[slot] = size;
+	panel_arena_used += size;
+	if (panel_arena_used > panel_arena_max_used) panel_arena_max_used = panel_arena_used;
+
+	PANEL->WORK = (double*) (panel_arena + offset);
+	PANEL->memalloc = panel_round(lwork);
+	PANEL->IWORK = (int*) (panel_arena + offset + PANEL->memalloc * sizeof(double));
+	PANEL->memallocI = panel_round(ilwork);
+}
+
+void panel_arena_release(HPL_T_panel* PANEL)
+{
+	int i;
+	for (i = 0;i < PANEL_ARENA_BLOCKS;i++)
+	{
+		if (panel_arena_owner[i] == PANEL)
+		{
+			panel_arena_owner[i] = NULL;
+			panel_arena_used -= panel_arena_len[i];
+		}
+	}
+}
+
+static size_t panel_work_size(HPL_T_grid* GRID, HPL_T_palg* ALGO, int M, int N, int JB, int NB, int IA, int JA)
+{
+	/* Same computation of lwork as in HPL_pdpanel_init */
+	int ii, jj, icurrow, icurcol, mp, nq, nu, ml2, itmp1;
+	const int myrow = GRID->myrow, mycol = GRID->mycol;
+	const int nprow = GRID->nprow, npcol = GRID->npcol;
+	size_t lwork;
+
+	HPL_infog2l( IA, JA, NB, NB, 0, 0, myrow, mycol, nprow, npcol, &ii, &jj, &icurrow, &icurcol, GRID );
+	mp = HPL_numrowI( M, IA, NB, myrow, nprow, GRID );
+	nq = HPL_numcolI( N, JA, NB, mycol, GRID );
+	/* With HPL_REBALANCE a process column can take over columns up to the reserve of its local matrix */
+	if (global_runtime_config.rebalance) nq += nq * global_runtime_config.rebalance_reserve / 100 + 1;
 	if (npcol == 1)
 	{
-		panel_max_lwork = ALGO->align + (len = JB * JB + JB + 1);
-		if (nprow > 1)                                 /* space for U */
+		lwork = ALGO->align + JB * JB + JB + 1;
+		if (nprow > 1)
 		{
-			int nu = nq - JB;
+			nu = nq - JB;
 			if (nu % 8) nu += 8 - nu % 8;
 			if (nu % 16 == 0) nu += 8;
-			panel_max_lwork += JB * Mmax(0, nu) + ALGO->align;
+			lwork += (size_t) JB * Mmax(0, nu) + ALGO->align;
 		}
 	}
 	else
 	{
-		int itmp1;
-		len = mp * JB + (itmp1 = JB*JB + JB + 1);
+		ml2 = ( myrow == icurrow ? mp - JB : mp ); ml2 = Mmax( 0, ml2 );
+		itmp1 = JB * JB + JB + 1;
 #ifdef HPL_COPY_L
-		panel_max_lwork = ALGO->align + len;
+		lwork = ALGO->align + (size_t) ml2 * JB + itmp1;
 #else
-		panel_max_lwork = ALGO->align + Mmax(itmp1, len);
+		lwork = ALGO->align + ( mycol == icurcol ? itmp1 : (size_t) ml2 * JB + itmp1 );
 #endif
-		if (nprow > 1)                                 /* space for U */
+		if (nprow > 1)
 		{
-			int nu = nq;
+			nu = ( mycol == icurcol ? nq - JB : nq );
 			if (nu % 8) nu += 8 - nu % 8;
 			if (nu % 16 == 0) nu += 8;
-			panel_max_lwork += JB * Mmax(0, nu) + ALGO->align;
+			lwork += (size_t) JB * Mmax(0, nu) + ALGO->align;
 		}
 	}
-	if (panel_max_lwork % 1024) panel_max_lwork += (1024 - panel_max_lwork % 1024);
+	return(panel_block_size(lwork, panel_iwork_size(JB, nprow)));
+}
 
-	if (nprow == 1)
-	{
-		panel_max_ilwork = JB;
-	}
-	else
+size_t panel_estimate_max_size(HPL_T_grid* GRID, HPL_T_palg* ALGO, int N, int NB)
+{
+	/* Replay the panel initializations of HPL_pdgesv and size the arena for the peak of the live panels */
+	int depth1 = (ALGO->depth >= 1), j, n, jb, pjb[2], itmp;
+	size_t size[2] = {0, 0}, peak, stmp;
+
+	jb = HPL_pdgesv_get_width(GRID, NB, 0, N);
+	size[depth1] = size[0] = panel_work_size(GRID, ALGO, N, N + 1, jb, NB, 0, 0);
+	pjb[0] = pjb[1] = jb;
+	peak = size[0] + size[1];
+	for (j = 0;j < N;j += jb)
 	{
-		int itmp1 = (JB << 1);
-		panel_max_ilwork = nprow + 1;
-		itmp1 = Mmax(itmp1, panel_max_ilwork);
-		panel_max_ilwork = 4 + (9 * JB) + (3 * nprow) + itmp1;
+		n = N - j;
+		jb = depth1 ? pjb[1] : HPL_pdgesv_get_width(GRID, NB, j, n);
+		if (j == 0 || depth1 == 0)
+		{
+			size[depth1] = panel_work_size(GRID, ALGO, n, n + 1, jb, NB, j, j);
+			pjb[depth1] = jb;
+			peak = Mmax(peak, size[0] + size[1]);
+		}
+		if (depth1 && j + jb < N)
+		{
+			pjb[0] = HPL_pdgesv_get_width(GRID, NB, j + jb, n - jb);
+			size[0] = panel_work_size(GRID, ALGO, n - jb, n - jb + 1, pjb[0], NB, j + jb, j + jb);
+			peak = Mmax(peak, size[0] + size[1]);
+		}
+		if (global_runtime_config.disable_lookahead && n <= global_runtime_config.disable_lookahead + jb + 1) depth1 = 0;
+		if (depth1)
+		{
+			stmp = size[0]; size[0] = size[1]; size[1] = stmp;
+			itmp = pjb[0]; pjb[0] = pjb[1]; pjb[1] = itmp;
+		}
 	}
-	if (panel_max_ilwork % 1024) panel_max_ilwork += (1024 - panel_max_ilwork % 1024);
-
-	size_t size = panel_max_lwork * sizeof(double) + panel_max_ilwork * sizeof(int);
-	if (ALGO->depth) size *= 2;
-	
-	return(size);
+	panel_arena_size = peak;
+	return(peak);
 }
 
 void HPL_pdpanel_init
@@ -222,7 +330,6 @@ START_TRACE( PDPANEL_INIT )
    int                        icurcol, icurrow, ii, itmp1, jj, lwork,
                               ml2, mp, mycol, myrow, npcol, nprow,
                               nq, nu;
-   int i;
 /* ..
  * .. Executable Statements ..
  */
@@ -235,7 +342,7 @@ START_TRACE( PDPANEL_INIT )
 
    HPL_infog2l( IA, JA, NB, NB, 0, 0, myrow, mycol,
                 nprow, npcol, &ii, &jj, &icurrow, &icurcol, GRID );
-   mp = HPL_numrowI( M, IA, NB, myrow, nprow );
+   mp = HPL_numrowI( M, IA, NB, myrow, nprow, GRID );
    nq = HPL_numcolI( N, JA, NB, mycol, GRID );
                                          /* ptr to trailing part of A */
    PANEL->A       = Mptr( (double *)(A->A), ii, jj, A->ld );
@@ -293,34 +400,8 @@ START_TRACE( PDPANEL_INIT )
           if (nu % 16 == 0) nu += 8;
           lwork += JB * Mmax( 0, nu ) + ALGO->align; }
 
-//printf("WORK1 %d of %d\n", (int) lwork, (int) panel_max_lwork);
-	  if (lwork > PANEL->memalloc)
-	  {
-		for (i = 0;i < PANEL_PREALLOC_COUNT;i++)
-		{
-			if (p_lwork[i] != NULL && lwork <= panel_max_lwork)
-			{
-				PANEL->WORK = p_lwork[i];
-				PANEL->memalloc = panel_max_lwork;
-				p_lwork[i] = NULL;
-				break;
-			}
-		}
-		if (i == PANEL_PREALLOC_COUNT)
-		{
-			HPL_pabort( __LINE__, "HPL_pdpanel_init", "Problem with preallocated panel memory");
-		}
-/*		if (PANEL->WORK)
-		{
-			 CALDGEMM_free(PANEL->WORK);
-			 fprintf(STD_OUT, "WARNING, reallocating Panel memory\n");
-		}
-		if( !( PANEL->WORK = (void *) CALDGEMM_alloc( (size_t)(lwork) * sizeof( double ), 0) ) )
-		{
-			HPL_pabort( __LINE__, "HPL_pdpanel_init", "Memory allocation failed" );
-		}
-		PANEL->memalloc = lwork;*/
-	  }
+	  panel_arena_release( PANEL );
+	  panel_arena_acquire( PANEL, lwork, panel_iwork_size( JB, nprow ) );
 
 /*
  * Initialize the pointers of the panel structure  -  Always re-use A in
@@ -350,34 +431,8 @@ START_TRACE( PDPANEL_INIT )
          lwork += JB * Mmax( 0, nu ) + ALGO->align;
       }
 
-//printf("WORK2 %d of %d\n", (int) lwork, (int) panel_max_lwork);
-	  if (lwork > PANEL->memalloc)
-	  {
-		for (i = 0;i < PANEL_PREALLOC_COUNT;i++)
-		{
-			if (p_lwork[i] != NULL && lwork <= panel_max_lwork)
-			{
-				PANEL->WORK = p_lwork[i];
-				PANEL->memalloc = panel_max_lwork;
-				p_lwork[i] = NULL;
-				break;
-			}
-		}
-		if (i == PANEL_PREALLOC_COUNT)
-		{
-			HPL_pabort( __LINE__, "HPL_pdpanel_init", "Problem with preallocated panel memory");
-		}
-/*		if (PANEL->WORK)
-		{
-			 CALDGEMM_free(PANEL->WORK);
-			 fprintf(STD_OUT, "WARNING, reallocating Panel memory\n");
-		}
-    		if( !( PANEL->WORK = (void *) CALDGEMM_alloc( (size_t)(lwork) * sizeof( double ),0 ) ) )
-    		{
-        	    HPL_pabort( __LINE__, "HPL_pdpanel_init", "Memory allocation failed" );
-    		}
-		PANEL->memalloc = lwork;*/
-	  }
+	  panel_arena_release( PANEL );
+	  panel_arena_acquire( PANEL, lwork, panel_iwork_size( JB, nprow ) );
 /*
  * Initialize the pointers of the panel structure - Re-use A in the cur-
  * rent process column when HPL_COPY_L is not defined.
@@ -443,40 +498,10 @@ START_TRACE( PDPANEL_INIT )
  *    IWORK[0] =  1: HPL_pdlaswp01 already computed those arrays;
  * This allows to save some redundant and useless computations.
  */
-   if( nprow == 1 ) { lwork = JB; }
-   else             
-   {
-      itmp1 = (JB << 1); lwork = nprow + 1; itmp1 = Mmax( itmp1, lwork );
-      lwork = 4 + (9 * JB) + (3 * nprow) + itmp1;
-   }
-
-//printf("IWORK3 %d of %d\n", (int) lwork, (int) panel_max_ilwork);
-   if (lwork > PANEL->memallocI)
-   {
-     /*if (PANEL->IWORK)
-	 {
-		 CALDGEMM_free(PANEL->IWORK);
-		 fprintf(STD_OUT, "WARNING, reallocating Panel memory\n");
-	 }
-         PANEL->IWORK = (int *) CALDGEMM_alloc( (size_t)(lwork) * sizeof( int ), 0 );
-	 PANEL->memallocI = lwork;*/
-	 
-		for (i = 0;i < PANEL_PREALLOC_COUNT;i++)
-		{
-			if (p_ilwork[i] != NULL && lwork <= panel_max_ilwork)
-			{
-				PANEL->IWORK = (int*) p_ilwork[i];
-				PANEL->memallocI = panel_max_ilwork;
-				p_ilwork[i] = NULL;
-				break;
-			}
-		}
-		if (i == PANEL_PREALLOC_COUNT)
-		{
-			HPL_pabort( __LINE__, "HPL_pdpanel_init", "Problem with preallocated panel memory");
-		}
-
-   }
+/*
+ * IWORK has been taken from the arena together with WORK above, its size
+ * is computed by panel_iwork_size.
+ */
    if( PANEL->IWORK == NULL )
    { HPL_pabort( __LINE__, "HPL_pdpanel_init", "Memory allocation failed" ); }
                        /* Initialize the first entry of the workarray */
@@ -0,0 +1,108 @@
+/**
+ * Lookup of the variable width block distribution
+ *
+ * Copyright 2010:
+ *  - David Rohr (drohr@jwdt.org)
+ *  - Matthias Bach (bach@compeng.uni-frankfurt.de)
+ *  - Matthias Kretz (kretz@compeng.uni-frankfurt.de)
+ *
+ * This file is part of HPL-GPU.
+ *
+ * HPL-GPU is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * HPL-GPU is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with HPL-GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition to the rules layed out by the GNU General Public License
+ * the following exception is granted:
+ *
+ * Use with the Original BSD License.
+ *
+ * Notwithstanding any other provision of the GNU General Public License
+ * Version 3, you have permission to link or combine any covered work with
+ * a work licensed under the 4-clause BSD license into a single combined
+ * work, and to convey the resulting work.  The terms of this License will
+ * continue to apply to the part which is the covered work, but the special
+ * requirements of the 4-clause BSD license, clause 3, concerning the
+ * requirement of acknowledgement in advertising materials will apply to
+ * the combination as such.
+ */
+
+/*
+ * Include files
+ */
+#include "hpl.h"
+
+/*
+ * With HPL_NB_MULTIPLIER the matrix is distributed in blocks of the panel
+ * widths of the NB schedule instead of uniform NB blocks (see
+ * HPL_pddriver_mapping). Every block consists of whole NB blocks, so the
+ * per NB block tables col_mapping and row_mapping still apply, and all NB
+ * blocks of a block belong to the same process column and process row.
+ * GRID->block_offset holds the first global column of every block, it is
+ * NULL for the uniform distribution.
+ */
+
+int HPL_blockindex(const int J, const int NB, const HPL_T_grid* GRID)
+{
+	//Index of the block containing global column J
+	if (GRID->block_offset == NULL) return(J / NB);
+	int lo = 0, hi = GRID->nblocks - 1;
+	while (lo < hi)
+	{
+		const int mid = (lo + hi + 1) / 2;
+		if (GRID->block_offset[mid] <= J) lo = mid;
+		else hi = mid - 1;
+	}
+	return(lo);
+}
+
+int HPL_blockstart(const int J, const int NB, const HPL_T_grid* GRID)
+{
+	//First global column of the block containing column J
+	if (GRID->block_offset == NULL) return(J - J % NB);
+	return(GRID->block_offset[HPL_blockindex(J, NB, GRID)]);
+}
+
+int HPL_blockend(const int J, const int NB, const HPL_T_grid* GRID)
+{
+	//First global column after the block containing column J
+	if (GRID->block_offset == NULL) return(J - J % NB + NB);
+	return(GRID->block_offset[HPL_blockindex(J, NB, GRID) + 1]);
+}
+
+int HPL_colcount(const int JG, const int NB, const int PROC, const HPL_T_grid* GRID)
+{
+	//Number of the global columns 0..JG-1 owned by process column PROC
+	const int k = JG / NB, r = JG - k * NB;
+	return(GRID->col_count[k * GRID->npcol + PROC] + (r && GRID->col_mapping[k] == PROC ? r : 0));
+}
+
+int HPL_rowcount(const int IG, const int NB, const int PROC, const HPL_T_grid* GRID)
+{
+	//Number of the global rows 0..IG-1 owned by process row PROC, only valid with GRID->row_mapping
+	const int k = IG / NB, r = IG - k * NB;
+	return(GRID->row_count[k * GRID->nprow + PROC] + (r && GRID->row_mapping[k] == PROC ? r : 0));
+}
+
+int HPL_rowl2g(const int IL, const int NB, const int PROC, const HPL_T_grid* GRID)
+{
+	//Global row of the local row IL of process row PROC, only valid with GRID->row_mapping
+	//The NB block containing it is the first one after which PROC has more than IL rows
+	int lo = 1, hi = GRID->row_blocks;
+	while (lo < hi)
+	{
+		const int mid = (lo + hi) / 2;
+		if (GRID->row_count[mid * GRID->nprow + PROC] > IL) hi = mid;
+		else lo = mid + 1;
+	}
+	return((lo - 1) * NB + IL - GRID->row_count[(lo - 1) * GRID->nprow + PROC]);
+}
@@ -0,0 +1,209 @@
+/**
+ * Assignment of the NB blocks to the process columns and rows by weight
+ *
+ * Copyright 2010:
+ *  - David Rohr (drohr@jwdt.org)
+ *  - Matthias Bach (bach@compeng.uni-frankfurt.de)
+ *  - Matthias Kretz (kretz@compeng.uni-frankfurt.de)
+ *
+ * This file is part of HPL-GPU.
+ *
+ * HPL-GPU is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * HPL-GPU is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with HPL-GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition to the rules layed out by the GNU General Public License
+ * the following exception is granted:
+ *
+ * Use with the Original BSD License.
+ *
+ * Notwithstanding any other provision of the GNU General Public License
+ * Version 3, you have permission to link or combine any covered work with
+ * a work licensed under the 4-clause BSD license into a single combined
+ * work, and to convey the resulting work.  The terms of this License will
+ * continue to apply to the part which is the covered work, but the special
+ * requirements of the 4-clause BSD license, clause 3, concerning the
+ * requirement of acknowledgement in advertising materials will apply to
+ * the combination as such.
+ */
+
+/*
+ * Include files
+ */
+#include "hpl.h"
+
+/*
+ * The matrix columns are assigned to the process columns in units of NB
+ * columns (GRID->col_mapping), or of whole variable width blocks with
+ * GRID->block_offset. The units are dealt out in order, each one to the
+ * next process column whose share of the units assigned so far is below
+ * its share of the weights. Two consecutive units never go to the same
+ * process column. HPL_pddriver_mapping uses this for the initial mapping
+ * from the node performance, HPL_pdrebalance to distribute the columns
+ * not factored yet from the measured throughput.
+ * The rows are assigned to the process rows the same way when the node
+ * performance differs between the process rows (GRID->row_mapping), but
+ * consecutive units may go to the same process row.
+ */
+
+static int HPL_mapping
+(
+   FILE *                           OUTFP,
+   const HPL_T_grid *               GRID,
+   const int                        NPROC,
+   const int                        DISTINCT,
+   const char *                     DIM,
+   const int                        N,
+   const int                        NB,
+   const float *                    WEIGHTS,
+   const int                        FIRST,
+   const int *                      CAP,
+   int *                            MAPPING,
+   int *                            COUNT
+)
+{
+   const int nproc = NPROC, mcols = (N + NB) / NB;
+   float total = 0;
+   for (int q = 0;q < nproc;q++) total += WEIGHTS[q];
+   int* size = (int*) malloc(nproc * sizeof(int));
+   for (int q = 0;q < nproc;q++) COUNT[q] = size[q] = 0;
+
+   int lastproc = FIRST && DISTINCT ? MAPPING[FIRST - 1] : -1;
+   int j = (lastproc + 1) % nproc;
+   float relax = 0;
+   for (int i = FIRST, k;i < mcols;i += k)
+   {
+      //Assign the block of k NB blocks starting at NB block i
+      k = GRID->block_offset ? GRID->block_offset[HPL_blockindex(i * NB, NB, GRID) + 1] / NB - i : 1;
+      const int width = Mmin((i + k) * NB, N) - i * NB;
+      int jstart = j, round1 = 1, full = 0;
+      for (;;)
+      {
+         if (j == lastproc || (CAP && size[j] + width > CAP[j])) full++;
+         else if (nproc == 1 || i == FIRST || WEIGHTS[j] / total * (float) (i - FIRST + k) >= (float) COUNT[j] + 0.5 * (float) round1 - relax) break;
+         else fprintfctd(OUTFP, "Skipping process %s %d (desired blocks %f, present blocks %d)\n", DIM, j, WEIGHTS[j] / total * (float) (i - FIRST + k), COUNT[j]);
+         j++;
+         j = j % nproc;
+         if (j == jstart)
+         {
+            if (full == nproc)
+            {
+               free(size);
+               return(1);
+            }
+            if (round1 > 0) round1 = 0;
+            else relax += 0.1;
+            full = 0;
+         }
+      }
+      for (int l = i;l < i + k;l++) MAPPING[l] = j;
+      COUNT[j] += k;
+      size[j] += width;
+      lastproc = nproc > 1 && DISTINCT ? j : -1;
+      relax = 0;
+      fprintfctd(OUTFP, "Matrix %s %d processed by process %s %d (%d total matrix %ss)\n", DIM, i, DIM, j, COUNT[j], DIM);
+      j++;
+      j = j % nproc;
+   }
+   free(size);
+   return(0);
+}
+
+int HPL_colmapping
+(
+   FILE *                           OUTFP,
+   const HPL_T_grid *               GRID,
+   const int                        N,
+   const int                        NB,
+   const float *                    WEIGHTS,
+   const int                        FIRST,
+   const int *                      CAP,
+   int *                            MAPPING,
+   int *                            COUNT
+)
+{
+/*
+ * Assigns the units from NB block FIRST on of the N + 1 columns to the
+ * process columns according to WEIGHTS, the units before FIRST are kept.
+ * COUNT returns the number of NB blocks assigned to every process column.
+ * If CAP is not NULL, process column q gets at most CAP[q] of the N
+ * columns of A, not counting b.
+ * Returns nonzero if the columns do not fit into CAP.
+ */
+   return(HPL_mapping(OUTFP, GRID, GRID->npcol, 1, "col", N, NB, WEIGHTS, FIRST, CAP, MAPPING, COUNT));
+}
+
+void HPL_rowmapping
+(
+   FILE *                           OUTFP,
+   const HPL_T_grid *               GRID,
+   const int                        N,
+   const int                        NB,
+   const float *                    WEIGHTS,
+   int *                            MAPPING,
+   int *                            COUNT
+)
+{
+/*
+ * Assigns the units of the N rows to the process rows according to
+ * WEIGHTS. MAPPING has an entry for each of the (N + NB) / NB NB blocks
+ * like GRID->col_mapping, COUNT returns the number of NB blocks assigned
+ * to every process row.
+ */
+   (void) HPL_mapping(OUTFP, GRID, GRID->nprow, 0, "row", N, NB, WEIGHTS, 0, NULL, MAPPING, COUNT);
+}
+
+void HPL_colmapping_tables
+(
+   HPL_T_grid *                     GRID,
+   const int                        N,
+   const int                        NB
+)
+{
+/*
+ * Recomputes the lookup tables GRID->col_count and col_prev from
+ * GRID->col_mapping.
+ */
+   const int npcol = GRID->npcol, mcols = (N + NB) / NB;
+   int* last = (int*) malloc(npcol * sizeof(int));
+   for (int q = 0;q < npcol;q++)
+   {
+      GRID->col_count[q] = 0;
+      last[q] = -1;
+   }
+   for (int i = 0;i < mcols;i++)
+   {
+      for (int q = 0;q < npcol;q++) GRID->col_count[(i + 1) * npcol + q] = GRID->col_count[i * npcol + q] + (GRID->col_mapping[i] == q ? NB : 0);
+      GRID->col_prev[i] = last[GRID->col_mapping[i]];
+      last[GRID->col_mapping[i]] = i;
+   }
+   free(last);
+}
+
+void HPL_rowmapping_tables
+(
+   HPL_T_grid *                     GRID,
+   const int                        N,
+   const int                        NB
+)
+{
+/*
+ * Recomputes the lookup table GRID->row_count from GRID->row_mapping.
+ */
+   const int nprow = GRID->nprow, mcols = (N + NB) / NB;
+   GRID->row_blocks = mcols;
+   for (int p = 0;p < nprow;p++) GRID->row_count[p] = 0;
+   for (int i = 0;i < mcols;i++)
+   {
+      for (int p = 0;p < nprow;p++) GRID->row_count[(i + 1) * nprow + p] = GRID->row_count[i * nprow + p] + (GRID->row_mapping[i] == p ? NB : 0);
+   }
+}
@@ -44,6 +44,7 @@
 
 #include "util_timer.h"
 #include "util_trace.h"
+#include "util_capture.h"
 
 namespace
 {
@@ -85,6 +86,7 @@ namespace
 extern "C" void HPL_dlaswp00N(const int M, const int N, double *__restrict__ A, const int LDA, const int *__restrict__ IPIV)
 {
 START_TRACE( DLASWP00N )
+CAPTURE_START
 
 #ifdef USE_ORIGINAL_LASWP
 #include "HPL_dlaswp00N.c"
@@ -148,6 +150,7 @@ START_TRACE( DLASWP00N )
     }
 #endif
 END_TRACE
+CAPTURE_CALL( CAPTURE_DLASWP00N, M, IPIV, 0, NULL, M, N, LDA )
 #ifdef TRACE_LASWP
    char filename[256];
    snprintf(filename, 256, "dlaswp00N.%04d.%05d.%05d.%7.4fs.dat", M, N, LDA, laswp_time);
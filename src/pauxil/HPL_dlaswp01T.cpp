@@ -37,6 +37,7 @@
 #include <cstddef>
 #include "util_timer.h"
 #include "util_trace.h"
+#include "util_capture.h"
 
 #ifndef USE_ORIGINAL_LASWP
 #include <tbb/parallel_for.h>
@@ -172,6 +173,7 @@ extern "C" void HPL_dlaswp01T(const int M, const int N, double *A, const int LDA
         double *U, const int LDU, const int *LINDXA, const int *LINDXAU)
 {
 START_TRACE( DLASWP01T )
+CAPTURE_START
 
 #ifdef USE_ORIGINAL_LASWP
 #include "HPL_dlaswp01T.c"
@@ -228,6 +230,7 @@ START_TRACE( DLASWP01T )
 #endif
 
 END_TRACE
+CAPTURE_CALL( CAPTURE_DLASWP01T, M, LINDXA, M, LINDXAU, M, N, LDA, LDU )
 #ifdef TRACE_LASWP
    char filename[256];
    snprintf(filename, 256, "dlaswp01T.%04d.%05d.%05d.%05d.%7.4fs.dat", M, N, LDA, LDU, laswp_time);
@@ -37,6 +37,7 @@
 #include <cstddef>
 #include "util_timer.h"
 #include "util_trace.h"
+#include "util_capture.h"
 
 #ifndef USE_ORIGINAL_LASWP
 #include <tbb/parallel_for.h>
@@ -162,6 +163,7 @@ extern "C" void HPL_dlaswp06T(const int M, const int N, double *A,
         const int LDA, double *U, const int LDU, const int *LINDXA)
 {
 START_TRACE( DLASWP06T )
+CAPTURE_START
 
 #ifdef USE_ORIGINAL_LASWP
 #include "HPL_dlaswp06T.c"
@@ -175,6 +177,7 @@ START_TRACE( DLASWP06T )
 #endif
 
 END_TRACE
+CAPTURE_CALL( CAPTURE_DLASWP06T, M, LINDXA, 0, NULL, M, N, LDA, LDU )
 #ifdef TRACE_LASWP
    char filename[256];
    snprintf(filename, 256, "dlaswp06T.%04d.%05d.%05d.%05d.%7.4fs.dat", M, N, LDA, LDU, laswp_time);
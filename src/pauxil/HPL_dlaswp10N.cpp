@@ -36,6 +36,7 @@
 
 #include "util_timer.h"
 #include "util_trace.h"
+#include "util_capture.h"
 #include "helpers.h"
 #include <tbb/parallel_for.h>
 
@@ -107,6 +108,7 @@ extern "C" void HPL_dlaswp10N(const int _M, const int N, double *A,
         const int LDA, const int *IPIV)
 {
 START_TRACE( DLASWP10N )
+CAPTURE_START
 
 #ifdef USE_ORIGINAL_LASWP
 const int M = _M;
@@ -163,6 +165,7 @@ const int M = _M;
 #endif
 
 END_TRACE
+CAPTURE_CALL( CAPTURE_DLASWP10N, N, IPIV, 0, NULL, _M, N, LDA )
 #ifdef TRACE_LASWP
    char filename[256];
    snprintf(filename, 256, "dlaswp10N.%04d.%05d.%05d.%7.4fs.dat", M, N, LDA, laswp_time);
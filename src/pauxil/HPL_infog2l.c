@@ -167,7 +167,15 @@ void HPL_infog2l
    imb   = MB;
    *PROW = RSRC;
 
-   if( ( *PROW == -1 ) || ( NPROW == 1 ) )
+   if( GRID->row_mapping )
+   {
+/*
+ * Rows distributed in variable width blocks
+ */
+      *PROW = GRID->row_mapping[I / MB];
+      *II = HPL_rowcount( I, MB, MYROW, GRID );
+   }
+   else if( ( *PROW == -1 ) || ( NPROW == 1 ) )
    {
 /*
  * The data is not distributed,  or there is just one process row in the
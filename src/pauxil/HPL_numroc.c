@@ -69,7 +69,8 @@ int HPL_numrow
    const int                        N,
    const int                        NB,
    const int                        PROC,
-   const int                        NPROCS
+   const int                        NPROCS,
+   const HPL_T_grid*                GRID
 )
 {
 /* 
@@ -106,12 +107,15 @@ int HPL_numrow
  *         or columns over which the matrix is distributed.  NPROCS must
  *         be at least one.
  *
+ * GRID    (input)                       const HPL_T_grid *
+ *         On entry, GRID points to the process grid.
+ *
  * ---------------------------------------------------------------------
  */ 
 /* ..
  * .. Executable Statements ..
  */
-   return( HPL_numrowI( N, 0, NB, PROC, NPROCS ) );
+   return( HPL_numrowI( N, 0, NB, PROC, NPROCS, GRID ) );
 /*
  * End of HPL_numroc
  */
@@ -70,7 +70,8 @@ int HPL_numrowI
    const int                        I,
    const int                        NB,
    const int                        PROC,
-   const int                        NPROCS
+   const int                        NPROCS,
+   const HPL_T_grid*                GRID
 )
 {
 /* 
@@ -111,6 +112,11 @@ int HPL_numrowI
  *         or columns over which the matrix is distributed.  NPROCS mus
  *         be at least one.
  *
+ * GRID    (input)                       const HPL_T_grid *
+ *         On entry, GRID points to the process grid. If it has a  row
+ *         mapping of variable width blocks, the rows are counted  from
+ *         that mapping.
+ *
  * ---------------------------------------------------------------------
  */ 
 /*
@@ -120,6 +126,8 @@ int HPL_numrowI
 /* ..
  * .. Executable Statements ..
  */
+   if( GRID->row_mapping )
+      return( HPL_rowcount( I + N, NB, PROC, GRID ) - HPL_rowcount( I, NB, PROC, GRID ) );
    if( ( NPROCS == 1 ) )
 /*
  * The data is not distributed, or there is just one process in this di-
@@ -242,32 +250,6 @@ int HPL_numrowI
 
 int HPL_numcolI (const int N, const int I, const int NB, const int PROC, const HPL_T_grid* grid)
 {
-	int numcols = 0;
-	int i = I;
-	int n = N + I;
-	if (i % NB)
-	{
-		if (grid->col_mapping[I / NB] == PROC)
-		{
-			if (i / NB == n / NB)
-			{
-				numcols += n - i;
-			}
-			else
-			{
-				numcols += NB - i % NB;
-			}
-		}
-		if (i / NB == n / NB)
-		{
-			return(numcols);
-		}
-		i += NB - i % NB;
-	}
-	for (;i < n - n % NB;i += NB)
-	{
-		if (grid->col_mapping[i / NB] == PROC) numcols += NB;
-	}
-	if (n % NB && grid->col_mapping[n / NB] == PROC) numcols += n % NB;
-	return(numcols);
+	//Local columns of process column PROC among the global columns I..I+N-1, from the prefix counts of HPL_pddriver_mapping
+	return(HPL_colcount(I + N, NB, PROC, grid) - HPL_colcount(I, NB, PROC, grid));
 }
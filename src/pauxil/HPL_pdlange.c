@@ -134,7 +134,7 @@ double HPL_pdlange
    Rcomm = GRID->row_comm; Ccomm = GRID->col_comm;
    Acomm = GRID->all_comm;
 
-   Mnumrow( mp, M, NB, myrow, nprow );
+   Mnumrow( mp, M, NB, myrow, nprow, GRID );
    Mnumcol( nq, N, NB, mycol, GRID );
 
    if( Mmin( M, N ) == 0 ) { return( v0 ); }
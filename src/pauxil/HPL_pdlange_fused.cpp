@@ -0,0 +1,199 @@
+/**
+ * Fused computation of the 1-, infinity- and max-norm of a distributed matrix
+ *
+ * Copyright 2010:
+ *  - David Rohr (drohr@jwdt.org)
+ *  - Matthias Bach (bach@compeng.uni-frankfurt.de)
+ *  - Matthias Kretz (kretz@compeng.uni-frankfurt.de)
+ *
+ * This file is part of HPL-GPU.
+ *
+ * HPL-GPU is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * HPL-GPU is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with HPL-GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition to the rules layed out by the GNU General Public License
+ * the following exception is granted:
+ *
+ * Use with the Original BSD License.
+ *
+ * Notwithstanding any other provision of the GNU General Public License
+ * Version 3, you have permission to link or combine any covered work with
+ * a work licensed under the 4-clause BSD license into a single combined
+ * work, and to convey the resulting work.  The terms of this License will
+ * continue to apply to the part which is the covered work, but the special
+ * requirements of the 4-clause BSD license, clause 3, concerning the
+ * requirement of acknowledgement in advertising materials will apply to
+ * the combination as such.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <emmintrin.h>
+#include <tbb/parallel_reduce.h>
+#include <tbb/blocked_range.h>
+extern "C" {
+#include "hpl.h"
+}
+
+#ifndef HPL_PDLANGE_FUSED_SERIAL_SIZE
+#define HPL_PDLANGE_FUSED_SERIAL_SIZE 65536
+#endif
+
+/*
+ * Every body writes the column sums of its columns directly and keeps its
+ * own row sums, which are added up when the bodies are joined. The root
+ * body accumulates into the buffer of the caller.
+ */
+class HPL_pdlange_fused_impl
+{
+	const double* const A;
+	const size_t LDA;
+	const int mp;
+	double* const colsum;
+	double* rowsum;
+	bool own;
+public:
+	double amax;
+
+	HPL_pdlange_fused_impl(const double* _A, size_t _LDA, int _mp, double* _colsum, double* _rowsum)
+		: A(_A), LDA(_LDA), mp(_mp), colsum(_colsum), rowsum(_rowsum), own(false), amax(0.)
+	{}
+
+	HPL_pdlange_fused_impl(HPL_pdlange_fused_impl& other, tbb::split)
+		: A(other.A), LDA(other.LDA), mp(other.mp), colsum(other.colsum), rowsum(NULL), own(true), amax(0.)
+	{}
+
+	~HPL_pdlange_fused_impl()
+	{
+		if (own) free(rowsum);
+	}
+
+	void operator()(const tbb::blocked_range<int> &range)
+	{
+		if (rowsum == NULL)
+		{
+			rowsum = (double*) calloc(mp, sizeof(double));
+			if (rowsum == NULL) HPL_pabort(__LINE__, "HPL_pdlange_fused", "Memory allocation failed");
+		}
+		const __m128d absmask = _mm_castsi128_pd(_mm_set1_epi64x(0x7FFFFFFFFFFFFFFFll));
+		__m128d vmax = _mm_set1_pd(amax);
+		for (int j = range.begin();j != range.end();j++)
+		{
+			const double* __restrict__ col = A + j * LDA;
+			double* __restrict__ rs = rowsum;
+			double s = 0.;
+			int i = 0;
+			if (((size_t) col & 15) && mp)
+			{
+				const double a = col[0] < 0 ? -col[0] : col[0];
+				s = a;
+				rs[0] += a;
+				vmax = _mm_max_pd(vmax, _mm_set1_pd(a));
+				i = 1;
+			}
+			__m128d vsum = _mm_setzero_pd();
+			for (;i + 2 <= mp;i += 2)
+			{
+				const __m128d a = _mm_and_pd(_mm_load_pd(col + i), absmask);
+				vsum = _mm_add_pd(vsum, a);
+				vmax = _mm_max_pd(vmax, a);
+				_mm_storeu_pd(rs + i, _mm_add_pd(_mm_loadu_pd(rs + i), a));
+			}
+			double tmp[2];
+			_mm_storeu_pd(tmp, vsum);
+			s += tmp[0] + tmp[1];
+			if (i < mp)
+			{
+				const double a = col[i] < 0 ? -col[i] : col[i];
+				s += a;
+				rs[i] += a;
+				vmax = _mm_max_pd(vmax, _mm_set1_pd(a));
+			}
+			colsum[j] = s;
+		}
+		double tmp[2];
+		_mm_storeu_pd(tmp, vmax);
+		amax = Mmax(tmp[0], tmp[1]);
+	}
+
+	void join(HPL_pdlange_fused_impl& rhs)
+	{
+		if (rhs.rowsum && rowsum == NULL)
+		{
+			rowsum = rhs.rowsum;
+			own = rhs.own;
+			rhs.rowsum = NULL;
+		}
+		else if (rhs.rowsum)
+		{
+			for (int i = 0;i < mp;i++) rowsum[i] += rhs.rowsum[i];
+		}
+		amax = Mmax(amax, rhs.amax);
+	}
+};
+
+/*
+ * Computes NORMS[0] = ||A||_1, NORMS[1] = ||A||_oo and NORMS[2] = max |a_ij|
+ * of the distributed M by N matrix A in a single multithreaded pass over the
+ * local array. The column and row sums are reduced within the process column
+ * and process row, the three norms then in one combined reduction, so NORMS
+ * is the same on all processes.
+ */
+extern "C" void HPL_pdlange_fused(const HPL_T_grid* GRID, const int M, const int N, const int NB, const double* A, const int LDA, double* NORMS)
+{
+	int mp, mycol, myrow, npcol, nprow, nq;
+
+	(void) HPL_grid_info(GRID, &nprow, &npcol, &myrow, &mycol);
+	Mnumrow(mp, M, NB, myrow, nprow, GRID);
+	Mnumcol(nq, N, NB, mycol, GRID);
+
+	NORMS[0] = NORMS[1] = NORMS[2] = HPL_rzero;
+	if (Mmin(M, N) == 0) return;
+
+	double* colsum = (double*) malloc(Mmax(nq, 1) * sizeof(double));
+	double* rowsum = (double*) calloc(Mmax(mp, 1), sizeof(double));
+	if (colsum == NULL || rowsum == NULL) HPL_pabort(__LINE__, "HPL_pdlange_fused", "Memory allocation failed");
+
+	if (nq > 0 && mp > 0)
+	{
+		HPL_pdlange_fused_impl impl(A, LDA, mp, colsum, rowsum);
+		if ((size_t) mp * nq <= HPL_PDLANGE_FUSED_SERIAL_SIZE)
+		{
+			impl(tbb::blocked_range<int>(0, nq));
+		}
+		else
+		{
+			tbb::parallel_reduce(tbb::blocked_range<int>(0, nq), impl, tbb::auto_partitioner());
+		}
+		NORMS[2] = impl.amax;
+	}
+	else if (nq > 0)
+	{
+		memset(colsum, 0, nq * sizeof(double));
+	}
+
+	if (nq > 0)
+	{
+		(void) HPL_all_reduce((void*) colsum, nq, HPL_DOUBLE, HPL_sum, GRID->col_comm);
+		for (int j = 0;j < nq;j++) NORMS[0] = Mmax(NORMS[0], colsum[j]);
+	}
+	if (mp > 0)
+	{
+		(void) HPL_all_reduce((void*) rowsum, mp, HPL_DOUBLE, HPL_sum, GRID->row_comm);
+		for (int i = 0;i < mp;i++) NORMS[1] = Mmax(NORMS[1], rowsum[i]);
+	}
+	(void) HPL_all_reduce((void*) NORMS, 3, HPL_DOUBLE, HPL_max, GRID->all_comm);
+
+	free(colsum);
+	free(rowsum);
+}
@@ -63,6 +63,12 @@ extern "C" int get_num_procs();
 namespace
 {
     extern "C" int HPL_init_laswp(void* ptr);
+    extern "C" void HPL_laswp_set_threads(const int num);
+
+    //Scheduler of the LASWP worker threads, the cores they may run on, and the current and initial thread count
+    tbb::task_scheduler_init* laswp_scheduler = NULL;
+    cpu_set_t laswp_mask;
+    int laswp_threads = 0, laswp_max_threads = 0;
 
     class HPL_init_laswp_foo
     {
@@ -74,6 +80,23 @@ namespace
     };
 
 
+    void laswp_start(const int num_threads)
+    {
+		// the worker threads inherit the affinity of the main thread while they are created
+		cpu_set_t oldmask;
+		sched_getaffinity(0, sizeof(cpu_set_t), &oldmask);
+		sched_setaffinity(0, sizeof(cpu_set_t), &laswp_mask);
+		
+		//fprintf(stderr, "Pin TBB worker threads to core(s) 0x%016lX\n", laswp_mask.__bits[0]);
+		if (laswp_scheduler == NULL) laswp_scheduler = new tbb::task_scheduler_init(num_threads);
+		else laswp_scheduler->initialize(num_threads);
+		tbb::parallel_for (tbb::blocked_range<size_t>(0, num_threads, 1), HPL_init_laswp_foo());
+		laswp_threads = num_threads;
+
+		//fprintf(stderr, "       Pin main thread to core(s) 0x%016lX\n", oldmask.__bits[0]);
+		sched_setaffinity(0, sizeof(cpu_set_t), &oldmask);
+    }
+
     int HPL_init_laswp(void* ptr)
     {
 		int num_threads = tbb::task_scheduler_init::automatic;
@@ -144,17 +167,21 @@ namespace
 		printf(")\n");
 
 #endif
-		sched_setaffinity(0, sizeof(cpu_set_t), &fullMask);
-		
-		//fprintf(stderr, "Pin TBB worker threads to core(s) 0x%016lX\n", fullMask.__bits[0]);
-		static tbb::task_scheduler_init init(num_threads);
-		tbb::parallel_for (tbb::blocked_range<size_t>(0, num_threads, 1), HPL_init_laswp_foo());
-
-		//fprintf(stderr, "       Pin main thread to core(s) 0x%016lX\n", oldmask.__bits[0]);
-		sched_setaffinity(0, sizeof(cpu_set_t), &oldmask);
-
+		laswp_mask = fullMask;
+		laswp_max_threads = num_threads;
+		laswp_start(num_threads);
 		return 0;
     }
+
+    void HPL_laswp_set_threads(const int num)
+    {
+		//Restart the scheduler with a different number of worker threads, num <= 0 restores the initial count
+		if (laswp_scheduler == NULL) return;
+		const int num_threads = (num <= 0 || num > laswp_max_threads) ? laswp_max_threads : num;
+		if (num_threads == laswp_threads) return;
+		laswp_scheduler->terminate();
+		laswp_start(num_threads);
+    }
 }
 
 #endif
@@ -0,0 +1,310 @@
+/*
+ *  -- High Performance Computing Linpack Benchmark (HPL-GPU)
+ *     HPL-GPU - 2.0 - 2015
+ *
+ *     David Rohr
+ *     Matthias Kretz
+ *     Matthias Bach
+ *     Goethe Universität, Frankfurt am Main
+ *     Frankfurt Institute for Advanced Studies
+ *     (C) Copyright 2010 All Rights Reserved
+ *
+ *     Antoine P. Petitet
+ *     University of Tennessee, Knoxville
+ *     Innovative Computing Laboratory
+ *     (C) Copyright 2000-2008 All Rights Reserved
+ *
+ *  -- Copyright notice and Licensing terms:
+ *
+ *  Redistribution  and  use in  source and binary forms, with or without
+ *  modification, are  permitted provided  that the following  conditions
+ *  are met:
+ *
+ *  1. Redistributions  of  source  code  must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce  the above copyright
+ *  notice, this list of conditions,  and the following disclaimer in the
+ *  documentation and/or other materials provided with the distribution.
+ *
+ *  3. All  advertising  materials  mentioning  features  or  use of this
+ *  software must display the following acknowledgements:
+ *  This  product  includes  software  developed  at  the  University  of
+ *  Tennessee, Knoxville, Innovative Computing Laboratory.
+ *  This product  includes software  developed at the Frankfurt Institute
+ *  for Advanced Studies.
+ *
+ *  4. The name of the  University,  the name of the  Laboratory,  or the
+ *  names  of  its  contributors  may  not  be used to endorse or promote
+ *  products  derived   from   this  software  without  specific  written
+ *  permission.
+ *
+ *  -- Disclaimer:
+ *
+ *  THIS  SOFTWARE  IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,  INCLUDING,  BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY
+ *  OR  CONTRIBUTORS  BE  LIABLE FOR ANY  DIRECT,  INDIRECT,  INCIDENTAL,
+ *  SPECIAL,  EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES  (INCLUDING,  BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA OR PROFITS; OR BUSINESS INTERRUPTION)  HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT,  STRICT LIABILITY,  OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * ======================================================================
+ */
+
+/*
+ * Include files
+ */
+extern "C" {
+#include "hpl.h"
+}
+
+#include "util_timer.h"
+#include "util_trace.h"
+/*
+ * The unrolling depth is HPL_LOCSWP_DEPTH of the runtime configuration.
+ * Each depth is a separate instantiation, the inner copies are unrolled
+ * at compile time by locswp_unroll.
+ */
+namespace
+{
+   template <int K, class OP> struct locswp_unroll
+   {
+      static inline void run( OP& op )
+      { locswp_unroll<K-1, OP>::run( op ); op( K-1 ); }
+   };
+   template <class OP> struct locswp_unroll<0, OP>
+   {
+      static inline void run( OP& ) {}
+   };
+/*
+ * Apply op to n consecutive entries, DEPTH at a time, then the remainder.
+ */
+   template <int DEPTH, class OP> inline void locswp_apply( OP& op, const int n )
+   {
+      const int nu = ( n / DEPTH ) * DEPTH;
+      int i;
+      for( i = 0; i < nu; i += DEPTH )
+      { locswp_unroll<DEPTH, OP>::run( op ); op.next( DEPTH ); }
+      for( i = 0; i < n - nu; i++ ) op( i );
+   }
+/*
+ * Copy the max row into L1 and A, the current row into the max row of A.
+ */
+   struct locswp_swap
+   {
+      double * L, * A1, * A2; const double * Wmx, * Wr0; int lda;
+      inline void operator()( const int k )
+      { L[k] = *A1 = Wmx[k]; *A2 = Wr0[k]; A1 += lda; A2 += lda; }
+      inline void next( const int n ) { L += n; Wmx += n; Wr0 += n; }
+   };
+/*
+ * Copy a row into L1 only.
+ */
+   struct locswp_copy
+   {
+      double * L; const double * W;
+      inline void operator()( const int k ) { L[k] = W[k]; }
+      inline void next( const int n ) { L += n; W += n; }
+   };
+/*
+ * Copy the max row into L1 and A.
+ */
+   struct locswp_copy2
+   {
+      double * L, * A1; const double * Wmx; int lda;
+      inline void operator()( const int k ) { L[k] = *A1 = Wmx[k]; A1 += lda; }
+      inline void next( const int n ) { L += n; Wmx += n; }
+   };
+/*
+ * Copy the current row into the max row of A.
+ */
+   struct locswp_write
+   {
+      double * A2; const double * Wr0; int lda;
+      inline void operator()( const int k ) { *A2 = Wr0[k]; A2 += lda; }
+      inline void next( const int n ) { Wr0 += n; }
+   };
+
+   template <int DEPTH> void HPL_dlocswpT_impl
+   (
+      HPL_T_panel *                    PANEL,
+      const int                        II,
+      const int                        JJ,
+      double *                         WORK
+   )
+   {
+/*
+ * .. Local Variables ..
+ */
+      double                     gmax;
+      double                     * L, * Wr0, * Wmx;
+      int                        ilindx, lda, myrow, n0;
+/* ..
+ * .. Executable Statements ..
+ */
+      myrow = PANEL->grid->myrow; n0 = PANEL->jb; lda = PANEL->lda;
+
+      Wr0   = ( Wmx = WORK + 4 ) + n0; Wmx[JJ] = gmax = WORK[0];
+/*
+ * Replicated swap and copy of the current (new) row of A into L1
+ */
+      L  = Mptr( PANEL->L1, 0, JJ, n0  );
+/*
+ * If the pivot is non-zero ...
+ */
+      if( gmax != HPL_rzero )
+      {
+/*
+ * and if I own the current row of A ...
+ */
+         if( myrow == PANEL->prow )
+         {
+/*
+ * and if I also own the row to be swapped with the current row of A ...
+ */
+            if( myrow == (int)(WORK[3]) )
+            {
+/*
+ * and if the current row of A is not to swapped with itself ...
+ */
+               if( ( ilindx = (int)(WORK[1]) ) != 0 )
+               {
+/*
+ * then copy the max row into L1 and locally swap the 2 rows of A.
+ */
+                  locswp_swap op;
+                  op.L = L; op.Wmx = Wmx; op.Wr0 = Wr0; op.lda = lda;
+                  op.A1 = Mptr( PANEL->A, II, 0, lda );
+                  op.A2 = Mptr( op.A1, ilindx, 0, lda );
+                  locswp_apply<DEPTH>( op, n0 );
+               }
+               else
+               {
+/*
+ * otherwise the current row of  A  is swapped with itself, so just copy
+ * the current of A into L1.
+ */
+                  *Mptr( PANEL->A, II, JJ, lda ) = gmax;
+
+                  locswp_copy op;
+                  op.L = L; op.W = Wmx;
+                  locswp_apply<DEPTH>( op, n0 );
+               }
+            }
+            else
+            {
+/*
+ * otherwise, the row to be swapped with the current row of A is in Wmx,
+ * so copy Wmx into L1 and A.
+ */
+               locswp_copy2 op;
+               op.L = L; op.Wmx = Wmx; op.lda = lda;
+               op.A1 = Mptr( PANEL->A, II, 0, lda );
+               locswp_apply<DEPTH>( op, n0 );
+            }
+         }
+         else
+         {
+/*
+ * otherwise I do not own the current row of A, so copy the max row  Wmx
+ * into L1.
+ */
+            locswp_copy op;
+            op.L = L; op.W = Wmx;
+            locswp_apply<DEPTH>( op, n0 );
+/*
+ * and if I own the max row, overwrite it with the current row Wr0.
+ */
+            if( myrow == (int)(WORK[3]) )
+            {
+               locswp_write op2;
+               op2.A2 = Mptr( PANEL->A, II + (size_t)(WORK[1]), 0, lda );
+               op2.Wr0 = Wr0; op2.lda = lda;
+               locswp_apply<DEPTH>( op2, n0 );
+            }
+         }
+      }
+      else
+      {
+/*
+ * Otherwise the max element in the current column is zero,  simply copy
+ * the current row Wr0 into L1. The matrix is singular.
+ */
+         locswp_copy op;
+         op.L = L; op.W = Wr0;
+         locswp_apply<DEPTH>( op, n0 );
+/*
+ * Set INFO.
+ */
+         if( *(PANEL->DINFO) == 0.0 )
+            *(PANEL->DINFO) = (double)(PANEL->ia + JJ + 1);
+      }
+   }
+}
+
+extern "C" void HPL_dlocswpT
+(
+   HPL_T_panel *                    PANEL,
+   const int                        II,
+   const int                        JJ,
+   double *                         WORK
+)
+{
+/* 
+ * Purpose
+ * =======
+ *
+ * HPL_dlocswpT performs  the local swapping operations  within a panel.
+ * The lower triangular  N0-by-N0  upper block of the panel is stored in
+ * transpose form.
+ *
+ * Arguments
+ * =========
+ *
+ * PANEL   (local input/output)          HPL_T_panel *
+ *         On entry,  PANEL  points to the data structure containing the
+ *         panel information.
+ *
+ * II      (local input)                 const int
+ *         On entry, II  specifies the row offset where the column to be
+ *         operated on starts with respect to the panel.
+ *
+ * JJ      (local input)                 const int
+ *         On entry, JJ  specifies the column offset where the column to
+ *         be operated on starts with respect to the panel.
+ *
+ * WORK    (local workspace)             double *
+ *         On entry, WORK  is a workarray of size at least 2 * (4+2*N0).
+ *         WORK[0] contains  the  local  maximum  absolute value scalar,
+ *         WORK[1] contains  the corresponding local row index,  WORK[2]
+ *         contains the corresponding global row index, and  WORK[3]  is
+ *         the coordinate of process owning this max.  The N0 length max
+ *         row is stored in WORK[4:4+N0-1];  Note  that this is also the
+ *         JJth row  (or column) of L1. The remaining part of this array
+ *         is used as workspace.
+ *
+ * ---------------------------------------------------------------------
+ */ 
+START_TRACE( DLOCSWPT )
+/*
+ * The depth was validated when reading the runtime configuration.
+ */
+   switch( global_runtime_config.locswp_depth )
+   {
+      case  1: HPL_dlocswpT_impl< 1>( PANEL, II, JJ, WORK ); break;
+      case  2: HPL_dlocswpT_impl< 2>( PANEL, II, JJ, WORK ); break;
+      case  4: HPL_dlocswpT_impl< 4>( PANEL, II, JJ, WORK ); break;
+      case  8: HPL_dlocswpT_impl< 8>( PANEL, II, JJ, WORK ); break;
+      case 16: HPL_dlocswpT_impl<16>( PANEL, II, JJ, WORK ); break;
+      case 64: HPL_dlocswpT_impl<64>( PANEL, II, JJ, WORK ); break;
+      default: HPL_dlocswpT_impl<32>( PANEL, II, JJ, WORK ); break;
+   }
+END_TRACE
+/*
+ * End of HPL_dlocswpT
+ */
+}
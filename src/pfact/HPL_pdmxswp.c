@@ -59,6 +59,7 @@
  * Include files
  */
 #include "hpl.h"
+#include "util_capture.h"
 
 void HPL_pdmxswp
 (
@@ -129,6 +130,7 @@ void HPL_pdmxswp
    int                        Np2, cnt_, cnt0, i, icurrow, lda, mydist,
                               mydis_, myrow, n0, nprow, partner, rcnt,
                               root, scnt, size_;
+   CAPTURE_START
 /* ..
  * .. Executable Statements ..
  */
@@ -296,6 +298,8 @@ void HPL_pdmxswp
                           nprow ), MSGID_BEGIN_PFACT, comm );
       }
    }
+   CAPTURE_CALL( CAPTURE_PDMXSWP, 0, NULL, 0, NULL, n0, nprow, mydist,
+                 (int)(ip2), (int)(hdim), cnt_, cnt0 )
 /*
  * Save the global pivot index in pivot array
  */
@@ -60,6 +60,10 @@
 #include "hpl.h"
 #include "util_timer.h"
 #include "util_cal.h"
+#include "util_capture.h"
+#include "util_ooc.h"
+#include "util_rules.h"
+#include <unistd.h>
 #ifdef HPL_GPU_TEMPERATURE_THRESHOLD
 #include "../../caldgemm/cmodules/util_adl.h"
 #endif
@@ -204,6 +208,13 @@ int HPL_CALDGEMM_wrapper_n = -1;
 	HPL_rollT( panel, nn, U + i, LDU, iplenmod, ipmap, ipmapm1 ); \
 	VT_USER_END_A("U-BCAST Roll"); \
 	HPL_ptimer_detail2( HPL_TIMING_UBCAST );
+
+#define HPL_PDGESV_U_BINEXCH \
+	HPL_ptimer_detail2( HPL_TIMING_UBCAST ); \
+	VT_USER_START_A("U-BCAST Binary Exchange"); \
+	HPL_pdlaswp00T( panel, *ipl, ipID, nn, A + i * lda, lda, U + i, LDU ); \
+	VT_USER_END_A("U-BCAST Binary Exchange"); \
+	HPL_ptimer_detail2( HPL_TIMING_UBCAST );
 	
 #ifdef HPL_CALDGEMM_ASYNC_DTRSM_DGEMM
 int dtrtri_(char *, char *, int *, double *, int *, int *);
@@ -244,6 +255,10 @@ inline void HPL_dtrsm_GPUMOD(int jb, int nn, double* L1ptr, double* Uptr, size_t
 }
 #endif
 
+#if defined(HPL_FUSED_DLATCPY) & !defined(HPL_FUSED_DLATCPY_BLOCK)
+#define HPL_FUSED_DLATCPY_BLOCK 256
+#endif
+
 void HPL_pdgesv_swap(HPL_T_grid* Grid, HPL_T_panel* panel, int n)
 {
 	int jb = panel->jb;
@@ -258,19 +273,29 @@ void HPL_pdgesv_swap(HPL_T_grid* Grid, HPL_T_panel* panel, int n)
 	int *ipID, *iplen = NULL, *ipmap = NULL, *ipmapm1 = NULL, *iwork = NULL, *lindxA = NULL, *lindxAU = NULL, *permU = NULL;
 	int icurrow = 0, *iflag, *ipA = NULL, *ipl, k, myrow = 0, nprow;
 
-#if !defined(HPL_LOOKAHEAD_2B)
-	size_t laswp_stepsize = (HPL_CALDGEMM_gpu_height == 0 ? n : HPL_CALDGEMM_gpu_height);
-#elif defined(HPL_LOOKAHEAD_2B_FIXED_STEPSIZE)
-	size_t laswp_stepsize = HPL_LOOKAHEAD_2B_FIXED_STEPSIZE;
-#else
-	int tmp_stepsize1 = (HPL_CALDGEMM_gpu_height == 0 ? n : HPL_CALDGEMM_gpu_height);
-	int tmp_stepsize2;
-	MPI_Allreduce(&tmp_stepsize1, &tmp_stepsize2, 1, MPI_INT, MPI_MIN, Grid->col_comm);
-	size_t laswp_stepsize = tmp_stepsize2;
-#endif
+	const int lookahead_2b = global_runtime_config.lookahead_2b;
+	size_t laswp_stepsize;
+	if (!lookahead_2b)
+	{
+		laswp_stepsize = (HPL_CALDGEMM_gpu_height == 0 ? n : HPL_CALDGEMM_gpu_height);
+	}
+	else if (global_runtime_config.lookahead_2b_fixed_stepsize)
+	{
+		laswp_stepsize = global_runtime_config.lookahead_2b_fixed_stepsize;
+	}
+	else
+	{
+		int tmp_stepsize1 = (HPL_CALDGEMM_gpu_height == 0 ? n : HPL_CALDGEMM_gpu_height);
+		int tmp_stepsize2;
+		MPI_Allreduce(&tmp_stepsize1, &tmp_stepsize2, 1, MPI_INT, MPI_MIN, Grid->col_comm);
+		laswp_stepsize = tmp_stepsize2;
+	}
 	//Quick return if there is nothing to do
 	if( ( n <= 0 ) || ( jb <= 0 ) ) return;
 
+	//HPL_SWAP: binary exchange (0), spread and roll (1), or binary exchange up to HPL_SWAP_THRESHOLD columns (2)
+	const int binexch = global_runtime_config.swap == 0 || (global_runtime_config.swap == 2 && n <= global_runtime_config.swap_threshold);
+
 	if (panel->grid->nprow > 1)
 	{
 		//Initialize former pdlaswp01T
@@ -292,20 +317,30 @@ void HPL_pdgesv_swap(HPL_T_grid* Grid, HPL_T_panel* panel, int n)
 		ipmapm1 = ipmap + nprow; permU = ipmapm1 + nprow; iwork = permU + jb;
 
 		// compute index arrays
+		HPL_ptimer_detail( HPL_TIMING_PIVINDEX );
 		HPL_pipid(   panel,  ipl, ipID );
-		HPL_plindx1( panel, *ipl, ipID, ipA, lindxA, lindxAU, iplen, ipmap, ipmapm1, permU, iwork );
+		//The binary exchange only needs IPID, it leaves U in its final order
+		if (binexch) permU = NULL;
+		else HPL_plindx1( panel, *ipl, ipID, ipA, lindxA, lindxAU, iplen, ipmap, ipmapm1, permU, iwork );
+		HPL_ptimer_detail( HPL_TIMING_PIVINDEX );
 		*iflag = 1;		//signal that index array is calculated, not sure if this is needed anymore but anyway...
 		
-#ifndef HPL_LOOKAHEAD_2B
-		CALDGEMM_Wait(n + panel->jb);
+		if (!lookahead_2b)
 		{
+			CALDGEMM_Wait(n + panel->jb);
 			HPL_ptimer_detail( HPL_TIMING_PREPIPELINE );
 			const int i = 0;
 			const int nn = n;
-			HPL_PDGESV_U_BCAST
+			if (binexch)
+			{
+				HPL_PDGESV_U_BINEXCH
+			}
+			else
+			{
+				HPL_PDGESV_U_BCAST
+			}
 			HPL_ptimer_detail( HPL_TIMING_PREPIPELINE );
 		}
-#endif
 	}
 	
 	HPL_ptimer_detail( HPL_TIMING_PIPELINE );
@@ -313,10 +348,7 @@ void HPL_pdgesv_swap(HPL_T_grid* Grid, HPL_T_panel* panel, int n)
 	int nremain = n;
 	for (size_t i = 0;i < n;i += laswp_stepsize)
 	{
-#ifndef HPL_LOOKAHEAD_2B_MULTIPLIER
-#define HPL_LOOKAHEAD_2B_MULTIPLIER 3
-#endif
-		if (i) laswp_stepsize *= HPL_LOOKAHEAD_2B_MULTIPLIER;
+		if (i) laswp_stepsize *= global_runtime_config.lookahead_2b_multiplier;
 		const int nn = Mmin(nremain, laswp_stepsize);
 		nremain -= nn;
 		CALDGEMM_Wait(i + nn + panel->jb);
@@ -331,9 +363,14 @@ void HPL_pdgesv_swap(HPL_T_grid* Grid, HPL_T_panel* panel, int n)
 		}
 		else
 		{
-#ifdef HPL_LOOKAHEAD_2B
-			HPL_PDGESV_U_BCAST
-#endif
+			if (lookahead_2b && binexch)
+			{
+				HPL_PDGESV_U_BINEXCH
+			}
+			else if (lookahead_2b)
+			{
+				HPL_PDGESV_U_BCAST
+			}
 			if (permU)
 			{
 				HPL_ptimer_detail2( HPL_TIMING_LASWP );
@@ -359,6 +396,18 @@ void HPL_pdgesv_swap(HPL_T_grid* Grid, HPL_T_panel* panel, int n)
 				HPL_dtrsm2( HplColumnMajor, HplLeft, HplUpper, HplTrans, HplUnit, jb, nn, HPL_rone, L1ptr, jb, Uptr + i * LDU, LDU );
 			}
 		}
+#ifdef HPL_FUSED_DLATCPY
+		else if (myrow == icurrow)
+		{
+			//Transpose U into its final place in A block by block and solve there while the block is still in cache, the DGEMM then reads U from A
+			for (size_t ii = 0;ii < (size_t) nn;ii += HPL_FUSED_DLATCPY_BLOCK)
+			{
+				const int nnn = Mmin(nn - (int) ii, HPL_FUSED_DLATCPY_BLOCK);
+				HPL_dlatcpy( jb, nnn, Uptr + i + ii, LDU, Aptr + (i + ii) * lda, lda );
+				HPL_dtrsm2( HplColumnMajor, HplLeft, HplUpper, HplTrans, HplUnit, jb, nnn, HPL_rone, L1ptr, jb, Aptr + (i + ii) * lda, lda );
+			}
+		}
+#endif
 		else
 		{
 			HPL_dtrsm2( HplColumnMajor, HplRight, HplUpper, HplNoTrans, HplUnit, nn, jb, HPL_rone, L1ptr, jb, Uptr + i, LDU );
@@ -369,8 +418,8 @@ void HPL_pdgesv_swap(HPL_T_grid* Grid, HPL_T_panel* panel, int n)
 	}
 	HPL_ptimer_detail( HPL_TIMING_PIPELINE );
 
-#ifdef HPL_ASYNC_DLATCPY
-	if (panel->grid->nprow != 1 && panel->grid->myrow == panel->prow)
+#ifndef HPL_FUSED_DLATCPY
+	if (global_runtime_config.async_dlatcpy && panel->grid->nprow != 1 && panel->grid->myrow == panel->prow)
 	{
 		HPL_ptimer_detail( HPL_TIMING_DLATCPY );
 		VT_USER_START_A("DLATCPY");
@@ -385,8 +434,15 @@ void HPL_pdgesv_swap(HPL_T_grid* Grid, HPL_T_panel* panel, int n)
 
 int global_m_remain;
 int factorize_first_iteration = 0;
+
+//Times of panel factorization, panel broadcast and update accumulated for HPL_ADAPTIVE_NB
+static double pdgesv_adaptive_time[3] = {0., 0., 0.};
+//DGEMM flops and time of the update accumulated for HPL_REBALANCE
+static double pdgesv_rebalance_stat[2] = {0., 0.};
+
 void HPL_pdgesv_factorize(HPL_T_grid* Grid, HPL_T_panel* panel, int icurcol)
 {
+	const double adaptive_start = global_runtime_config.adaptive_nb ? HPL_ptimer_walltime() : 0.;
 	if (factorize_first_iteration)
 	{
 		global_m_remain = 1;
@@ -402,15 +458,14 @@ void HPL_pdgesv_factorize(HPL_T_grid* Grid, HPL_T_panel* panel, int icurcol)
 	{
 		HPL_pdfact(panel);    //factor current panel
 
-#ifdef HPL_COPYL_DURING_FACT
 		//Do the panel copy with the factorization to allow for multithreaded copy.
 #if !defined(HPL_USE_MPI_DATATYPE) | defined(HPL_COPY_L)
-		if (Grid->npcol > 1) HPL_copyL( panel );
-#endif
+		if (global_runtime_config.copyl_during_fact && Grid->npcol > 1) HPL_copyL( panel );
 #endif
 	}
 	fprintfctd(STD_OUT, "Factorize Ended\n");
 	if (factorize_first_iteration) global_m_remain = panel->mp;
+	if (global_runtime_config.adaptive_nb) pdgesv_adaptive_time[0] += HPL_ptimer_walltime() - adaptive_start;
 }
 
 void HPL_pdgesv_broadcast(HPL_T_grid* Grid, HPL_T_panel* panel, int icurcol)
@@ -421,10 +476,9 @@ void HPL_pdgesv_broadcast(HPL_T_grid* Grid, HPL_T_panel* panel, int icurcol)
 	long start = 0, startu = 0;
 	double bcasttime, throughput;
 #endif
+	const double adaptive_start = global_runtime_config.adaptive_nb ? HPL_ptimer_walltime() : 0.;
 
-#ifndef HPL_COPYL_DURING_FACT
-	if (Grid->npcol > 1) HPL_copyL( panel );
-#endif
+	if (!global_runtime_config.copyl_during_fact && Grid->npcol > 1) HPL_copyL( panel );
 
 	fprintfctd(STD_OUT, "Starting Broadcast\n");
 	HPL_binit(panel);
@@ -454,6 +508,7 @@ void HPL_pdgesv_broadcast(HPL_T_grid* Grid, HPL_T_panel* panel, int icurcol)
 	VT_USER_END_A("Panel-BCAST");
 	HPL_ptimer_detail(HPL_TIMING_BCAST);
 	fprintfctd(STD_OUT, "Broadcast Ended\n");
+	if (global_runtime_config.adaptive_nb) pdgesv_adaptive_time[1] += HPL_ptimer_walltime() - adaptive_start;
 #endif
 }
 
@@ -487,13 +542,18 @@ void HPL_pdupdateTT(HPL_T_grid* Grid, HPL_T_panel* PBCST, HPL_T_panel* PANEL, co
 	lda = PANEL->lda;
 	if( NN >= 0 ) n = Mmin( NN, n );
 
-	const int LDU = PANEL->grid->nprow == 1 ? lda : (n + (8 - n % 8) % 8 + (((n + (8 - n % 8) % 8) % 16) == 0) * 8);
-
 	Aptr = PANEL->A;
 	L2ptr = PANEL->L2;
 	ldl2 = PANEL->ldl2;
 	curr = ( PANEL->grid->myrow == PANEL->prow );
-	Uptr = PANEL->grid->nprow == 1 ? PANEL->A : PANEL->U;
+#ifdef HPL_FUSED_DLATCPY
+	//The current process row has U in A already, see HPL_pdgesv_swap
+	const int UinA = PANEL->grid->nprow == 1 || curr != 0;
+#else
+	const int UinA = PANEL->grid->nprow == 1;
+#endif
+	const int LDU = UinA ? lda : (n + (8 - n % 8) % 8 + (((n + (8 - n % 8) % 8) % 16) == 0) * 8);
+	Uptr = UinA ? PANEL->A : PANEL->U;
 	dpiv = PANEL->DPIV;
 	ipiv = PANEL->IWORK;
 	iroff = PANEL->ii;
@@ -524,10 +584,11 @@ void HPL_pdupdateTT(HPL_T_grid* Grid, HPL_T_panel* PBCST, HPL_T_panel* PANEL, co
 		}
 	
 		HPL_ptimer_detail( HPL_TIMING_DGEMM );
+		const double adaptive_start = (global_runtime_config.adaptive_nb || global_runtime_config.rebalance) ? HPL_ptimer_walltime() : 0.;
 		VT_USER_START_A("DGEMM");
 		int caldgemm_linpack_mode = (factorize != -1) ? (Grid->mycol == HPL_CALDGEMM_wrapper_icurcol ? 2 : 1) : 0;
 		//caldgemm_linpack_mode = 0;
-		HPL_gpu_dgemm( HplColumnMajor, HplNoTrans, PANEL->grid->nprow == 1 ? HplNoTrans : HplTrans, mp, n, jb, -HPL_rone, L2ptr, ldl2, Uptr, LDU, HPL_rone, (PANEL->grid->nprow == 1 || curr != 0) ? Mptr( Aptr, jb, 0, lda ) : Aptr, lda, caldgemm_linpack_mode, depth2 >= 3 );
+		HPL_gpu_dgemm( HplColumnMajor, HplNoTrans, UinA ? HplNoTrans : HplTrans, mp, n, jb, -HPL_rone, L2ptr, ldl2, Uptr, LDU, HPL_rone, (PANEL->grid->nprow == 1 || curr != 0) ? Mptr( Aptr, jb, 0, lda ) : Aptr, lda, caldgemm_linpack_mode, depth2 >= 3 );
 #ifdef HPL_GPU_TEMPERATURE_THRESHOLD
 #ifdef CALDGEMM_TEST
 		if (adl_temperature_check_run(&temperature, 1))
@@ -547,10 +608,16 @@ void HPL_pdupdateTT(HPL_T_grid* Grid, HPL_T_panel* PBCST, HPL_T_panel* PANEL, co
 		}
 #endif
 		VT_USER_END_A("DGEMM");
+		if (global_runtime_config.adaptive_nb) pdgesv_adaptive_time[2] += HPL_ptimer_walltime() - adaptive_start;
+		if (global_runtime_config.rebalance)
+		{
+			pdgesv_rebalance_stat[0] += 2. * (double) mp * (double) n * (double) jb;
+			pdgesv_rebalance_stat[1] += HPL_ptimer_walltime() - adaptive_start;
+		}
 		HPL_ptimer_detail( HPL_TIMING_DGEMM );
 
-#ifndef HPL_ASYNC_DLATCPY
-		if (PANEL->grid->nprow != 1 && curr != 0)
+#ifndef HPL_FUSED_DLATCPY
+		if (!global_runtime_config.async_dlatcpy && PANEL->grid->nprow != 1 && curr != 0)
 		{
 			HPL_ptimer_detail( HPL_TIMING_DLATCPY );
 			HPL_dlatcpy( jb, n, Uptr, LDU, Aptr, lda );
@@ -667,6 +734,44 @@ void HPL_pdgesv_delete_panel()
 	panel = NULL;
 }
 
+static int pdgesv_window_start = 0, pdgesv_window_end = 0;
+static int pdgesv_iterations = 0, pdgesv_iterations_max = 0;
+static int* pdgesv_iteration_n = NULL;
+static int* pdgesv_iteration_jb = NULL;
+static double* pdgesv_iteration_time = NULL;
+
+void HPL_pdgesv_window(int* start, int* end)
+{
+	//Columns processed by the last call of HPL_pdgesv
+	*start = pdgesv_window_start;
+	*end = pdgesv_window_end;
+}
+
+static void pdgesv_record_iteration(const int n, const int jb, const double time, const int estimate)
+{
+	if (pdgesv_iterations == pdgesv_iterations_max)
+	{
+		//The number of panels depends on the widths, grow the iteration arrays as needed
+		pdgesv_iterations_max = Mmax(2 * pdgesv_iterations_max, estimate);
+		pdgesv_iteration_n = (int*) realloc(pdgesv_iteration_n, pdgesv_iterations_max * sizeof(int));
+		pdgesv_iteration_jb = (int*) realloc(pdgesv_iteration_jb, pdgesv_iterations_max * sizeof(int));
+		pdgesv_iteration_time = (double*) realloc(pdgesv_iteration_time, pdgesv_iterations_max * sizeof(double));
+		if (pdgesv_iteration_n == NULL || pdgesv_iteration_jb == NULL || pdgesv_iteration_time == NULL) HPL_pabort(__LINE__, "HPL_pdgesv", "Memory allocation failed for iteration times");
+	}
+	pdgesv_iteration_n[pdgesv_iterations] = n;
+	pdgesv_iteration_jb[pdgesv_iterations] = jb;
+	pdgesv_iteration_time[pdgesv_iterations++] = time;
+}
+
+int HPL_pdgesv_iterations(const int** n, const int** jb, const double** time)
+{
+	//Remaining order, panel width and wall time of every iteration of the last call of HPL_pdgesv
+	*n = pdgesv_iteration_n;
+	*jb = pdgesv_iteration_jb;
+	*time = pdgesv_iteration_time;
+	return(pdgesv_iterations);
+}
+
 int HPL_pdgesv_get_nb(int nb, int N)
 {
 	for (int i = 0;i < global_runtime_config.hpl_nb_multiplier_count;i++)
@@ -680,12 +785,50 @@ int HPL_pdgesv_get_nb(int nb, int N)
 	return(nb);
 }
 
-void HPL_pdgesv(HPL_T_grid* GRID, HPL_T_palg* ALGO, HPL_T_pmat* A, int warmup)
+int HPL_pdgesv_get_width(const HPL_T_grid* GRID, int NB, int j, int n)
+{
+	//Width of the panel starting at column j with n columns left: the NB schedule (HPL_NB_MULTIPLIER, HPL_HALF_BLOCKING) clipped to the distribution block,
+	//so a panel never crosses a block and is owned by a single process column, and its diagonal block by a single process row
+	const int width = n <= global_runtime_config.half_blocking ? Mmax(NB / 2, 1) : HPL_pdgesv_get_nb(NB, n);
+	return(Mmin(Mmin(width, HPL_blockend(j, NB, GRID) - j), n));
+}
+
+static int pdgesv_adaptive_shift = 0, pdgesv_adaptive_panels = 0;
+
+static int HPL_pdgesv_adaptive_width(HPL_T_grid* GRID, int NB, int j, int n)
+{
+	//HPL_ADAPTIVE_NB: width of the panel starting at column j. The distribution block size NB stays fixed, so the column mapping is unchanged;
+	//the width is NB / 2^k and like in HPL_pdgesv_get_width a panel never crosses a distribution block.
+	//All processes call this for the same panels, so they reduce the measured times at the same point and agree on the width.
+	if (++pdgesv_adaptive_panels >= Mmax(global_runtime_config.adaptive_nb_interval, 1))
+	{
+		double t[3];
+		MPI_Allreduce(pdgesv_adaptive_time, t, 3, MPI_DOUBLE, MPI_MAX, GRID->all_comm);
+		const double ratio = (double) global_runtime_config.adaptive_nb_ratio / 100.;
+		const int oldshift = pdgesv_adaptive_shift;
+		if (t[2] > 0.)
+		{
+			//Panel factorization and broadcast are the critical path of the panel, shrink it if they take a large part of the update, grow it if they are hidden
+			if (t[0] + t[1] > ratio * t[2] && (NB >> (pdgesv_adaptive_shift + 1)) >= Mmax(global_runtime_config.adaptive_nb, 1)) pdgesv_adaptive_shift++;
+			else if (t[0] + t[1] < 0.5 * ratio * t[2] && pdgesv_adaptive_shift > 0) pdgesv_adaptive_shift--;
+		}
+		if (pdgesv_adaptive_shift != oldshift && GRID->myrow == 0 && GRID->mycol == 0)
+		{
+			fprintf(STD_OUT, "HPL_ADAPTIVE_NB: panel width %d from col %d (factorization %2.3lf s, broadcast %2.3lf s, update %2.3lf s)\n", NB >> pdgesv_adaptive_shift, j, t[0], t[1], t[2]);
+		}
+		pdgesv_adaptive_time[0] = pdgesv_adaptive_time[1] = pdgesv_adaptive_time[2] = 0.;
+		pdgesv_adaptive_panels = 0;
+	}
+	return(Mmin(Mmin(NB >> pdgesv_adaptive_shift, HPL_blockend(j, NB, GRID) - j), n));
+}
+
+void HPL_pdgesv(HPL_T_grid* GRID, HPL_T_palg* ALGO, HPL_T_pmat* A, int warmup, int jstart, int jend)
 {
 	//.. Local Variables ..
 	HPL_T_panel *p;
 	int N, depth1, depth2, icurcol, j, jb, mycol, n, nb, nn, nq, tag=MSGID_BEGIN_FACT;
 	int depth1init;
+	int nq0, ooc_upto;
 #ifdef HPL_PRINT_INTERMEDIATE
 	uint64_t total_gflop;
 	uint64_t time_start;
@@ -698,7 +841,6 @@ void HPL_pdgesv(HPL_T_grid* GRID, HPL_T_palg* ALGO, HPL_T_pmat* A, int warmup)
 
 	N = A->n;
 	nb = A->nb;
-	nb = HPL_pdgesv_get_nb(nb, N);
 
 	depth1 = (ALGO->depth >= 1);
 	depth2 = ALGO->depth;
@@ -710,62 +852,64 @@ void HPL_pdgesv(HPL_T_grid* GRID, HPL_T_palg* ALGO, HPL_T_pmat* A, int warmup)
 
 	nq = HPL_numcol(N+1, nb, mycol, GRID);
 	nn = N;
+	nq0 = nq;
+	ooc_upto = 0;
 
 	//Create initial panel(s)
-	HPL_pdpanel_new(GRID, ALGO, nn, nn+1, Mmin(nn, nb), nb, A, 0, 0, tag, &panel[depth1]);
+	jb = HPL_pdgesv_get_width(GRID, nb, 0, nn);
+	HPL_pdpanel_new(GRID, ALGO, nn, nn+1, jb, nb, A, 0, 0, tag, &panel[depth1]);
 	if (depth1)
 	{
-		HPL_pdpanel_new(GRID, ALGO, nn, nn+1, Mmin(nn, nb), nb, A, 0, 0, MSGID_BEGIN_FACT, &panel[0]);
+		HPL_pdpanel_new(GRID, ALGO, nn, nn+1, jb, nb, A, 0, 0, MSGID_BEGIN_FACT, &panel[0]);
 	}
 	depth1init = depth1;
 
 	tag = MNxtMgid(tag, MSGID_BEGIN_FACT, MSGID_END_FACT);
 	
-#ifdef HPL_START_PERCENTAGE
-	double fullwork = N;
-	fullwork = fullwork * fullwork * fullwork;
-	fullwork *= 1.0 - (double) HPL_START_PERCENTAGE / 100.0;
-	fullwork = pow(fullwork, 1.0 / 3.0);
-	int startrow = N - fullwork;
-	if (startrow < 0) startrow = 0;
-	startrow -= startrow % (GRID->npcol * nb);
-	if( GRID->myrow == 0 && GRID->mycol == 0 )
+	//Partial run: start at the process column boundary at or before jstart, stop after the panel containing column jend - 1
+	int startrow = Mmin(Mmax(jstart, 0), N - 1);
+	startrow = HPL_blockstart(startrow - startrow % (GRID->npcol * nb), nb, GRID);
+	const int endrow = (jend > 0 && jend < N) ? jend : N;
+	if (startrow && GRID->myrow == 0 && GRID->mycol == 0)
 	{
 	    fprintf(STD_OUT, "Starting at col %d which corresponds to approx %2.1lf %% of execution time\n", startrow, 100.0 * (double) (N - startrow) * (double) (N - startrow) * (double) (N - startrow) / (double) N / (double) N / (double) N);
 	}
-#else
-	const int startrow = 0;
-#endif
+	pdgesv_iterations = 0;
 	
-	//Main loop over the columns of A
-	for(j = startrow; j < N; j += nb)
+	int iteration = 0;
+	HPL_rules_begin(ALGO);
+	pdgesv_adaptive_shift = pdgesv_adaptive_panels = 0;
+	pdgesv_adaptive_time[0] = pdgesv_adaptive_time[1] = pdgesv_adaptive_time[2] = 0.;
+	pdgesv_window_start = pdgesv_window_end = startrow;
+	pdgesv_rebalance_stat[0] = pdgesv_rebalance_stat[1] = 0.;
+	if (!warmup) HPL_pdrebalance_begin();
+	//restart: the lookahead was stopped for HPL_REBALANCE, start again like in the first iteration
+	int restart = 0;
+	//tailstart: first column of the trailing matrix left for HPL_pdtail
+	int tailstart = 0;
+
+	//Main loop over the columns of A, nb stays the distribution block size and jb is the panel width
+	for(j = startrow; j < endrow; j += jb)
 	{
-#ifdef HPL_END_N
-		if (j >= HPL_END_N) break;
-#endif
+		const double iteration_start = HPL_ptimer_walltime();
 		icurcol = MColToPCol(j, nb, GRID);
 		n = N - j;
-		nb = depth1 ? panel[1]->nb : HPL_pdgesv_get_nb(A->nb, n);
-#ifdef HPL_HALF_BLOCKING
-		if (n <= HPL_HALF_BLOCKING)
-		{
-			if (depth1 || global_runtime_config.hpl_nb_multiplier_count)
-			{
-				fprintf(STD_OUT, "HPL_HALF_BLOCKING must not be used while lookahead is not 0, and if hpl_nb_multiplier is used!\n");
-				exit(1);
-			}
-			nb = A->nb / 2;
-		}
-#endif
 #ifdef HPL_CUSTOM_PARAMETER_CHANGE
 		HPL_CUSTOM_PARAMETER_CHANGE
 #endif
-		jb = Mmin(n, nb);
+		HPL_rules_apply(ALGO, iteration++, j, n, HPL_numrowI(n, j, nb, GRID->myrow, GRID->nprow, GRID));
+		if (depth1 && j != startrow && !restart) jb = panel[1]->jb;
+		else jb = global_runtime_config.adaptive_nb ? HPL_pdgesv_adaptive_width(GRID, nb, j, n) : HPL_pdgesv_get_width(GRID, nb, j, n);
 #ifdef HPL_DETAILED_TIMING
 		fprintfct(STD_OUT, "Iteration j=%d N=%d n=%d jb=%d Totaltime=%2.3lf\n", j, N, n, jb, HPL_ptimer_inquire( HPL_WALL_PTIME, HPL_TIMING_ITERATION ));
 #else
 		fprintfct(STD_OUT, "Iteration j=%d N=%d n=%d jb=%d\n", j, N, n, jb);
 #endif
+		if (util_capture_enabled)
+		{
+			const int capture_args[] = {j, n, jb};
+			captureCall(CAPTURE_ITERATION, util_captureTimestamp(), 3, capture_args, 0, NULL, 0, NULL);
+		}
 
 #if defined(HPL_PRINT_INTERMEDIATE)
 		// there are still n rows to compute
@@ -776,26 +920,49 @@ void HPL_pdgesv(HPL_T_grid* GRID, HPL_T_palg* ALGO, HPL_T_pmat* A, int warmup)
 			uint64_t gFlop = total_gflop - todo_gflop;
 			float ratio = (float) gFlop / total_gflop;
 
-#ifdef HPL_PAUSE
-			HPL_fprintf( STD_OUT, "%.f %% (j = %d/%d) of factorization.\n", ratio * 100, j, N );
-#else
-			float modifier = ratio * ratio * ratio * ratio;
-			modifier = 1. - modifier;
-			modifier = 1. + 0.1 * modifier;
-
-			uint64_t time_now = util_getTimestamp();
-			float seconds = (float) util_getTimeDifference( time_start, time_now ) / 1e6;
-			float flops = (float) gFlop / (float) seconds / modifier;
-			uint64_t eta = (seconds / ratio - seconds) * modifier;
-			HPL_fprintf( STD_OUT, "%.f %% (j = %d/%d) of factorization at approx. %.2f Gflops, assuming to finish in %ld s.\n", ratio * 100, j, N, flops, eta );
-#endif
+			if (global_runtime_config.pause)
+			{
+				HPL_fprintf( STD_OUT, "%.f %% (j = %d/%d) of factorization.\n", ratio * 100, j, N );
+			}
+			else
+			{
+				float modifier = ratio * ratio * ratio * ratio;
+				modifier = 1. - modifier;
+				modifier = 1. + 0.1 * modifier;
+
+				uint64_t time_now = util_getTimestamp();
+				float seconds = (float) util_getTimeDifference( time_start, time_now ) / 1e6;
+				float flops = (float) gFlop / (float) seconds / modifier;
+				uint64_t eta = (seconds / ratio - seconds) * modifier;
+				HPL_fprintf( STD_OUT, "%.f %% (j = %d/%d) of factorization at approx. %.2f Gflops, assuming to finish in %ld s.\n", ratio * 100, j, N, flops, eta );
+			}
 		}
 #endif /* HPL_PRINT_INTERMEDIATE */
 
 		//Initialize current panel
 		HPL_ptimer_detail( HPL_TIMING_ITERATION );
 
-		if (j == startrow || depth1 == 0)
+		if (HPL_ooc_active())
+		{
+			//Out-of-core: extend the read-ahead window, then wait until the block columns of the current and the lookahead panel are resident
+			const int ltrail = nq0 - nq;
+			const int window = Mmin(nq0, ltrail + Mmax(global_runtime_config.ooc_window, 1) * nb);
+			for (ooc_upto = Mmax(ooc_upto, ltrail);ooc_upto < window;ooc_upto += nb)
+			{
+				HPL_ooc_prefetch(Mptr(A->A, 0, ooc_upto, A->ld), (size_t) A->ld * Mmin(nb, window - ooc_upto) * sizeof(double));
+			}
+			HPL_ptimer_detail( HPL_TIMING_OOCWAIT );
+			HPL_ooc_wait(Mptr(A->A, 0, Mmin(nq0, ltrail + 2 * nb), A->ld));
+			HPL_ptimer_detail( HPL_TIMING_OOCWAIT );
+		}
+
+		//HPL_REBALANCE: after this iteration the columns from j + jb on may change their process column, so the lookahead panel is not factorized
+		const int rebalance = global_runtime_config.rebalance && !warmup && iteration == global_runtime_config.rebalance && j + jb < endrow;
+		//HPL_TAIL_GATHER: this is the last distributed panel, the trailing matrix from j + jb on is factorized on a single process
+		const int tail = global_runtime_config.tail_gather && !warmup && endrow == N && j + jb < N && N - (j + jb) <= global_runtime_config.tail_gather;
+		const int nolookahead = rebalance || tail;
+
+		if (j == startrow || depth1 == 0 || restart)
 		{
 			HPL_pdpanel_free(panel[depth1]);
 			HPL_pdpanel_init(GRID, ALGO, n, n + 1, jb, nb, A, j, j, tag, panel[depth1]);
@@ -807,11 +974,12 @@ void HPL_pdgesv(HPL_T_grid* GRID, HPL_T_palg* ALGO, HPL_T_pmat* A, int warmup)
 		
 		tag = MNxtMgid(tag, MSGID_BEGIN_FACT, MSGID_END_FACT);
 		
-		if (depth1 && j + nb < N)
+		restart = 0;
+		if (depth1 && j + jb < N && !nolookahead)
 		{
 			HPL_pdpanel_free(panel[0]);
-			int depth1nb = HPL_pdgesv_get_nb(A->nb, n - nb);
-			HPL_pdpanel_init(GRID, ALGO, n - nb, n - nb + 1, Mmin(n - depth1nb, depth1nb), depth1nb, A, j + nb, j + nb, tag, panel[0]);
+			const int depth1jb = global_runtime_config.adaptive_nb ? HPL_pdgesv_adaptive_width(GRID, nb, j + jb, n - jb) : HPL_pdgesv_get_width(GRID, nb, j + jb, n - jb);
+			HPL_pdpanel_init(GRID, ALGO, n - jb, n - jb + 1, depth1jb, nb, A, j + jb, j + jb, tag, panel[0]);
 		}
 		
 		nn = (mycol == icurcol) ? HPL_numcolI(jb, j, nb, mycol, GRID) : 0;
@@ -819,15 +987,21 @@ void HPL_pdgesv(HPL_T_grid* GRID, HPL_T_palg* ALGO, HPL_T_pmat* A, int warmup)
 		//Finish the latest update and broadcast the current panel
 
 		int olddepth1 = depth1;
-		if (global_runtime_config.disable_lookahead && n <= global_runtime_config.disable_lookahead + nb + 1)
+		if (global_runtime_config.disable_lookahead && n <= global_runtime_config.disable_lookahead + jb + 1)
 		{
 			depth1 = depth2 = 0;
 		}
-		HPL_pdupdateTT(GRID, panel[0], panel[olddepth1], nq-nn, (depth1 && j + nb < N) ? MColToPCol(j + nb, nb, GRID) : -1, depth2);
+		else if (depth1 && HPL_rules_lookahead() >= 0)
+		{
+			//A rule can reduce the lookahead depth, once switched off it stays off like with HPL_DISABLE_LOOKAHEAD
+			depth2 = Mmin(ALGO->depth, HPL_rules_lookahead());
+			if (depth2 == 0) depth1 = 0;
+		}
+		HPL_pdupdateTT(GRID, panel[0], panel[olddepth1], nq-nn, (depth1 && j + jb < N && !nolookahead) ? MColToPCol(j + jb, nb, GRID) : -1, depth2);
 
 		HPL_ptimer_detail( HPL_TIMING_ITERATION );
 		//Switch panel pointers
-		if (depth1)
+		if (depth1 && !nolookahead)
 		{
 			p = panel[0];
 			panel[0] = panel[1];
@@ -836,17 +1010,36 @@ void HPL_pdgesv(HPL_T_grid* GRID, HPL_T_palg* ALGO, HPL_T_pmat* A, int warmup)
 
 		if(mycol == icurcol)
 		{
+			//The block column of the current panel is final, write it back and release it
+			if (HPL_ooc_active()) HPL_ooc_evict(Mptr(A->A, 0, nq0 - nq, A->ld), (size_t) A->ld * jb * sizeof(double));
 			nq -= jb;
 		}
 
-#ifdef HPL_PAUSE
-		HPL_ptimer( 0 );
-		const int pause_duration = (int) ((double) HPL_PAUSE * (double) n * (double) n / (double) N / (double) N * 1000000.);
-		fprintf(STD_OUT, "HPL_PAUSE: Sleeping for %d usec\n", pause_duration);
-		usleep(pause_duration);
-		HPL_ptimer( 0 );
-#endif
+		if (rebalance)
+		{
+			//The update must be complete before block columns move
+			CALDGEMM_Finish();
+			if (HPL_pdrebalance(GRID, A, j + jb, pdgesv_rebalance_stat[0], pdgesv_rebalance_stat[1])) nq = HPL_numcolI(N + 1 - (j + jb), j + jb, nb, mycol, GRID);
+			restart = depth1;
+		}
+
+		pdgesv_record_iteration(n, jb, HPL_ptimer_walltime() - iteration_start, (N - startrow) / nb + 2);
+
+		if (global_runtime_config.pause)
+		{
+			HPL_ptimer( 0 );
+			const int pause_duration = (int) (global_runtime_config.pause * (double) n * (double) n / (double) N / (double) N * 1000000.);
+			fprintf(STD_OUT, "HPL_PAUSE: Sleeping for %d usec\n", pause_duration);
+			usleep(pause_duration);
+			HPL_ptimer( 0 );
+		}
+		pdgesv_window_end = j + jb;
 		if (warmup) break;
+		if (tail)
+		{
+			tailstart = j + jb;
+			break;
+		}
 	}
 	//Clean-up: Release panels and panel list
 	if(depth1init)
@@ -856,10 +1049,19 @@ void HPL_pdgesv(HPL_T_grid* GRID, HPL_T_palg* ALGO, HPL_T_pmat* A, int warmup)
 	HPL_pdpanel_disp(&panel[0]);
 
 	CALDGEMM_Finish();
+	HPL_rules_end(ALGO);
+	HPL_pdlaswp00T_free();
 	if (warmup) return;
+
+	if (tailstart)
+	{
+		//The gathered tail counts as one iteration over the remaining columns, the run then covers the matrix up to N
+		const double tail_start = HPL_ptimer_walltime();
+		HPL_pdtail(GRID, A, tailstart);
+		pdgesv_record_iteration(N - tailstart, N - tailstart, HPL_ptimer_walltime() - tail_start, pdgesv_iterations + 1);
+		pdgesv_window_end = N;
+	}
 	
 	//Solve upper triangular system
-#if !defined(HPL_END_N) & !defined(HPL_START_PERCENTAGE)
-	if( A->info == 0 ) HPL_pdtrsv( GRID, A );
-#endif
+	if( A->info == 0 && startrow == 0 && endrow == N ) HPL_pdtrsv( GRID, A );
 }
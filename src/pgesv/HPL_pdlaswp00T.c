@@ -0,0 +1,209 @@
+/**
+ * Row interchanges and broadcast of U by binary exchange
+ *
+ * Copyright 2010:
+ *  - David Rohr (drohr@jwdt.org)
+ *  - Matthias Bach (bach@compeng.uni-frankfurt.de)
+ *  - Matthias Kretz (kretz@compeng.uni-frankfurt.de)
+ *
+ * This file is part of HPL-GPU.
+ *
+ * HPL-GPU is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * HPL-GPU is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with HPL-GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition to the rules layed out by the GNU General Public License
+ * the following exception is granted:
+ *
+ * Use with the Original BSD License.
+ *
+ * Notwithstanding any other provision of the GNU General Public License
+ * Version 3, you have permission to link or combine any covered work with
+ * a work licensed under the 4-clause BSD license into a single combined
+ * work, and to convey the resulting work.  The terms of this License will
+ * continue to apply to the part which is the covered work, but the special
+ * requirements of the 4-clause BSD license, clause 3, concerning the
+ * requirement of acknowledgement in advertising materials will apply to
+ * the combination as such.
+ */
+
+/*
+ * Include files
+ */
+#include "hpl.h"
+
+/*
+ * HPL_SWAP selects how the row interchanges of a panel are applied to the
+ * trailing matrix and U is broadcast within the process columns, like the
+ * SWAP line of the original HPL.dat: 1 (long) spreads U from the current
+ * process row, swaps locally and rolls the pieces around the ring
+ * (HPL_spreadT / HPL_rollT), 0 (binary exchange) combines the rows of U
+ * in log2(P) exchanges of the whole buffer (HPL_pdlaswp00T), and 2 (mix)
+ * takes the binary exchange while the local trailing matrix has at most
+ * HPL_SWAP_THRESHOLD columns and the long variant otherwise. The binary
+ * exchange moves more data but needs fewer messages, it pays off for
+ * small updates and few process rows.
+ */
+
+static double* pdlaswp00T_buffers[2] = {NULL, NULL};
+static size_t pdlaswp00T_sizes[2] = {0, 0};
+
+static double* pdlaswp00T_buffer(const int M, const int WHICH)
+{
+	//Two work buffers of at least M doubles, only grown, HPL_pdgesv releases them with HPL_pdlaswp00T_free
+	double** buffer = pdlaswp00T_buffers;
+	size_t* size = pdlaswp00T_sizes;
+	if ((size_t) M > size[WHICH])
+	{
+		if (buffer[WHICH]) free(buffer[WHICH]);
+		buffer[WHICH] = (double*) malloc((size_t) M * sizeof(double));
+		if (buffer[WHICH] == NULL) HPL_pabort(__LINE__, "HPL_pdlaswp00T", "Memory allocation failed");
+		size[WHICH] = M;
+	}
+	return(buffer[WHICH]);
+}
+
+size_t HPL_pdlaswp00T_memory(HPL_T_grid* GRID, const int N, const int NB)
+{
+	//Peak size of the two work buffers: up to 2 jb rows of the local trailing columns each, the first panel is the widest
+	if (global_runtime_config.swap == 1 || GRID->nprow == 1 || N <= 0) return(0);
+	const size_t jb = HPL_pdgesv_get_width(GRID, NB, 0, N);
+	size_t nq = HPL_numcol(N, NB, GRID->mycol, GRID) + 1;
+	if (global_runtime_config.swap == 2 && nq > (size_t) global_runtime_config.swap_threshold) nq = global_runtime_config.swap_threshold;
+	return(2 * (2 * jb) * nq * sizeof(double));
+}
+
+void HPL_pdlaswp00T_free()
+{
+	for (int i = 0;i < 2;i++)
+	{
+		if (pdlaswp00T_buffers[i]) free(pdlaswp00T_buffers[i]);
+		pdlaswp00T_buffers[i] = NULL;
+		pdlaswp00T_sizes[i] = 0;
+	}
+}
+
+static void pdlaswp00T_merge(const HPL_T_panel* PANEL, const int K, const int* IPID, const int NN, double* W, const double* T, const int PART, const int MASK, const int FOLD)
+{
+	//Take the rows of the partner buffer T whose owner, relative to the current process row and with FOLD folded into [0..ip2),
+	//agrees with PART in all bits above MASK
+	const HPL_T_grid* grid = PANEL->grid;
+	const int nprow = grid->nprow, nb = PANEL->nb, ip2 = grid->row_ip2;
+	for (int r = 0;r < K >> 1;r++)
+	{
+		int owner;
+		Mindxg2p_row(IPID[2 * r], nb, nb, owner, nprow, grid);
+		owner = MModSub(owner, PANEL->prow, nprow);
+		if (FOLD && owner >= ip2) owner -= ip2;
+		if ((owner | MASK) == (PART | MASK)) memcpy(W + (size_t) r * NN, T + (size_t) r * NN, NN * sizeof(double));
+	}
+}
+
+void HPL_pdlaswp00T
+(
+   HPL_T_panel *                    PANEL,
+   const int                        K,
+   const int *                      IPID,
+   const int                        NN,
+   double *                         A,
+   const int                        LDA,
+   double *                         U,
+   const int                        LDU
+)
+{
+/*
+ * Purpose
+ * =======
+ *
+ * HPL_pdlaswp00T applies the row interchanges of PANEL to NN columns of
+ * the trailing matrix and broadcasts the corresponding NN columns of U
+ * in the process column by binary exchange. IPID of length K is computed
+ * by HPL_pipid: the first  jb  pairs bring the rows of U in place, the
+ * remaining ones move the rows of the diagonal block they replace.
+ *
+ * Every process row packs the rows of U it owns, and the current process
+ * row in addition the rows of the diagonal block that leave it, into one
+ * buffer of jb + K/2 - jb rows of NN entries. The buffers are combined in
+ * a hypercube over the largest power of two  ip2 <= nprow  of the process
+ * rows relative to the current one,  the  remaining  process  rows  hand
+ * their rows to a partner first and get the combined buffer at the end.
+ * All process rows then hold U in its final row order, no permutation of
+ * U follows, and write the rows that leave the diagonal block into their
+ * place in A.
+ *
+ * A and U point to the first of the NN columns in the local trailing
+ * matrix and in the transposed U of leading dimension LDU.
+ *
+ * ---------------------------------------------------------------------
+ */
+	HPL_T_grid* grid = PANEL->grid;
+	const int jb = PANEL->jb, nb = PANEL->nb, ii = PANEL->ii;
+	const int nprow = grid->nprow, myrow = grid->myrow, icurrow = PANEL->prow;
+	const int ip2 = grid->row_ip2, hdim = grid->row_hdim;
+	const int rows = K >> 1, mydist = MModSub(myrow, icurrow, nprow);
+	MPI_Comm comm = grid->col_comm;
+
+	if (NN <= 0) return;
+	double* W = pdlaswp00T_buffer(rows * NN, 0);
+	double* T = pdlaswp00T_buffer(rows * NN, 1);
+
+	//Pack the rows this process row contributes, IPID holds the source row of every buffer row
+	for (int r = 0;r < rows;r++)
+	{
+		int owner, il;
+		Mindxg2p_row(IPID[2 * r], nb, nb, owner, nprow, grid);
+		if (owner != myrow) continue;
+		Mindxg2l_row(il, IPID[2 * r], nb, nb, myrow, nprow, grid);
+		HPL_dcopy(NN, Mptr(A, il - ii, 0, LDA), LDA, W + (size_t) r * NN, 1);
+	}
+
+	const int partner2 = mydist ^ ip2;
+	if (mydist >= ip2)
+	{
+		(void) HPL_send(W, rows * NN, MModAdd(partner2, icurrow, nprow), MSGID_BEGIN_PFACT, comm);
+	}
+	else if (partner2 < nprow)
+	{
+		(void) HPL_recv(T, rows * NN, MModAdd(partner2, icurrow, nprow), MSGID_BEGIN_PFACT, comm);
+		pdlaswp00T_merge(PANEL, K, IPID, NN, W, T, partner2, 0, 0);
+	}
+
+	if (mydist < ip2)
+	{
+		for (int k = 0;k < hdim;k++)
+		{
+			const int partner = mydist ^ (1 << k);
+			(void) HPL_sdrv(W, rows * NN, MSGID_BEGIN_PFACT, T, rows * NN, MSGID_BEGIN_PFACT, MModAdd(partner, icurrow, nprow), comm);
+			pdlaswp00T_merge(PANEL, K, IPID, NN, W, T, partner, (1 << k) - 1, 1);
+		}
+	}
+
+	if (mydist >= ip2)
+	{
+		(void) HPL_recv(W, rows * NN, MModAdd(partner2, icurrow, nprow), MSGID_BEGIN_PFACT, comm);
+	}
+	else if (partner2 < nprow)
+	{
+		(void) HPL_send(W, rows * NN, MModAdd(partner2, icurrow, nprow), MSGID_BEGIN_PFACT, comm);
+	}
+
+	//U in its final order, then the rows that left the diagonal block into their place in A
+	for (int r = 0;r < jb;r++) memcpy(U + (size_t) r * LDU, W + (size_t) r * NN, NN * sizeof(double));
+	for (int r = jb;r < rows;r++)
+	{
+		int owner, il;
+		Mindxg2p_row(IPID[2 * r + 1], nb, nb, owner, nprow, grid);
+		if (owner != myrow) continue;
+		Mindxg2l_row(il, IPID[2 * r + 1], nb, nb, myrow, nprow, grid);
+		HPL_dcopy(NN, W + (size_t) r * NN, 1, Mptr(A, il - ii, 0, LDA), LDA);
+	}
+}
@@ -0,0 +1,229 @@
+/**
+ * Migration of block columns between heterogeneous process columns
+ *
+ * Copyright 2010:
+ *  - David Rohr (drohr@jwdt.org)
+ *  - Matthias Bach (bach@compeng.uni-frankfurt.de)
+ *  - Matthias Kretz (kretz@compeng.uni-frankfurt.de)
+ *
+ * This file is part of HPL-GPU.
+ *
+ * HPL-GPU is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * HPL-GPU is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with HPL-GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition to the rules layed out by the GNU General Public License
+ * the following exception is granted:
+ *
+ * Use with the Original BSD License.
+ *
+ * Notwithstanding any other provision of the GNU General Public License
+ * Version 3, you have permission to link or combine any covered work with
+ * a work licensed under the 4-clause BSD license into a single combined
+ * work, and to convey the resulting work.  The terms of this License will
+ * continue to apply to the part which is the covered work, but the special
+ * requirements of the 4-clause BSD license, clause 3, concerning the
+ * requirement of acknowledgement in advertising materials will apply to
+ * the combination as such.
+ */
+
+/*
+ * Include files
+ */
+#include "hpl.h"
+#include <float.h>
+
+/*
+ * HPL_REBALANCE: HPL_pdgesv measures the DGEMM throughput of the update
+ * during its first iterations. The slowest process row determines the
+ * throughput of a process column. If the remaining columns would take
+ * the slowest process column more than HPL_REBALANCE_THRESHOLD percent
+ * longer than with a distribution by throughput, the NB blocks not
+ * factored yet are mapped again with the measured throughput as weights
+ * (HPL_colmapping) and the block columns are sent to their new process
+ * columns. The blocks before stay where they are, so only the local
+ * offsets of the remaining blocks change.
+ */
+
+static float* pdrebalance_weights = NULL;
+static int pdrebalance_measured = 0, pdrebalance_applied = 0;
+
+void HPL_pdrebalance_begin()
+{
+	//Forget the throughput of the last run
+	pdrebalance_measured = pdrebalance_applied = 0;
+}
+
+int HPL_pdrebalance_weights(const float** WEIGHTS)
+{
+	//Throughput of the process columns relative to the fastest one measured in the last run, NULL if none was measured.
+	//Returns nonzero if the block columns were migrated.
+	*WEIGHTS = pdrebalance_measured ? pdrebalance_weights : NULL;
+	return(pdrebalance_applied);
+}
+
+static void HPL_pdrebalance_move(double* A, const int LD, const int MP, const int TO, const int FROM, const int W)
+{
+	//Move W local columns from column FROM to column TO, the ranges may overlap
+	if (TO < FROM) for (int c = 0;c < W;c++) memcpy(Mptr(A, 0, TO + c, LD), Mptr(A, 0, FROM + c, LD), MP * sizeof(double));
+	else for (int c = W - 1;c >= 0;c--) memcpy(Mptr(A, 0, TO + c, LD), Mptr(A, 0, FROM + c, LD), MP * sizeof(double));
+}
+
+int HPL_pdrebalance(HPL_T_grid* GRID, HPL_T_pmat* A, const int J, const double FLOPS, const double TIME)
+{
+	//Called by all processes after the update of the panel ending at column J, FLOPS and TIME are the DGEMM flops and time of this process so far.
+	//Returns nonzero if the mapping of the columns from J on changed.
+	const int npcol = GRID->npcol, mycol = GRID->mycol, nb = A->nb, N = A->n, mp = A->mp, ld = A->ld;
+	const int mcols = (N + nb) / nb;
+	const int first = (HPL_blockstart(J, nb, GRID) == J ? J : HPL_blockend(J, nb, GRID)) / nb;
+	if (npcol == 1 || first >= mcols) return(0);
+
+	double rate = (FLOPS > 0. && TIME > 0.) ? FLOPS / TIME : DBL_MAX, maxrate = 0.;
+	MPI_Allreduce(MPI_IN_PLACE, &rate, 1, MPI_DOUBLE, MPI_MIN, GRID->col_comm);
+	double* rates = (double*) malloc(npcol * sizeof(double));
+	int* cap = (int*) malloc(npcol * sizeof(int));
+	int* count = (int*) malloc(npcol * sizeof(int));
+	int* mapping = (int*) malloc(mcols * sizeof(int));
+	if (rates == NULL || cap == NULL || count == NULL || mapping == NULL) HPL_pabort(__LINE__, "HPL_pdrebalance", "Memory allocation failed");
+	MPI_Allgather(&rate, 1, MPI_DOUBLE, rates, 1, MPI_DOUBLE, GRID->row_comm);
+	MPI_Allgather(&A->nq, 1, MPI_INT, cap, 1, MPI_INT, GRID->row_comm);
+
+	pdrebalance_weights = (float*) realloc(pdrebalance_weights, npcol * sizeof(float));
+	int valid = 1;
+	for (int q = 0;q < npcol;q++)
+	{
+		if (rates[q] == DBL_MAX) valid = 0;
+		else if (rates[q] > maxrate) maxrate = rates[q];
+	}
+	for (int q = 0;q < npcol;q++) pdrebalance_weights[q] = valid ? rates[q] / maxrate : 1.f;
+	pdrebalance_measured = valid;
+
+	//Time of the remaining columns of every process column relative to the distribution by throughput
+	double imbalance = 0., remaining = 0., total = 0.;
+	for (int q = 0;q < npcol;q++)
+	{
+		remaining += GRID->col_count[mcols * npcol + q] - GRID->col_count[first * npcol + q];
+		total += rates[q];
+	}
+	for (int q = 0;valid && q < npcol;q++)
+	{
+		imbalance = Mmax(imbalance, (GRID->col_count[mcols * npcol + q] - GRID->col_count[first * npcol + q]) / rates[q] / (remaining / total) - 1.);
+	}
+
+	int fail = !valid || imbalance * 100. <= global_runtime_config.rebalance_threshold;
+	if (!fail)
+	{
+		//Every process column keeps one column for b or the workspace of HPL_pdtrsv
+		for (int q = 0;q < npcol;q++) cap[q] -= GRID->col_count[first * npcol + q] + 1;
+		for (int i = 0;i < first;i++) mapping[i] = GRID->col_mapping[i];
+		fail = HPL_colmapping(STD_OUT, GRID, N, nb, pdrebalance_weights, first, cap, mapping, count) ? 2 : 0;
+	}
+	int moved = 0;
+	for (int i = first;!fail && i < mcols;i++) if (mapping[i] != GRID->col_mapping[i]) moved++;
+	if (!fail && moved == 0) fail = 3;
+	if (GRID->myrow == 0 && mycol == 0)
+	{
+		if (!valid) fprintf(STD_OUT, "HPL_REBALANCE: no throughput measured, mapping kept\n");
+		else if (fail == 1) fprintf(STD_OUT, "HPL_REBALANCE: imbalance %2.1lf %% from col %d, mapping kept\n", 100. * imbalance, first * nb);
+		else if (fail == 2) fprintf(STD_OUT, "HPL_REBALANCE: imbalance %2.1lf %% from col %d, columns do not fit into HPL_REBALANCE_RESERVE, mapping kept\n", 100. * imbalance, first * nb);
+		else if (fail == 3) fprintf(STD_OUT, "HPL_REBALANCE: imbalance %2.1lf %% from col %d, no block column can move, mapping kept\n", 100. * imbalance, first * nb);
+	}
+	if (fail)
+	{
+		free(rates);
+		free(cap);
+		free(count);
+		free(mapping);
+		return(0);
+	}
+
+	//Switch to the new mapping, keep the old one for the local offsets of the blocks
+	int* oldmapping = GRID->col_mapping;
+	int* oldcount = GRID->col_count;
+	GRID->col_mapping = mapping;
+	GRID->col_count = (int*) malloc((mcols + 1) * npcol * sizeof(int));
+	if (GRID->col_count == NULL) HPL_pabort(__LINE__, "HPL_pdrebalance", "Memory allocation failed");
+	HPL_colmapping_tables(GRID, N, nb);
+	for (int q = 0;q < npcol;q++) GRID->mcols_per_pcol[q] = GRID->col_count[mcols * npcol + q] / nb;
+
+	//Send the leaving blocks from the matrix and stage the arriving ones, the processes of a process row exchange the same rows
+	int nreq = 0, recvcols = 0;
+	for (int i = first;i < mcols;i++)
+	{
+		if (oldmapping[i] != mapping[i] && (oldmapping[i] == mycol || mapping[i] == mycol)) nreq++;
+		if (oldmapping[i] != mapping[i] && mapping[i] == mycol) recvcols += Mmin(nb, N + 1 - i * nb);
+	}
+	MPI_Request* req = (MPI_Request*) malloc(Mmax(nreq, 1) * sizeof(MPI_Request));
+	double* buffer = (double*) malloc(Mmax((size_t) recvcols * mp, 1) * sizeof(double));
+	if (req == NULL || buffer == NULL) HPL_pabort(__LINE__, "HPL_pdrebalance", "Memory allocation failed");
+	nreq = recvcols = 0;
+	for (int i = first;i < mcols;i++)
+	{
+		const int w = Mmin(nb, N + 1 - i * nb);
+		if (oldmapping[i] == mapping[i] || mp == 0) continue;
+		if (oldmapping[i] == mycol)
+		{
+			MPI_Datatype type;
+			MPI_Type_vector(w, mp, ld, MPI_DOUBLE, &type);
+			MPI_Type_commit(&type);
+			MPI_Isend(Mptr(A->A, 0, oldcount[i * npcol + mycol], ld), 1, type, mapping[i], MSGID_BEGIN_COLL, GRID->row_comm, &req[nreq++]);
+			MPI_Type_free(&type);
+		}
+		else if (mapping[i] == mycol)
+		{
+			MPI_Irecv(buffer + (size_t) recvcols * mp, w * mp, MPI_DOUBLE, oldmapping[i], MSGID_BEGIN_COLL, GRID->row_comm, &req[nreq++]);
+			recvcols += w;
+		}
+	}
+	MPI_Waitall(nreq, req, MPI_STATUSES_IGNORE);
+
+	//Shift the blocks that stay, they keep their order: the ones moving left in ascending order, the ones moving right in descending order
+	for (int i = first;i < mcols;i++)
+	{
+		if (oldmapping[i] == mycol && mapping[i] == mycol && GRID->col_count[i * npcol + mycol] < oldcount[i * npcol + mycol])
+		{
+			HPL_pdrebalance_move(A->A, ld, mp, GRID->col_count[i * npcol + mycol], oldcount[i * npcol + mycol], Mmin(nb, N + 1 - i * nb));
+		}
+	}
+	for (int i = mcols - 1;i >= first;i--)
+	{
+		if (oldmapping[i] == mycol && mapping[i] == mycol && GRID->col_count[i * npcol + mycol] > oldcount[i * npcol + mycol])
+		{
+			HPL_pdrebalance_move(A->A, ld, mp, GRID->col_count[i * npcol + mycol], oldcount[i * npcol + mycol], Mmin(nb, N + 1 - i * nb));
+		}
+	}
+	recvcols = 0;
+	for (int i = first;i < mcols;i++)
+	{
+		const int w = Mmin(nb, N + 1 - i * nb);
+		if (oldmapping[i] == mapping[i] || mapping[i] != mycol) continue;
+		for (int c = 0;c < w;c++) memcpy(Mptr(A->A, 0, GRID->col_count[i * npcol + mycol] + c, ld), buffer + (size_t) (recvcols + c) * mp, mp * sizeof(double));
+		recvcols += w;
+	}
+
+	if (GRID->myrow == 0 && mycol == 0)
+	{
+		fprintf(STD_OUT, "HPL_REBALANCE: imbalance %2.1lf %% from col %d, %d of %d block columns moved, weights", 100. * imbalance, first * nb, moved, mcols - first);
+		for (int q = 0;q < npcol;q++) fprintf(STD_OUT, " %.3f", pdrebalance_weights[q]);
+		fprintf(STD_OUT, "\n");
+	}
+	pdrebalance_applied = 1;
+
+	free(oldmapping);
+	free(oldcount);
+	free(req);
+	free(buffer);
+	free(rates);
+	free(cap);
+	free(count);
+	return(1);
+}
@@ -0,0 +1,215 @@
+/**
+ * Factorization of the trailing submatrix on a single process
+ *
+ * Copyright 2010:
+ *  - David Rohr (drohr@jwdt.org)
+ *  - Matthias Bach (bach@compeng.uni-frankfurt.de)
+ *  - Matthias Kretz (kretz@compeng.uni-frankfurt.de)
+ *
+ * This file is part of HPL-GPU.
+ *
+ * HPL-GPU is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * HPL-GPU is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with HPL-GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition to the rules layed out by the GNU General Public License
+ * the following exception is granted:
+ *
+ * Use with the Original BSD License.
+ *
+ * Notwithstanding any other provision of the GNU General Public License
+ * Version 3, you have permission to link or combine any covered work with
+ * a work licensed under the 4-clause BSD license into a single combined
+ * work, and to convey the resulting work.  The terms of this License will
+ * continue to apply to the part which is the covered work, but the special
+ * requirements of the 4-clause BSD license, clause 3, concerning the
+ * requirement of acknowledgement in advertising materials will apply to
+ * the combination as such.
+ */
+
+/*
+ * Include files
+ */
+#include "hpl.h"
+#include "util_cal.h"
+
+/*
+ * HPL_TAIL_GATHER: in the last iterations the trailing matrix is small,
+ * but every panel still needs a broadcast, a pivot exchange and a U roll
+ * across the whole grid, so these iterations are latency bound. Once at
+ * most HPL_TAIL_GATHER columns are left, HPL_pdgesv stops after the
+ * update of the last distributed panel and the trailing submatrix
+ * A(J:N-1, J:N), b included, is gathered on the process owning A(J, J).
+ * That process factorizes it with a blocked LU with partial pivoting,
+ * and only the upper triangle and b, which is all HPL_pdtrsv reads, are
+ * sent back to their owners.
+ */
+
+static void HPL_pdtail_dgetrf(const int M, const int N, const int NB, double* A, const int LDA, int* INFO)
+{
+	//Right-looking LU with partial pivoting of the M by N matrix A, N >= M, the pivots are applied to the whole rows
+	for (int k = 0;k < M;k += NB)
+	{
+		const int kb = Mmin(NB, M - k);
+		for (int c = k;c < k + kb;c++)
+		{
+			const int p = c + HPL_idamax(M - c, Mptr(A, c, c, LDA), 1);
+			if (p != c) HPL_dswap(N, Mptr(A, c, 0, LDA), LDA, Mptr(A, p, 0, LDA), LDA);
+			if (*Mptr(A, c, c, LDA) == HPL_rzero)
+			{
+				if (*INFO == 0) *INFO = c + 1;
+				continue;
+			}
+			if (c + 1 == M) continue;
+			HPL_dscal(M - c - 1, HPL_rone / *Mptr(A, c, c, LDA), Mptr(A, c + 1, c, LDA), 1);
+			if (c + 1 < k + kb) HPL_dger(HplColumnMajor, M - c - 1, k + kb - c - 1, -HPL_rone, Mptr(A, c + 1, c, LDA), 1, Mptr(A, c, c + 1, LDA), LDA, Mptr(A, c + 1, c + 1, LDA), LDA);
+		}
+		if (k + kb < N)
+		{
+			HPL_dtrsm(HplColumnMajor, HplLeft, HplLower, HplNoTrans, HplUnit, kb, N - k - kb, HPL_rone, Mptr(A, k, k, LDA), LDA, Mptr(A, k, k + kb, LDA), LDA);
+			if (k + kb < M) HPL_dgemm(HplColumnMajor, HplNoTrans, HplNoTrans, M - k - kb, N - k - kb, kb, -HPL_rone, Mptr(A, k + kb, k, LDA), LDA, Mptr(A, k, k + kb, LDA), LDA, HPL_rone, Mptr(A, k + kb, k + kb, LDA), LDA);
+		}
+	}
+}
+
+static int* HPL_pdtail_lists(const HPL_T_grid* GRID, const int J, const int N, const int NB, const int ROWS)
+{
+	//Rows J..N-1 (ROWS) or columns J..N of the trailing submatrix grouped by the owning process row or column, in increasing order.
+	//Returns the offsets of the nprocs groups followed by the offsets of the entries relative to J.
+	const int nprocs = ROWS ? GRID->nprow : GRID->npcol, n = N - J + !ROWS;
+	int* list = (int*) malloc((nprocs + 1 + n) * sizeof(int));
+	int* owner = (int*) malloc(Mmax(n, 1) * sizeof(int));
+	if (list == NULL || owner == NULL) HPL_pabort(__LINE__, "HPL_pdtail", "Memory allocation failed for the index lists");
+	for (int p = 0;p <= nprocs;p++) list[p] = nprocs + 1;
+	for (int i = 0;i < n;i++)
+	{
+		if (ROWS)
+		{
+			Mindxg2p_row(J + i, NB, NB, owner[i], nprocs, GRID);
+		}
+		else owner[i] = MColToPCol(J + i, NB, GRID);
+		for (int p = owner[i] + 1;p <= nprocs;p++) list[p]++;
+	}
+	int* next = (int*) malloc(nprocs * sizeof(int));
+	for (int p = 0;p < nprocs;p++) next[p] = list[p];
+	for (int i = 0;i < n;i++) list[next[owner[i]]++] = i;
+	free(next);
+	free(owner);
+	return(list);
+}
+
+static int HPL_pdtail_copy(const int* ROWS, const int* COLS, const int PROW, const int PCOL, const int N, const int UPPER, double* BUF, double* M, const int LDM, const int LOCAL, const int TO_M)
+{
+	//Walk the entries of process (PROW, PCOL) in its local column major order and copy them between the packed BUF and M,
+	//which is either the local submatrix (LOCAL) or the gathered trailing matrix. With UPPER only the upper triangle and b
+	//(column N relative to J) are included. BUF NULL only counts the entries.
+	int count = 0;
+	for (int k = COLS[PCOL];k < COLS[PCOL + 1];k++)
+	{
+		const int c = COLS[k], cl = k - COLS[PCOL];
+		for (int l = ROWS[PROW];l < ROWS[PROW + 1];l++)
+		{
+			const int i = ROWS[l], rl = l - ROWS[PROW];
+			if (UPPER && i > c && c < N) break;
+			if (BUF)
+			{
+				double* m = LOCAL ? Mptr(M, rl, cl, LDM) : Mptr(M, i, c, LDM);
+				if (TO_M) *m = BUF[count];
+				else BUF[count] = *m;
+			}
+			count++;
+		}
+	}
+	return(count);
+}
+
+void HPL_pdtail(HPL_T_grid* GRID, HPL_T_pmat* A, const int J)
+{
+/*
+ * Gathers the trailing submatrix from global row and column J on, which
+ * is fully updated, factorizes it on a single process and scatters the
+ * factors back. Sets A->info if a pivot is zero.
+ */
+	const int N = A->n, NB = A->nb, n = N - J, lda = A->ld;
+	int nprow, npcol, myrow, mycol, ii, jj, prow, pcol, rank, size;
+	(void) HPL_grid_info(GRID, &nprow, &npcol, &myrow, &mycol);
+	MPI_Comm_rank(GRID->all_comm, &rank);
+	MPI_Comm_size(GRID->all_comm, &size);
+	HPL_infog2l(J, J, NB, NB, 0, 0, myrow, mycol, nprow, npcol, &ii, &jj, &prow, &pcol, GRID);
+	int* rows = HPL_pdtail_lists(GRID, J, N, NB, 1);
+	int* cols = HPL_pdtail_lists(GRID, J, N, NB, 0);
+	double* Aloc = Mptr(A->A, ii, jj, lda);
+
+	//The process owning A(J, J) does the factorization
+	int root = (myrow == prow && mycol == pcol) ? rank : 0;
+	MPI_Allreduce(MPI_IN_PLACE, &root, 1, MPI_INT, MPI_MAX, GRID->all_comm);
+	const double start = HPL_ptimer_walltime();
+
+	const int count = HPL_pdtail_copy(rows, cols, myrow, mycol, n, 0, NULL, NULL, 0, 0, 0);
+	double* buf = (double*) malloc(Mmax(count, 1) * sizeof(double));
+	if (buf == NULL) HPL_pabort(__LINE__, "HPL_pdtail", "Memory allocation failed for the trailing submatrix");
+	HPL_pdtail_copy(rows, cols, myrow, mycol, n, 0, buf, Aloc, lda, 1, 0);
+
+	int coords[2] = {myrow, mycol}, *procs = NULL, *counts = NULL, *displs = NULL;
+	double *T = NULL, *all = NULL;
+	if (rank == root)
+	{
+		procs = (int*) malloc(2 * size * sizeof(int));
+		counts = (int*) malloc(2 * size * sizeof(int));
+		displs = counts + size;
+		T = (double*) malloc((size_t) n * (n + 1) * sizeof(double));
+		all = (double*) malloc((size_t) n * (n + 1) * sizeof(double));
+		if (procs == NULL || counts == NULL || T == NULL || all == NULL) HPL_pabort(__LINE__, "HPL_pdtail", "Memory allocation failed for the trailing submatrix");
+	}
+	MPI_Gather(coords, 2, MPI_INT, procs, 2, MPI_INT, root, GRID->all_comm);
+	if (rank == root)
+	{
+		for (int r = 0, displ = 0;r < size;r++)
+		{
+			counts[r] = HPL_pdtail_copy(rows, cols, procs[2 * r], procs[2 * r + 1], n, 0, NULL, NULL, 0, 0, 0);
+			displs[r] = displ;
+			displ += counts[r];
+		}
+	}
+	MPI_Gatherv(buf, count, MPI_DOUBLE, all, counts, displs, MPI_DOUBLE, root, GRID->all_comm);
+
+	int info = 0;
+	if (rank == root)
+	{
+		for (int r = 0;r < size;r++) HPL_pdtail_copy(rows, cols, procs[2 * r], procs[2 * r + 1], n, 0, all + displs[r], T, n, 0, 1);
+		HPL_pdtail_dgetrf(n, n + 1, NB, T, n, &info);
+		//Send back only the upper triangle and b, the rows below the diagonal are not read by HPL_pdtrsv
+		for (int r = 0, displ = 0;r < size;r++)
+		{
+			counts[r] = HPL_pdtail_copy(rows, cols, procs[2 * r], procs[2 * r + 1], n, 1, all + displ, T, n, 0, 0);
+			displs[r] = displ;
+			displ += counts[r];
+		}
+	}
+	const int upper = HPL_pdtail_copy(rows, cols, myrow, mycol, n, 1, NULL, NULL, 0, 0, 0);
+	MPI_Scatterv(all, counts, displs, MPI_DOUBLE, buf, upper, MPI_DOUBLE, root, GRID->all_comm);
+	HPL_pdtail_copy(rows, cols, myrow, mycol, n, 1, buf, Aloc, lda, 1, 1);
+	MPI_Bcast(&info, 1, MPI_INT, root, GRID->all_comm);
+	if (info && A->info == 0) A->info = J + info;
+
+	free(buf);
+	free(rows);
+	free(cols);
+	if (rank == root)
+	{
+		fprintf(STD_OUT, "HPL_TAIL_GATHER: factorized the last %d columns on rank %d in %.3f s\n", n, root, HPL_ptimer_walltime() - start);
+		free(procs);
+		free(counts);
+		free(T);
+		free(all);
+	}
+}
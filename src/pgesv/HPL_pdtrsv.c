@@ -62,21 +62,31 @@
 
 int HPL_n1(int matrix_col, int nb, const HPL_T_grid* GRID)
 {
-	int cols = 0;
-	if (matrix_col)
-	{
-		int process_col = GRID->col_mapping[matrix_col];
-		matrix_col--;
-		while (matrix_col >= 0 && GRID->col_mapping[matrix_col] != process_col)
-		{
-			cols++;
-			matrix_col--;
-		}
-	}
+	//NB blocks back to the previous one of the same process column
+	int cols = matrix_col - 1 - GRID->col_prev[matrix_col];
+	//At least the block before, which is solved next (with one process column it belongs to the same one)
+	if (cols == 0 && matrix_col) cols = matrix_col - HPL_blockstart(matrix_col * nb - 1, nb, GRID) / nb;
 	if (cols == 0) cols = 1;
 	return(cols * nb);
 }
 
+static int HPL_pdtrsv_prow(int matrix_col, int nprow, const HPL_T_grid* GRID)
+{
+	//Process row owning the diagonal block of NB block matrix_col
+	return(GRID->row_mapping ? GRID->row_mapping[matrix_col] : matrix_col % nprow);
+}
+
+static int HPL_pdtrsv_maxwidth(int nb, const HPL_T_grid* GRID)
+{
+	//Widest block of the distribution
+	int i, width = nb;
+	for (i = 0;GRID->block_offset && i < GRID->nblocks;i++)
+	{
+		width = Mmax(width, GRID->block_offset[i + 1] - GRID->block_offset[i]);
+	}
+	return(width);
+}
+
 void HPL_pdtrsv(HPL_T_grid* GRID, HPL_T_pmat* AMAT)
 {
 /* 
@@ -107,6 +117,11 @@ void HPL_pdtrsv(HPL_T_grid* GRID, HPL_T_pmat* AMAT)
  * length NB to compute the next  NB  entries of the vector solution, as
  * well as performing a total of N^2 floating point operations.
  *
+ * With a variable width distribution (GRID->block_offset) the solve steps
+ * through the variable width blocks instead of the  NB  blocks, all NB
+ * blocks of a block belong to the same process, and consecutive blocks
+ * always belong to different process columns.
+ *
  * Arguments
  * =========
  *
@@ -146,14 +161,13 @@ void HPL_pdtrsv(HPL_T_grid* GRID, HPL_T_pmat* AMAT)
 	GridIsNotPx1 = (npcol > 1);
 
 //Move the rhs in the process column owning the last column of A.
-	Mnumrow(Anp, n, nb, myrow, nprow);
+	Mnumrow(Anp, n, nb, myrow, nprow, GRID);
 	Mnumcol(Anq, n, nb, mycol, GRID);
 
-	tmp1 = (n - 1) / nb;
-	Alrow = tmp1 % nprow;
-	Alcol_matrix = tmp1;
+	kb = n - HPL_blockstart(n - 1, nb, GRID);
+	Alcol_matrix = (n - kb) / nb;
+	Alrow = HPL_pdtrsv_prow(Alcol_matrix, nprow, GRID);
 	Alcol_process = MColBlockToPCol(Alcol_matrix, GRID);
-	kb = n - tmp1 * nb;
 
 	Aptr = (double *) (A);
 	XC = Mptr(Aptr, 0, Anq, lda);
@@ -183,7 +197,7 @@ void HPL_pdtrsv(HPL_T_grid* GRID, HPL_T_pmat* AMAT)
 	//n1 = (npcol - 1) * nb;
 	//n1 = Mmax(n1, nb);
 	n1 = HPL_n1(Alcol_matrix, nb, GRID);
-	Wsize = Mmin((npcol - 1) * nb, Anp);
+	Wsize = Mmin((npcol - 1) * HPL_pdtrsv_maxwidth(nb, GRID), Anp);
 	if (Wsize > 0)
 	{
 		W = (double*) malloc((size_t) Wsize * sizeof(double));
@@ -198,7 +212,7 @@ void HPL_pdtrsv(HPL_T_grid* GRID, HPL_T_pmat* AMAT)
 	Aprev = Aptr = Mptr(Aptr, 0, Anq, lda);
 	tmp1 = n - kb;
 	tmp1 -= (tmp2 = Mmin(tmp1, n1));
-	MnumrowI(n1pprev, tmp2, Mmax(0, tmp1), nb, myrow, nprow);
+	MnumrowI(n1pprev, tmp2, Mmax(0, tmp1), nb, myrow, nprow, GRID);
 
 	if (myrow == Alrow)
 	{
@@ -223,15 +237,16 @@ void HPL_pdtrsv(HPL_T_grid* GRID, HPL_T_pmat* AMAT)
 	while(n > 0)
 	{
 		rowprev = Alrow;
-		Alrow = MModSub1(Alrow, nprow);
 		colprev = Alcol_process;
-		Alcol_matrix--;
-		Alcol_process = MColBlockToPCol(Alcol_matrix, GRID);
 		kbprev = kb;
+		kb = n - HPL_blockstart(n - 1, nb, GRID);
+		Alcol_matrix = (n - kb) / nb;
+		Alrow = HPL_pdtrsv_prow(Alcol_matrix, nprow, GRID);
+		Alcol_process = MColBlockToPCol(Alcol_matrix, GRID);
 		n1 = HPL_n1(Alcol_matrix, nb, GRID);
-		tmp1 = n - (kb = nb);
+		tmp1 = n - kb;
 		tmp1 -= (tmp2 = Mmin(tmp1, n1));
-		MnumrowI(n1p, tmp2, Mmax(0, tmp1), nb, myrow, nprow);
+		MnumrowI(n1p, tmp2, Mmax(0, tmp1), nb, myrow, nprow, GRID);
 		if(mycol == Alcol_process)
 		{
 			Aptr -= lda * kb;
@@ -278,16 +293,19 @@ void HPL_pdtrsv(HPL_T_grid* GRID, HPL_T_pmat* AMAT)
 			{
 				if (sendcol_matrix != -1)
 				{
-					tmp2 = 1;
-					while (sendcol_matrix >= tmp2 && !(GRID->col_mapping[sendcol_matrix - tmp2 + 1] > GRID->col_mapping[sendcol_matrix - tmp2] ?
-						(GRID->col_mapping[sendcol_matrix - tmp2 + 1] >= mycol && GRID->col_mapping[sendcol_matrix - tmp2] <= mycol) :
-						(GRID->col_mapping[sendcol_matrix - tmp2 + 1] >= mycol || GRID->col_mapping[sendcol_matrix - tmp2] <= mycol)))
+					//Walk back block by block (NB block by NB block for the uniform distribution) to the next time this process column sends
+					int next = sendcol_matrix, cur = -1;
+					while (next > 0)
 					{
-						tmp2++;
+						cur = HPL_blockstart(next * nb - 1, nb, GRID) / nb;
+						if (GRID->col_mapping[next] > GRID->col_mapping[cur] ?
+							(GRID->col_mapping[next] >= mycol && GRID->col_mapping[cur] <= mycol) :
+							(GRID->col_mapping[next] >= mycol || GRID->col_mapping[cur] <= mycol)) break;
+						next = cur;
 					}
-					sendcol_matrix -= tmp2;
-					tmp2 *= nb;
-					MnumrowI(tmp1, tmp2, n - tmp2, nb, myrow, nprow);
+					sendcol_matrix = next > 0 ? cur : -1;
+					tmp2 = n - next * nb;
+					MnumrowI(tmp1, tmp2, n - tmp2, nb, myrow, nprow, GRID);
 					tmp2 = Anpprev - tmp1;
 				}
 				else
@@ -81,6 +81,10 @@ void HPL_perm
  * call to this function,  this in place permutation can be performed by
  * for i in [0..N) swap U[i] with U[LINDXAU[i]].
  *
+ * The positions of i in LINDXA  and of j in IWORK  are obtained from two
+ * inverse tables, the second of which is updated along with every swap,
+ * so that the construction is O(N) instead of O(N^2).
+ *
  * Arguments
  * =========
  *
@@ -107,24 +111,40 @@ void HPL_perm
 /*
  * .. Local Variables ..
  */
-   int                        i, j, k, fndd;
+   static int                 * inv = NULL;
+   static int                 linv = 0;
+   int                        * inva, * invw;
+   int                        i, j, k;
 /* ..
  * .. Executable Statements ..
  */
+   if( N <= 0 ) return;
+   if( 2 * N > linv )
+   {
+      if( inv ) free( inv );
+      inv = (int *)malloc( (size_t)(2 * N) * sizeof( int ) );
+      if( inv == NULL )
+      { HPL_pabort( __LINE__, "HPL_perm", "Memory allocation failed" ); }
+      linv = 2 * N;
+   }
+   inva = inv; invw = inv + N;
 /*
  * Inverse LINDXA - combine LINDXA and LINDXAU - Initialize IWORK
  */
    for( i = 0; i < N; i++ ) { IWORK[LINDXA[i]] = i; }
    for( i = 0; i < N; i++ ) { LINDXA[i] = LINDXAU[IWORK[i]]; IWORK[i] = i; }
+/*
+ * inva[i] is the j such that LINDXA[j] == i, invw[j] the k such that
+ * IWORK[k] == j
+ */
+   for( i = 0; i < N; i++ ) { inva[LINDXA[i]] = i; invw[i] = i; }
  
    for( i = 0; i < N; i++ )
    {
-      /* search LINDXA such that    LINDXA[j]  == i */
-      j = 0; do { fndd = ( LINDXA[j] == i ); j++; } while( !fndd ); j--;
-      /* search IWORK  such that    IWORK[k]   == j */
-      k = 0; do { fndd = ( IWORK[k]  == j ); k++; } while( !fndd ); k--;
+      j = inva[i]; k = invw[j];
       /* swap IWORK[i] and IWORK[k]; LINDXAU[i] = k */
       j = IWORK[i]; IWORK[i] = IWORK[k]; IWORK[k] = j;
+      invw[IWORK[i]] = i; invw[IWORK[k]] = k;
       LINDXAU[i] = k;
    }
 /*
@@ -60,6 +60,56 @@
  */
 #include "hpl.h"
 
+int * HPL_pipid_rowmap
+(
+   const int                        M
+)
+{
+/* 
+ * Purpose
+ * =======
+ *
+ * HPL_pipid_rowmap returns a process-local table of at least M integers
+ * that is indexed by the row offset relative to the current panel, i.e.
+ * by  row - IA.  All  entries  are  -1  on return.  Callers may use the
+ * table as a direct-address  map from a global row index to the pair in
+ * IPID that refers to it,  but  must reset every entry they set back to
+ * -1 before returning, so that the table can be reused without an O(M)
+ * clearing pass. The table is only grown, never shrunk, and it is kept
+ * for the whole run.
+ *
+ * Arguments
+ * =========
+ *
+ * M       (local input)                 const int
+ *         On entry, M specifies the minimum number of entries required.
+ *
+ * ---------------------------------------------------------------------
+ */ 
+/*
+ * .. Local Variables ..
+ */
+   static int                 * map = NULL;
+   static int                 size = 0;
+   int                        i;
+/* ..
+ * .. Executable Statements ..
+ */
+   if( M > size )
+   {
+      if( map ) free( map );
+      map = (int *)malloc( (size_t)(M) * sizeof( int ) );
+      if( map == NULL )
+      { HPL_pabort( __LINE__, "HPL_pipid_rowmap", "Memory allocation failed" ); }
+      for( i = 0; i < M; i++ ) map[i] = -1;
+      size = M;
+   }
+   return( map );
+/*
+ * End of HPL_pipid_rowmap
+ */
+}
+
 void HPL_pipid
 (
    HPL_T_panel *                    PANEL,
@@ -112,6 +162,13 @@ void HPL_pipid
  * For k in  [0..K/2),  the  row  of global index  IPID(2*k)  should  be
  * mapped onto the row of global index IPID(2*k+1).
  *
+ * Instead of scanning  IPID  for src and dst,  the  pair that currently
+ * holds a given destination is looked up in a direct-address table (see
+ * HPL_pipid_rowmap) indexed by row - IA. The set of destinations stored
+ * in IPID only grows,  so this table is kept up to date with O(1) work
+ * per interchange,  and  the  resulting  IPID  is identical to the one
+ * produced by the linear search. The total cost is O(N).
+ *
  * Arguments
  * =========
  *
@@ -136,6 +193,7 @@ void HPL_pipid
 /*
  * .. Local Variables ..
  */
+   int                        * map;
    int                        dst, fndd, fnds, ia, i, j, jb, lst, off,
                               src;
    double                     * dpiv;
@@ -143,36 +201,37 @@ void HPL_pipid
  * .. Executable Statements ..
  */
    dpiv = PANEL->DPIV; jb = PANEL->jb; src = ia = PANEL->ia;
+/*
+ * map[row-ia] is the index of the pair whose destination is row, or -1
+ */
+   map  = HPL_pipid_rowmap( PANEL->m );
+
    dst  = (int)(dpiv[0]); IPID[0] = dst; IPID[1] = src; *K = 2;
-   if( src != dst ) { IPID[2] = src; IPID[3] = dst; *K += 2; }
+   map[src-ia] = 0;
+   if( src != dst ) { IPID[2] = src; IPID[3] = dst; *K += 2; map[dst-ia] = 1; }
 
    for( i = 1; i < jb; i++ )
    {
-      fnds = 0; j = 1;
+      src  = ia + i; dst = (int)(dpiv[i]);
+      fnds = map[src-ia];
 
-      if( ( src = ia + i ) == ( dst = (int)(dpiv[i]) ) )
+      if( src == dst )
       {
-         do { if( src == IPID[j] ) { fnds = j; } else { j += 2; } }
-         while( !( fnds ) && ( j < *K ) );
-         if( !fnds ) { lst = *K;     off = 2; IPID[lst] = src; }
-         else        { lst = fnds-1; off = 0; }
+         if( fnds < 0 ) { lst = *K;       off = 2; IPID[lst] = src;
+                          map[src-ia] = lst >> 1; }
+         else           { lst = fnds << 1; off = 0; }
          IPID[lst+1] = dst;
       }
       else
       {
-         fndd = 0;
-         do
-         {
-            if     ( src == IPID[j] ) { fnds = j; }
-            else if( dst == IPID[j] ) { fndd = j; }
-            j += 2;
-         }
-         while( ( !( fnds ) || !( fndd ) ) && ( j < *K ) );
-         if( !fnds ) { IPID[*K] = src; IPID[*K+1] = dst; off  = 2; }
-         else        {                 IPID[fnds] = dst; off  = 0; }
-         if( !fndd ) { lst = *K+off;   IPID[lst ] = dst; off += 2; }
-         else        { lst = fndd-1; }
-         IPID[lst+1] = src;
+         fndd = map[dst-ia];
+         if( fnds < 0 ) { IPID[*K] = src; IPID[*K+1] = dst; off  = 2;
+                          map[dst-ia] = *K >> 1; }
+         else           { IPID[(fnds << 1)+1] = dst;         off  = 0;
+                          map[dst-ia] = fnds; }
+         if( fndd < 0 ) { lst = *K+off;   IPID[lst ] = dst; off += 2; }
+         else           { lst = fndd << 1; }
+         IPID[lst+1] = src; map[src-ia] = lst >> 1;
       }
 /*
  * Enforce IPID(1,i) equal to src = ia + i
@@ -181,9 +240,14 @@ void HPL_pipid
       {
          src = IPID[j  ]; IPID[j  ] = IPID[lst  ]; IPID[lst  ] = src;
          dst = IPID[j+1]; IPID[j+1] = IPID[lst+1]; IPID[lst+1] = dst;
+         map[IPID[j+1]-ia] = i; map[IPID[lst+1]-ia] = lst >> 1;
       }
       *K += off;
    }
+/*
+ * Restore the row map for the next call
+ */
+   for( j = 1; j < *K; j += 2 ) map[IPID[j]-ia] = -1;
 /*
  * End of HPL_pipid
  */
@@ -160,9 +160,11 @@ START_TRACE( PLDINDX1 )
 /*
  * .. Local Variables ..
  */
-   int                        * iwork;
-   int                        dst, dstrow, fndd, i, ia, icurrow, il,
-                              ip, ipU, iroff, j, jb, myrow, nb, nprow,
+   static int                 * rows = NULL;
+   static int                 lrows = 0;
+   int                        * iwork, * map, * srcrows, * dstrows;
+   int                        dst, dstrow, i, ia, icurrow, il, ip, ipU,
+                              iroff, j, jb, myrow, nb, npairs, nprow,
                               src, srcrow;
 /* ..
  * .. Executable Statements ..
@@ -181,19 +183,40 @@ START_TRACE( PLDINDX1 )
    jb    = PANEL->jb;          nb      = PANEL->nb;     ia = PANEL->ia;
    iroff = PANEL->ii;          icurrow = PANEL->prow;
 
-   iwork = IWORK + jb;
+   iwork = IWORK + jb;  npairs = K >> 1;
+/*
+ * Owner process rows of all sources and destinations. They are independent
+ * per pair, so HPL_plindxrow may compute them with the LASWP threads.
+ */
+   if( K > lrows )
+   {
+      if( rows ) free( rows );
+      rows = (int *)malloc( (size_t)(K) * sizeof( int ) );
+      if( rows == NULL )
+      { HPL_pabort( __LINE__, "HPL_plindx1", "Memory allocation failed" ); }
+      lrows = K;
+   }
+   srcrows = rows; dstrows = rows + npairs;
+   HPL_plindxrow( npairs, IPID, nb, nprow, PANEL->grid->row_mapping, srcrows, dstrows );
+/*
+ * map[row-ia] is the pair whose source is row. Every destination of IPID
+ * is also a source, so this replaces the linear search for the final
+ * destination of a row that leaves the current process row.
+ */
+   map = HPL_pipid_rowmap( PANEL->m );
+   for( i = 0; i < npairs; i++ ) map[IPID[i << 1]-ia] = i;
  
    if( myrow == icurrow )
    {
-      for( i = 0, ip = 0, ipU = 0; i < K; i += 2 )
+      for( i = 0, ip = 0, ipU = 0; i < npairs; i++ )
       {
-         src = IPID[i]; Mindxg2p_row( src, nb, nb, srcrow, nprow );
+         src = IPID[i << 1]; srcrow = srcrows[i];
  
          if( srcrow == icurrow )
          {
-            dst = IPID[i+1]; Mindxg2p_row( dst, nb, nb, dstrow, nprow );
+            dst = IPID[(i << 1)+1]; dstrow = dstrows[i];
  
-            Mindxg2l_row( il, src, nb, nb, myrow, nprow );
+            Mindxg2l_row( il, src, nb, nb, myrow, nprow, PANEL->grid );
             LINDXA[ip] = il - iroff;
  
             if( ( dstrow == icurrow ) && ( dst - ia < jb ) )
@@ -204,17 +227,13 @@ START_TRACE( PLDINDX1 )
             }
             else if( dstrow != icurrow )
             {
-               j = 0;
-               do { fndd = ( dst == IPID[j] ); j+=2; }
-               while( !fndd && ( j < K ) );
- 
-               PERMU[ipU] = IPID[j-1]-ia; il = IPMAPM1[dstrow];
+               PERMU[ipU] = IPID[(map[dst-ia] << 1)+1]-ia; il = IPMAPM1[dstrow];
                j          = IPLEN[il];    iwork[ipU] = LINDXAU[ip] = j;
                IPLEN[il]++; ipU++;
             }
             else if( ( dstrow == icurrow ) && ( dst - ia >= jb ) )
             {
-               Mindxg2l_row( il, dst, nb, nb, myrow, nprow );
+               Mindxg2l_row( il, dst, nb, nb, myrow, nprow, PANEL->grid );
                LINDXAU[ip] = iroff - il;
             }
             ip++;
@@ -224,16 +243,16 @@ START_TRACE( PLDINDX1 )
    }
    else
    {
-      for( i = 0, ip = 0, ipU = 0; i < K; i += 2 )
+      for( i = 0, ip = 0, ipU = 0; i < npairs; i++ )
       {
-         src = IPID[i  ]; Mindxg2p_row( src, nb, nb, srcrow, nprow );
-         dst = IPID[i+1]; Mindxg2p_row( dst, nb, nb, dstrow, nprow );
+         srcrow = srcrows[i];
+         dst = IPID[(i << 1)+1]; dstrow = dstrows[i];
 /*
  * LINDXA[i] is the local index of the row of A that belongs into U
  */
          if( myrow == dstrow )
          {
-            Mindxg2l_row( il, dst, nb, nb, myrow, nprow );
+            Mindxg2l_row( il, dst, nb, nb, myrow, nprow, PANEL->grid );
             LINDXA[ip] = il - iroff; ip++;
          }
 /*
@@ -249,16 +268,17 @@ START_TRACE( PLDINDX1 )
             }
             else if( dstrow != icurrow )
             {
-               j = 0;
-               do { fndd = ( dst == IPID[j] ); j+=2; }
-               while( !fndd && ( j < K ) );
-               PERMU[ipU] = IPID[j-1] - ia; il = IPMAPM1[dstrow];
+               PERMU[ipU] = IPID[(map[dst-ia] << 1)+1] - ia; il = IPMAPM1[dstrow];
                iwork[ipU] = IPLEN[il]; IPLEN[il]++; ipU++;
             }
          }
       }
       *IPA = 0;
    }
+/*
+ * Restore the row map for the next call
+ */
+   for( i = 0; i < npairs; i++ ) map[IPID[i << 1]-ia] = -1;
 /*
  * Simplify iwork and PERMU, return in PERMU the sequence of permutation
  * that need to be apply to U after it has been broadcast.
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2010:
+ *  - David Rohr (drohr@jwdt.org)
+ *  - Matthias Bach (bach@compeng.uni-frankfurt.de)
+ *  - Matthias Kretz (kretz@compeng.uni-frankfurt.de)
+ *
+ * This file is part of HPL-GPU.
+ *
+ * HPL-GPU is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * HPL-GPU is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with HPL-GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition to the rules layed out by the GNU General Public License
+ * the following exception is granted:
+ *
+ * Use with the Original BSD License.
+ *
+ * Notwithstanding any other provision of the GNU General Public License
+ * Version 3, you have permission to link or combine any covered work with
+ * a work licensed under the 4-clause BSD license into a single combined
+ * work, and to convey the resulting work.  The terms of this License will
+ * continue to apply to the part which is the covered work, but the special
+ * requirements of the 4-clause BSD license, clause 3, concerning the
+ * requirement of acknowledgement in advertising materials will apply to
+ * the combination as such.
+ */
+
+#include "util_timer.h"
+#include "util_trace.h"
+#ifndef USE_ORIGINAL_LASWP
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+#endif
+
+#ifndef HPL_PLINDXROW_PARALLEL_MIN
+#define HPL_PLINDXROW_PARALLEL_MIN 1024
+#endif
+
+/*
+ * Process row owning global row ig for a block-cyclic row distribution
+ * with square blocks of size nb starting at process row 0, or from the
+ * row mapping of variable width blocks if there is one, i.e. the same
+ * result as Mindxg2p_row( ig, nb, nb, proc, nprow, grid ).
+ */
+static inline int rowOwner(const int ig, const int nb, const int nprow, const int *rowmap)
+{
+    return rowmap ? rowmap[ig / nb] : (ig / nb) % nprow;
+}
+
+#ifndef USE_ORIGINAL_LASWP
+class plindxrow_impl
+{
+    const int *__restrict__ const IPID;
+    int *__restrict__ const SRCROW;
+    int *__restrict__ const DSTROW;
+    const int NB, NPROW;
+    const int *const ROWMAP;
+    public:
+        plindxrow_impl(const int *_IPID, int *_SRCROW, int *_DSTROW, int _NB, int _NPROW, const int *_ROWMAP)
+            : IPID(_IPID), SRCROW(_SRCROW), DSTROW(_DSTROW), NB(_NB), NPROW(_NPROW), ROWMAP(_ROWMAP)
+        {}
+
+        void operator()(const tbb::blocked_range<int> &range) const
+        {
+            for (int i = range.begin(); i != range.end(); ++i) {
+                SRCROW[i] = rowOwner(IPID[2 * i    ], NB, NPROW, ROWMAP);
+                DSTROW[i] = rowOwner(IPID[2 * i + 1], NB, NPROW, ROWMAP);
+            }
+        }
+};
+#endif
+
+/*
+ * Computes for each of the NPAIRS (src,dst) pairs in IPID the process rows
+ * owning src and dst. Large panels are classified by the LASWP worker
+ * threads, small ones serially since the task overhead would dominate.
+ */
+extern "C" void HPL_plindxrow(const int NPAIRS, const int *IPID, const int NB,
+        const int NPROW, const int *ROWMAP, int *SRCROW, int *DSTROW)
+{
+START_TRACE( PLINDXROW )
+
+#ifndef USE_ORIGINAL_LASWP
+    if (NPAIRS >= HPL_PLINDXROW_PARALLEL_MIN) {
+        tbb::parallel_for(tbb::blocked_range<int>(0, NPAIRS, HPL_PLINDXROW_PARALLEL_MIN / 4),
+                plindxrow_impl(IPID, SRCROW, DSTROW, NB, NPROW, ROWMAP));
+    } else
+#endif
+    {
+        for (int i = 0; i < NPAIRS; ++i) {
+            SRCROW[i] = rowOwner(IPID[2 * i    ], NB, NPROW, ROWMAP);
+            DSTROW[i] = rowOwner(IPID[2 * i + 1], NB, NPROW, ROWMAP);
+        }
+    }
+
+END_TRACE
+}
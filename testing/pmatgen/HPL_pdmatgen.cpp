@@ -0,0 +1,301 @@
+/*
+ *  -- High Performance Computing Linpack Benchmark (HPL-GPU)
+ *     HPL-GPU - 2.0 - 2015
+ *
+ *     David Rohr
+ *     Matthias Kretz
+ *     Matthias Bach
+ *     Goethe Universität, Frankfurt am Main
+ *     Frankfurt Institute for Advanced Studies
+ *     (C) Copyright 2010 All Rights Reserved
+ *
+ *     Antoine P. Petitet
+ *     University of Tennessee, Knoxville
+ *     Innovative Computing Laboratory
+ *     (C) Copyright 2000-2008 All Rights Reserved
+ *
+ *  -- Copyright notice and Licensing terms:
+ *
+ *  Redistribution  and  use in  source and binary forms, with or without
+ *  modification, are  permitted provided  that the following  conditions
+ *  are met:
+ *
+ *  1. Redistributions  of  source  code  must retain the above copyright
+ *  notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce  the above copyright
+ *  notice, this list of conditions,  and the following disclaimer in the
+ *  documentation and/or other materials provided with the distribution.
+ *
+ *  3. All  advertising  materials  mentioning  features  or  use of this
+ *  software must display the following acknowledgements:
+ *  This  product  includes  software  developed  at  the  University  of
+ *  Tennessee, Knoxville, Innovative Computing Laboratory.
+ *  This product  includes software  developed at the Frankfurt Institute
+ *  for Advanced Studies.
+ *
+ *  4. The name of the  University,  the name of the  Laboratory,  or the
+ *  names  of  its  contributors  may  not  be used to endorse or promote
+ *  products  derived   from   this  software  without  specific  written
+ *  permission.
+ *
+ *  -- Disclaimer:
+ *
+ *  THIS  SOFTWARE  IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES,  INCLUDING,  BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY
+ *  OR  CONTRIBUTORS  BE  LIABLE FOR ANY  DIRECT,  INDIRECT,  INCIDENTAL,
+ *  SPECIAL,  EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES  (INCLUDING,  BUT NOT
+ *  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *  DATA OR PROFITS; OR BUSINESS INTERRUPTION)  HOWEVER CAUSED AND ON ANY
+ *  THEORY OF LIABILITY, WHETHER IN CONTRACT,  STRICT LIABILITY,  OR TORT
+ *  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * ======================================================================
+ */
+
+/*
+ * Include files
+ */
+#include <stdint.h>
+extern "C" {
+#include "hpl.h"
+}
+#include <vector>
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
+#ifndef HPL_PDMATGEN_LANES
+#define HPL_PDMATGEN_LANES 8
+#endif
+
+/*
+ * The generator of HPL_rand with the 2x32 bit encoding of HPL_lmul and
+ * HPL_ladd folded into native 64 bit arithmetic: X(n+1) = a*X(n)+c mod 2^64.
+ */
+static const uint64_t lcgMult = ((uint64_t) (unsigned int) HPL_MULT1 << 32) | (unsigned int) HPL_MULT0;
+static const uint64_t lcgAdd = ((uint64_t) (unsigned int) HPL_IADD1 << 32) | (unsigned int) HPL_IADD0;
+
+struct lcgJump
+{
+	uint64_t a, c;
+
+	// Constants to jump n numbers ahead, X(k+n) = a*X(k)+c, by repeated squaring instead of the linear loop of HPL_xjumpm
+	lcgJump(uint64_t n) : a(1), c(0)
+	{
+		uint64_t sa = lcgMult, sc = lcgAdd;
+		for (;n;n >>= 1)
+		{
+			if (n & 1)
+			{
+				a *= sa;
+				c = c * sa + sc;
+			}
+			sc *= sa + 1;
+			sa *= sa;
+		}
+	}
+
+	inline uint64_t operator()(uint64_t x) const { return a * x + c; }
+};
+
+// Same floating point operations as HPL_rand, so the result is bitwise identical
+static inline double lcgValue(const uint64_t x)
+{
+	return HPL_HALF - (((double) (unsigned int) x / HPL_DIVFAC * HPL_HALF + (double) (unsigned int) (x >> 32)) / HPL_DIVFAC * HPL_HALF);
+}
+
+class HPL_pdmatgen_impl
+{
+	double* const A;
+	const size_t LDA;
+	const int M, NB, mp, myrow, JJ;
+	const int* const colblocks;
+	const int* const rowblocks;
+	const uint64_t seed;
+	const lcgJump rowBlock, lanes;
+public:
+	HPL_pdmatgen_impl(double* _A, size_t _LDA, int _M, int _NB, int _mp, int _myrow, int _nprow, int _JJ, const int* _colblocks, const int* _rowblocks, uint64_t _seed)
+		: A(_A), LDA(_LDA), M(_M), NB(_NB), mp(_mp), myrow(_myrow), JJ(_JJ), colblocks(_colblocks), rowblocks(_rowblocks), seed(_seed),
+		rowBlock((uint64_t) _nprow * _NB), lanes(HPL_PDMATGEN_LANES)
+	{}
+
+	void operator()(const tbb::blocked_range<int> &range) const
+	{
+		for (int jj = range.begin();jj != range.end();jj++)
+		{
+			//Entry (i, j) of the global matrix is number 1 + j * M + i of the sequence started at ISEED
+			const uint64_t j = (uint64_t) colblocks[jj / NB] * NB + jj % NB;
+			uint64_t block = lcgJump(1 + j * M + (uint64_t) (rowblocks ? rowblocks[0] : myrow) * NB)(seed);
+			double* __restrict__ col = A + (jj - JJ) * LDA;
+
+			for (int ii = 0;ii < mp;ii += NB)
+			{
+				const int ib = Mmin(NB, mp - ii);
+				double* __restrict__ dst = col + ii;
+				uint64_t x[HPL_PDMATGEN_LANES];
+				x[0] = block;
+				for (int k = 1;k < HPL_PDMATGEN_LANES;k++) x[k] = lcgJump(1)(x[k - 1]);
+
+				//Independent interleaved streams, each advancing HPL_PDMATGEN_LANES numbers per step, so the loop can be vectorized
+				int ik = 0;
+				for (;ik + HPL_PDMATGEN_LANES <= ib;ik += HPL_PDMATGEN_LANES)
+				{
+					for (int k = 0;k < HPL_PDMATGEN_LANES;k++)
+					{
+						dst[ik + k] = lcgValue(x[k]);
+						x[k] = lanes(x[k]);
+					}
+				}
+				for (int k = 0;ik < ib;ik++, k++) dst[ik] = lcgValue(x[k]);
+
+				//Row blocks are P blocks apart, or at arbitrary distance for variable width blocks
+				if (rowblocks == NULL) block = rowBlock(block);
+				else if (ii + NB < mp) block = lcgJump(1 + j * M + (uint64_t) rowblocks[ii / NB + 1] * NB)(seed);
+			}
+		}
+	}
+};
+
+extern "C" void HPL_pdmatgen
+(
+   const HPL_T_grid *               GRID,
+   const int                        M,
+   const int                        N,
+   const int                        NB,
+   double *                         A,
+   const int                        LDA,
+   const int                        ISEED
+)
+{
+/* 
+ * Purpose
+ * =======
+ *
+ * HPL_pdmatgen generates (or regenerates) a parallel random matrix A.
+ *  
+ * The  pseudo-random  generator uses the linear congruential algorithm:
+ * X(n+1) = (a * X(n) + c) mod m  as  described  in the  Art of Computer
+ * Programming, Knuth 1973, Vol. 2.
+ *
+ * The local columns are generated in parallel. Every column jumps the
+ * generator directly to its first entry,  so the matrix is  bitwise the
+ * same as the one of the serial reference implementation.  The  global
+ * column of a local column block is taken from GRID->col_mapping.
+ *
+ * Arguments
+ * =========
+ *
+ * GRID    (local input)                 const HPL_T_grid *
+ *         On entry,  GRID  points  to the data structure containing the
+ *         process grid information.
+ *
+ * M       (global input)                const int
+ *         On entry,  M  specifies  the number  of rows of the matrix A.
+ *         M must be at least zero.
+ *
+ * N       (global input)                const int
+ *         On entry,  N specifies the number of columns of the matrix A.
+ *         N must be at least zero.
+ *
+ * NB      (global input)                const int
+ *         On entry,  NB specifies the blocking factor used to partition
+ *         and distribute the matrix A. NB must be larger than one.
+ *
+ * A       (local output)                double *
+ *         On entry,  A  points  to an array of dimension (LDA,LocQ(N)).
+ *         On exit, this array contains the coefficients of the randomly
+ *         generated matrix.
+ *
+ * LDA     (local input)                 const int
+ *         On entry, LDA specifies the leading dimension of the array A.
+ *         LDA must be at least max(1,LocP(M)).
+ *
+ * ISEED   (global input)                const int
+ *         On entry, ISEED  specifies  the  seed  number to generate the
+ *         matrix A. ISEED must be at least zero.
+ *
+ * ---------------------------------------------------------------------
+ */ 
+   int mycol, myrow, npcol, nprow, nq;
+
+   (void) HPL_grid_info( GRID, &nprow, &npcol, &myrow, &mycol );
+   Mnumcol( nq, N, NB, mycol, GRID );
+
+   HPL_pdmatgen_cols( GRID, M, N, NB, A, LDA, ISEED, 0, nq );
+/*
+ * End of HPL_pdmatgen
+ */
+}
+
+extern "C" void HPL_pdmatgen_cols
+(
+   const HPL_T_grid *               GRID,
+   const int                        M,
+   const int                        N,
+   const int                        NB,
+   double *                         A,
+   const int                        LDA,
+   const int                        ISEED,
+   const int                        JJ,
+   const int                        NQ
+)
+{
+/* 
+ * Purpose
+ * =======
+ *
+ * HPL_pdmatgen_cols regenerates the local columns JJ:JJ+NQ-1 of the ma-
+ * trix generated by HPL_pdmatgen with the same arguments. This allows to
+ * regenerate the matrix piece by piece into a small buffer.
+ *
+ * Arguments
+ * =========
+ *
+ * GRID, M, N, NB, ISEED are the same as for HPL_pdmatgen.
+ *
+ * A       (local output)                double *
+ *         On entry,  A  points  to an array of dimension (LDA,NQ).   On
+ *         exit, column k of this array contains local column JJ+k of the
+ *         matrix.
+ *
+ * LDA     (local input)                 const int
+ *         On entry, LDA specifies the leading dimension of the array A.
+ *         LDA must be at least max(1,LocP(M)).
+ *
+ * JJ      (local input)                 const int
+ *         On entry, JJ specifies the first local column to generate.
+ *
+ * NQ      (local input)                 const int
+ *         On entry,  NQ specifies the number of local columns to gene-
+ *         rate. JJ+NQ must be at most LocQ(N).
+ *
+ * ---------------------------------------------------------------------
+ */ 
+   int mp, mycol, myrow, npcol, nprow;
+
+   (void) HPL_grid_info( GRID, &nprow, &npcol, &myrow, &mycol );
+
+   Mnumrow( mp, M, NB, myrow, nprow, GRID );
+
+   if( ( mp <= 0 ) || ( NQ <= 0 ) ) return;
+/*
+ * Global column block of every local column block, and global row block
+ * of every local row block if the rows are not distributed cyclically
+ */
+   std::vector<int> colblocks, rowblocks;
+   for( int jblk = 0; jblk < ( N + NB - 1 ) / NB; jblk++ )
+   {
+      if( MColBlockToPCol( jblk, GRID ) == mycol ) colblocks.push_back( jblk );
+   }
+   for( int iblk = 0; GRID->row_mapping && iblk < ( M + NB - 1 ) / NB; iblk++ )
+   {
+      if( GRID->row_mapping[iblk] == myrow ) rowblocks.push_back( iblk );
+   }
+
+   tbb::parallel_for( tbb::blocked_range<int>(JJ, JJ + NQ), HPL_pdmatgen_impl( A, LDA, M, NB, mp, myrow, nprow, JJ, &colblocks[0], rowblocks.empty() ? NULL : &rowblocks[0], (unsigned int) ISEED ), tbb::auto_partitioner() );
+/*
+ * End of HPL_pdmatgen_cols
+ */
+}
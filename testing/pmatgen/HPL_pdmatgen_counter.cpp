@@ -0,0 +1,128 @@
+/**
+ * Counter-based random matrix generator
+ *
+ * Copyright 2010:
+ *  - David Rohr (drohr@jwdt.org)
+ *  - Matthias Bach (bach@compeng.uni-frankfurt.de)
+ *  - Matthias Kretz (kretz@compeng.uni-frankfurt.de)
+ *
+ * This file is part of HPL-GPU.
+ *
+ * HPL-GPU is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * HPL-GPU is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with HPL-GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition to the rules layed out by the GNU General Public License
+ * the following exception is granted:
+ *
+ * Use with the Original BSD License.
+ *
+ * Notwithstanding any other provision of the GNU General Public License
+ * Version 3, you have permission to link or combine any covered work with
+ * a work licensed under the 4-clause BSD license into a single combined
+ * work, and to convey the resulting work.  The terms of this License will
+ * continue to apply to the part which is the covered work, but the special
+ * requirements of the 4-clause BSD license, clause 3, concerning the
+ * requirement of acknowledgement in advertising materials will apply to
+ * the combination as such.
+ */
+
+#include <stdint.h>
+#include <vector>
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+extern "C" {
+#include "hpl.h"
+}
+
+/*
+ * Philox2x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC'11).
+ * The counter is the global (row, column) index of the entry and the key is the seed,
+ * so every entry can be generated independently of the grid, the thread count and of
+ * all other entries.
+ */
+static inline uint64_t philox2x32(uint32_t row, uint32_t col, uint32_t key)
+{
+	for (int round = 0;round < 10;round++)
+	{
+		const uint64_t product = (uint64_t) 0xD256D193u * row;
+		row = (uint32_t) (product >> 32) ^ key ^ col;
+		col = (uint32_t) product;
+		key += 0x9E3779B9u;
+	}
+	return ((uint64_t) row << 32) | col;
+}
+
+// Uniform in [-0.5, 0.5) from the upper 53 bits
+static inline double counterValue(const uint64_t x)
+{
+	return (double) (x >> 11) * (1. / 9007199254740992.) - 0.5;
+}
+
+class HPL_pdmatgen_counter_impl
+{
+	double* const A;
+	const size_t LDA;
+	const int NB, mp, myrow, nprow, JJ;
+	const int* const colblocks;
+	const int* const rowblocks;
+	const uint32_t key;
+public:
+	HPL_pdmatgen_counter_impl(double* _A, size_t _LDA, int _NB, int _mp, int _myrow, int _nprow, int _JJ, const int* _colblocks, const int* _rowblocks, uint32_t _key)
+		: A(_A), LDA(_LDA), NB(_NB), mp(_mp), myrow(_myrow), nprow(_nprow), JJ(_JJ), colblocks(_colblocks), rowblocks(_rowblocks), key(_key)
+	{}
+
+	void operator()(const tbb::blocked_range<int> &range) const
+	{
+		for (int jj = range.begin();jj != range.end();jj++)
+		{
+			const uint32_t j = (uint32_t) colblocks[jj / NB] * NB + jj % NB;
+			double* __restrict__ col = A + (jj - JJ) * LDA;
+			for (int ii = 0;ii < mp;ii += NB)
+			{
+				const int ib = Mmin(NB, mp - ii);
+				const uint32_t i = (uint32_t) (rowblocks ? rowblocks[ii / NB] : (ii / NB) * nprow + myrow) * NB;
+				double* __restrict__ dst = col + ii;
+				//No dependency between the entries, the rounds vectorize across the rows
+				for (int ik = 0;ik < ib;ik++) dst[ik] = counterValue(philox2x32(i + ik, j, key));
+			}
+		}
+	}
+};
+
+/*
+ * Generates the local columns JJ:JJ+NQ-1 of the M by N matrix distributed like in
+ * HPL_pdmatgen, but with entries from a counter-based generator keyed by the global
+ * position instead of the HPL sequence. Column JJ is stored at A. The matrix is the
+ * same for every process grid and can be regenerated for any piece on demand.
+ */
+extern "C" void HPL_pdmatgen_counter(const HPL_T_grid* GRID, const int M, const int N, const int NB, double* A, const int LDA, const int ISEED, const int JJ, const int NQ)
+{
+	int mp, mycol, myrow, npcol, nprow;
+
+	(void) HPL_grid_info(GRID, &nprow, &npcol, &myrow, &mycol);
+	Mnumrow(mp, M, NB, myrow, nprow, GRID);
+
+	if (mp <= 0 || NQ <= 0) return;
+
+	std::vector<int> colblocks, rowblocks;
+	for (int jblk = 0;jblk < (N + NB - 1) / NB;jblk++)
+	{
+		if (MColBlockToPCol(jblk, GRID) == mycol) colblocks.push_back(jblk);
+	}
+	for (int iblk = 0;GRID->row_mapping && iblk < (M + NB - 1) / NB;iblk++)
+	{
+		if (GRID->row_mapping[iblk] == myrow) rowblocks.push_back(iblk);
+	}
+
+	tbb::parallel_for(tbb::blocked_range<int>(JJ, JJ + NQ), HPL_pdmatgen_counter_impl(A, LDA, NB, mp, myrow, nprow, JJ, &colblocks[0], rowblocks.empty() ? NULL : &rowblocks[0], (uint32_t) ISEED), tbb::auto_partitioner());
+}
@@ -0,0 +1,124 @@
+/**
+ * Calibration of the relative node performance for the weighted column mapping
+ *
+ * Copyright 2010:
+ *  - David Rohr (drohr@jwdt.org)
+ *  - Matthias Bach (bach@compeng.uni-frankfurt.de)
+ *  - Matthias Kretz (kretz@compeng.uni-frankfurt.de)
+ *
+ * This file is part of HPL-GPU.
+ *
+ * HPL-GPU is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * HPL-GPU is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with HPL-GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition to the rules layed out by the GNU General Public License
+ * the following exception is granted:
+ *
+ * Use with the Original BSD License.
+ *
+ * Notwithstanding any other provision of the GNU General Public License
+ * Version 3, you have permission to link or combine any covered work with
+ * a work licensed under the 4-clause BSD license into a single combined
+ * work, and to convey the resulting work.  The terms of this License will
+ * continue to apply to the part which is the covered work, but the special
+ * requirements of the 4-clause BSD license, clause 3, concerning the
+ * requirement of acknowledgement in advertising materials will apply to
+ * the combination as such.
+ */
+
+#include "hpl.h"
+#include "util_cal.h"
+#include "util_mempolicy.h"
+#include <unistd.h>
+
+#define HPL_CALIBRATE_REPEAT 3
+
+void HPL_pdcalibrate(HPL_T_test* TEST, const int NB)
+{
+	//HPL_CALIBRATE: time the update of a trailing matrix of order HPL_CALIBRATE on every rank, the DGEMM with panel width NB and the LASWP of the NB pivot rows.
+	//The best of HPL_CALIBRATE_REPEAT runs after a warm-up run is taken, the data is the same on every rank and every call, so the result is repeatable.
+	//The performance relative to the fastest rank replaces TEST->node_perf and is written to node-perf.dat.
+	int rank, size;
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+	const int n = global_runtime_config.calibrate, nb = Mmin(NB, n), ld = n;
+	const size_t bytes = ((size_t) ld * n + (size_t) ld * nb + (size_t) nb * n) * sizeof(double);
+
+	double* C = (double*) HPL_mem_alloc(bytes, 0, (size_t) ld * nb * sizeof(double), 0);
+	int* lindx = (int*) malloc(2 * nb * sizeof(int));
+	if (C == NULL || lindx == NULL) HPL_pabort(__LINE__, "HPL_pdcalibrate", "Memory allocation failed");
+	double* A = C + (size_t) ld * n;
+	double* B = A + (size_t) ld * nb;
+	for (size_t i = 0;i < (size_t) ld * n + (size_t) ld * nb + (size_t) nb * n;i++) C[i] = (double) (i % 1021) / 1021. - 0.5;
+	//Pivot rows spread over the trailing matrix, copied to U (B) like in HPL_pdgesv
+	for (int i = 0;i < nb;i++)
+	{
+		lindx[i] = (int) (((size_t) i * 7919) % n);
+		lindx[nb + i] = i;
+	}
+
+	double tdgemm = 0., tlaswp = 0.;
+	for (int k = 0;k <= HPL_CALIBRATE_REPEAT;k++)
+	{
+		double t = HPL_ptimer_walltime();
+		HPL_gpu_dgemm(HplColumnMajor, HplNoTrans, HplNoTrans, n, n, nb, -HPL_rone, A, ld, B, nb, HPL_rone, C, ld, 0, 0);
+		CALDGEMM_Finish();
+		t = HPL_ptimer_walltime() - t;
+		if (k == 1 || (k && t < tdgemm)) tdgemm = t;
+		t = HPL_ptimer_walltime();
+		HPL_dlaswp01T(nb, n, C, ld, B, n, lindx, lindx + nb);
+		t = HPL_ptimer_walltime() - t;
+		if (k == 1 || (k && t < tlaswp)) tlaswp = t;
+	}
+	HPL_mem_free(C);
+	free(lindx);
+
+	double perf = 1. / (tdgemm + tlaswp), maxperf;
+	MPI_Allreduce(&perf, &maxperf, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+	float node_perf = (float) Mmax(perf / maxperf, 0.01);
+	MPI_Allgather(&node_perf, 1, MPI_FLOAT, TEST->node_perf, 1, MPI_FLOAT, MPI_COMM_WORLD);
+
+	char hostname[256];
+	gethostname(hostname, 255);
+	hostname[255] = 0;
+	char* hostnames = rank == 0 ? (char*) malloc((size_t) size * 256) : NULL;
+	double* times = rank == 0 ? (double*) malloc(2 * size * sizeof(double)) : NULL;
+	double mytimes[2] = {tdgemm, tlaswp};
+	MPI_Gather(hostname, 256, MPI_CHAR, hostnames, 256, MPI_CHAR, 0, MPI_COMM_WORLD);
+	MPI_Gather(mytimes, 2, MPI_DOUBLE, times, 2, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+	if (rank == 0)
+	{
+		FILE* fp = fopen("node-perf.dat", "w");
+		if (fp == NULL) fprintf(stderr, "HPL_CALIBRATE: Error writing node-perf.dat\n");
+		else
+		{
+			fprintf(fp, "#Written by HPL_CALIBRATE=%d with NB %d, see the format description in the distributed node-perf.dat\n", n, nb);
+			fprintf(fp, "#Hosts running a single rank are identified by hostname, the others by /rank\n");
+		}
+		for (int i = 0;i < size;i++)
+		{
+			int ranks = 0;
+			for (int j = 0;j < size;j++) if (strcmp(hostnames + (size_t) i * 256, hostnames + (size_t) j * 256) == 0) ranks++;
+			if (fp)
+			{
+				if (ranks == 1) fprintf(fp, "%s %f\n", hostnames + (size_t) i * 256, TEST->node_perf[i]);
+				else fprintf(fp, "/%d %f\n", i, TEST->node_perf[i]);
+			}
+			fprintf(STD_OUT, "HPL_CALIBRATE: rank %d (%s) DGEMM %.1f GFlops, LASWP %.1f GB/s, performance %f\n", i, hostnames + (size_t) i * 256,
+				2. * (double) n * (double) n * (double) nb / times[2 * i] * 1e-9, 2. * (double) n * (double) nb * sizeof(double) / times[2 * i + 1] * 1e-9, TEST->node_perf[i]);
+		}
+		if (fp) fclose(fp);
+		free(hostnames);
+		free(times);
+	}
+}
@@ -66,6 +66,7 @@
 #endif
 #define _GNU_SOURCE
 #include <sched.h>
+#include <math.h>
 #ifdef HPL_GPU_TEMPERATURE_THRESHOLD
 #include "../../caldgemm/cmodules/util_adl.h"
 #endif
@@ -76,6 +77,155 @@ int HPL_init_laswp(void* ptr);
 
 pthread_mutex_t global_vt_mutex;
 
+void HPL_pddriver_mapping
+(
+   HPL_T_test *                     TEST,
+   HPL_T_grid *                     GRID,
+   const HPL_T_ORDER                pmapping,
+   const int                        N,
+   const int                        NB
+)
+{
+/*
+ * Distributes the matrix columns over the process columns according to
+ * the node performance. Allocates GRID->col_mapping and mcols_per_pcol,
+ * and the lookup tables col_count and col_prev derived from them.
+ * With HPL_NB_MULTIPLIER the columns are grouped into variable width
+ * blocks of the panel widths of the NB schedule (GRID->block_offset),
+ * every block goes to a single process column, and the rows of block b
+ * to process row b mod P (GRID->row_mapping and row_count). Every
+ * process computes the blocks, they only depend on N, NB and the
+ * runtime configuration.
+ * If the node performance differs between the process rows, the rows
+ * are distributed by weight as well, so slower process rows own fewer
+ * NB blocks (or variable width blocks) of rows.
+ */
+   int rank, nprow, npcol, myrow, mycol;
+   MPI_Comm_rank( MPI_COMM_WORLD, &rank );
+   (void) HPL_grid_info( GRID, &nprow, &npcol, &myrow, &mycol );
+   int mcols = (N + NB) / NB;
+   GRID->col_mapping = (int*) malloc(mcols * sizeof(int));
+   GRID->mcols_per_pcol = (int*) malloc(npcol * sizeof(int));
+   GRID->block_offset = (int*) malloc((mcols + 1) * sizeof(int));
+   GRID->row_mapping = GRID->row_count = NULL;
+   GRID->nblocks = 0;
+   for (int i = 0;i < mcols;GRID->nblocks++)
+   {
+      GRID->block_offset[GRID->nblocks] = i * NB;
+      i += Mmin(Mmax(HPL_pdgesv_get_nb(NB, N - i * NB) / NB, 1), mcols - i);
+   }
+   GRID->block_offset[GRID->nblocks] = mcols * NB;
+   if (GRID->nblocks == mcols)
+   {
+      //Uniform NB blocks
+      free(GRID->block_offset);
+      GRID->block_offset = NULL;
+      GRID->nblocks = 0;
+   }
+
+   //Slowest node of every process row, node_perf is the same in all processes
+   float* rows = (float*) malloc(nprow * sizeof(float));
+   int weighted_rows = 0;
+   for (int p = 0;p < nprow;p++) rows[p] = 1.;
+   for (int i = 0;i < npcol * nprow;i++)
+   {
+      const int p = pmapping == HPL_ROW_MAJOR ? i / npcol : i % nprow;
+      if (TEST->node_perf[i] < rows[p]) rows[p] = TEST->node_perf[i];
+   }
+   for (int p = 1;p < nprow;p++) if (rows[p] != rows[0]) weighted_rows = 1;
+
+   if (nprow > 1 && (GRID->block_offset || weighted_rows))
+   {
+      GRID->row_mapping = (int*) malloc(mcols * sizeof(int));
+      GRID->row_count = (int*) malloc((mcols + 1) * nprow * sizeof(int));
+      if (weighted_rows)
+      {
+         if (rank == 0)
+         {
+            int* count = (int*) malloc(nprow * sizeof(int));
+            HPL_rowmapping(TEST->outfp, GRID, N, NB, rows, GRID->row_mapping, count);
+            for (int p = 0;p < nprow;p++)
+            {
+               fprintfct(TEST->outfp, "Process row %d performance %f processes %d matrix rows\n", p, rows[p], count[p]);
+            }
+            free(count);
+         }
+         MPI_Bcast(GRID->row_mapping, mcols, MPI_INT, 0, GRID->all_comm);
+      }
+      else
+      {
+         for (int b = 0;b < GRID->nblocks;b++)
+         {
+            for (int i = GRID->block_offset[b] / NB;i < GRID->block_offset[b + 1] / NB;i++) GRID->row_mapping[i] = b % nprow;
+         }
+      }
+      HPL_rowmapping_tables(GRID, N, NB);
+   }
+   free(rows);
+   if (rank == 0)
+   {
+      float* cols = malloc(npcol * sizeof(float));
+      int nprocs = npcol * nprow;
+      for (int i = 0;i < npcol;i++) cols[i] = 1.;
+      for (int i = 0;i < nprocs;i++)
+      {
+         if (pmapping == HPL_ROW_MAJOR)
+         {
+            fprintfctd(TEST->outfp, "Node %d col %d perf %f/%f\n", i, i % npcol, TEST->node_perf[i], cols[i % npcol]);
+            if (TEST->node_perf[i] < cols[i % npcol]) cols[i % npcol] = TEST->node_perf[i];
+         }
+         else
+         {
+            fprintfctd(TEST->outfp, "Node %d col %d perf %f/%f\n", i, i / nprow, TEST->node_perf[i], cols[i / nprow]);
+            if (TEST->node_perf[i] < cols[i / nprow]) cols[i / nprow] = TEST->node_perf[i];
+         }
+      }
+      float max_perf = 0;
+      for (int i = 0;i < npcol;i++) if (cols[i] > max_perf) max_perf = cols[i];
+      for (int i = 0;i < npcol;i++) cols[i] /= max_perf;
+      max_perf = 0;
+      for (int i = 0;i < npcol;i++) max_perf += cols[i];
+      for (int i = 0;i < npcol;i++)
+      {
+         fprintfctd(TEST->outfp, "Process Col %d Performance %f (of %f total)\n", i, cols[i], max_perf);
+      }
+
+      HPL_colmapping(TEST->outfp, GRID, N, NB, cols, 0, NULL, GRID->col_mapping, GRID->mcols_per_pcol);
+
+      for (int i = 0;i < npcol;i++)
+      {
+         fprintfct(TEST->outfp, "Process col %d processes %d matrix cols\n", i, GRID->mcols_per_pcol[i]);
+      }
+
+      free(cols);
+   }
+
+   MPI_Bcast(GRID->col_mapping, mcols, MPI_INT, 0, GRID->all_comm);
+   MPI_Bcast(GRID->mcols_per_pcol, npcol, MPI_INT, 0, GRID->all_comm);
+
+   //Prefix counts of the local columns and the previous NB block of every process column, for constant time lookups
+   GRID->col_count = (int*) malloc((mcols + 1) * npcol * sizeof(int));
+   GRID->col_prev = (int*) malloc(mcols * sizeof(int));
+   HPL_colmapping_tables(GRID, N, NB);
+}
+
+void HPL_pddriver_unmapping
+(
+   HPL_T_grid *                     GRID
+)
+{
+/*
+ * Releases the tables allocated by HPL_pddriver_mapping.
+ */
+   free(GRID->col_mapping);
+   free(GRID->mcols_per_pcol);
+   free(GRID->col_count);
+   free(GRID->col_prev);
+   if (GRID->block_offset) free(GRID->block_offset);
+   if (GRID->row_mapping) free(GRID->row_mapping);
+   if (GRID->row_count) free(GRID->row_count);
+}
+
 int main
 (
    int                        ARGC,
@@ -209,6 +359,8 @@ HPLinpack benchmark input file
 	HPL_init_laswp(CALDGEMM_GetObject());
 #endif
 
+   if (global_runtime_config.calibrate) HPL_pdcalibrate( &test, nbval[0] );
+
 /*
  * Loop over different process grids - Define process grid. Go to bottom
  * of process grid loop if this case does not use my process.
@@ -231,6 +383,12 @@ HPLinpack benchmark input file
 
       for( in = 0; in < ns; in++ )
       {                            /* Loop over various problem sizes */
+       if (global_runtime_config.autotune)
+       {
+          HPL_pdtune( &test, &grid, pmapping, nval[in], seed, nbs, nbval, nbms, nbmval, ndvs, ndvval,
+                      npfs, pfaval, nrfs, rfaval, ntps, topval, ndhs, ndhval, align );
+          continue;
+       }
        for( inb = 0; inb < nbs; inb++ )
        {                        /* Loop over various blocking factors */
         for( indh = 0; indh < ndhs; indh++ )
@@ -270,91 +428,31 @@ HPLinpack benchmark input file
 #endif
 
               if (rank == 0) fprintfct(STD_OUT, "(Problem: N %d NB %d)(Network: BCAST %d LOOKAHEAD %d) (Factorization: NBMIN %d NBDIV %d PFACT %d RFACT %d)\n", nval[in], nbval[inb], algo.btopo, algo.depth, algo.nbmin, algo.nbdiv, algo.pfact, algo.rfact);
-   int mcols = (nval[in] + nbval[inb]) / nbval[inb];
-   grid.col_mapping = (int*) malloc(mcols * sizeof(int));
-   grid.mcols_per_pcol = (int*) malloc(npcol * sizeof(int));
-   if (rank == 0)
+   int N = nval[in];
+   if (global_runtime_config.n_auto && !global_runtime_config.ooc_path)
    {
-      float* cols = malloc(npcol * sizeof(float));
-      int nprocs = npcol * nprow;
-      if (nprocs > 1 && global_runtime_config.hpl_nb_multiplier_count)
-      {
-        fprintf(stderr, "HPL_NB_MULTIPLIER is currently only supported in single-node\n");
-        exit(1);
-      }
-      for (int i = 0;i < npcol;i++) cols[i] = 1.;
-      for (int i = 0;i < nprocs;i++)
-      {
-         if (pmapping == HPL_ROW_MAJOR)
-         {
-            fprintfctd(test.outfp, "Node %d col %d perf %f/%f\n", i, i % npcol, test.node_perf[i], cols[i % npcol]);
-            if (test.node_perf[i] < cols[i % npcol]) cols[i % npcol] = test.node_perf[i];
-         }
-         else
-         {
-            fprintfctd(test.outfp, "Node %d col %d perf %f/%f\n", i, i / nprow, test.node_perf[i], cols[i / nprow]);
-            if (test.node_perf[i] < cols[i / nprow]) cols[i / nprow] = test.node_perf[i];
-         }
-      }
-      float max_perf = 0;
-      for (int i = 0;i < npcol;i++) if (cols[i] > max_perf) max_perf = cols[i];
-      for (int i = 0;i < npcol;i++) cols[i] /= max_perf;
-      max_perf = 0;
-      for (int i = 0;i < npcol;i++) max_perf += cols[i];
-      for (int i = 0;i < npcol;i++)
-      {
-         fprintfctd(test.outfp, "Process Col %d Performance %f (of %f total)\n", i, cols[i], max_perf);
-      }
+      //Upper bound for the automatic N: the matrix alone has to fit into the memory of all processes.
+      //Out-of-core the matrix is on disk, the N of HPL.dat is the upper bound then.
+      N = (int) sqrt((double) global_runtime_config.n_auto * 1048576. * (double) (nprow * npcol) / (double) sizeof(double));
+   }
+   HPL_pddriver_mapping( &test, &grid, pmapping, N, nbval[inb] );
 
-      for (int i = 0;i < npcol;i++) grid.mcols_per_pcol[i] = 0;
-      int j = 0;
-      int lastcol = -1;
-      float relax = 0;
-      for (int i = 0;i < mcols;i++)
-      {
-         if (npcol == 1)
-         {
-            grid.col_mapping[i] = i % npcol;
-            grid.mcols_per_pcol[i % npcol]++;
-	    continue;
-         }
-         int jstart = j;
-         int round1 = 1;
-         while (i && (j == lastcol || cols[j] / max_perf * (float) (i + 1) < (float) grid.mcols_per_pcol[j] + 0.5 * (float) round1 - relax))
-         {
-            fprintfctd(test.outfp, "Skipping process col %d (desired mcols %f, present mcols %d)\n", j, cols[j] / max_perf * (float) (i + 1), grid.mcols_per_pcol[j]);
-            j++;
-            j = j % npcol;
-            if (j == jstart)
-            {
-               if (round1 > 0) round1 = 0;
-               else relax += 0.1;
-            }
-         }
-         grid.col_mapping[i] = j;
-         grid.mcols_per_pcol[j]++;
-         lastcol = j;
-         relax = 0;
-         fprintfctd(test.outfp, "Matrix col %d processed by process col %d (%d total matrix cols)\n", i, j, grid.mcols_per_pcol[j]);
-         j++;
-         j = j % npcol;
-      }
 
-      for (int i = 0;i < npcol;i++)
+   if (global_runtime_config.n_auto)
+   {
+      //The search uses the mapping of the upper bound, the run gets the mapping of the chosen N
+      const int Nmax = N;
+      N = HPL_pdtest_auto_n( &grid, &algo, N, nbval[inb], (size_t) global_runtime_config.n_auto * 1048576 );
+      if (rank == 0) fprintf(STD_OUT, "Automatic problem size for %d MiB per process: N %d\n", global_runtime_config.n_auto, N);
+      if (N != Nmax)
       {
-         fprintfct(test.outfp, "Process col %d processes %d matrix cols\n", i, grid.mcols_per_pcol[i]);
+         HPL_pddriver_unmapping( &grid );
+         HPL_pddriver_mapping( &test, &grid, pmapping, N, nbval[inb] );
       }
-
-      free(cols);
    }
 
-   MPI_Bcast(grid.col_mapping, mcols, MPI_INT, 0, grid.all_comm);
-   MPI_Bcast(grid.mcols_per_pcol, npcol, MPI_INT, 0, grid.all_comm);
-
-
-              HPL_pdtest( &test, &grid, &algo, nval[in], nbval[inb], seed );
-              free(grid.col_mapping);
-              free(grid.mcols_per_pcol);
+              HPL_pdtest( &test, &grid, &algo, N, nbval[inb], seed );
+              HPL_pddriver_unmapping( &grid );
 
 #ifdef TRACE_CALLS
               writeTraceCounters( "trace_counters", run, rank );
@@ -59,6 +59,7 @@
  * Include files
  */
 #include "hpl.h"
+#include "util_rules.h"
 #include <unistd.h>
 #include <stdlib.h>
 
@@ -114,6 +115,11 @@ void HPL_readruntimeconfig(void)
 
 	global_runtime_config.paramdefs = (char*) malloc(1);
 	global_runtime_config.paramdefs[0] = 0;
+#ifdef HPL_RULES
+	global_runtime_config.rules = strdup(HPL_RULES);
+#else
+	global_runtime_config.rules = strdup("");
+#endif
 #ifdef HPL_MPI_AFFINITY
 	{
 		int tmpcpus[] = HPL_MPI_AFFINITY;
@@ -138,6 +144,26 @@ void HPL_readruntimeconfig(void)
 #else
 	global_runtime_config.warmup = 0;
 #endif
+#ifdef HPL_WARMUP_N
+	global_runtime_config.warmup_n = HPL_WARMUP_N;
+#else
+	global_runtime_config.warmup_n = 0;
+#endif
+#ifdef HPL_N_AUTO
+	global_runtime_config.n_auto = HPL_N_AUTO;
+#else
+	global_runtime_config.n_auto = 0;
+#endif
+#ifdef HPL_OOC_PATH
+	global_runtime_config.ooc_path = strdup(HPL_OOC_PATH);
+#else
+	global_runtime_config.ooc_path = NULL;
+#endif
+#ifdef HPL_OOC_WINDOW
+	global_runtime_config.ooc_window = HPL_OOC_WINDOW;
+#else
+	global_runtime_config.ooc_window = 4;
+#endif
 #ifdef HPL_NUM_LASWP_CORES
     global_runtime_config.num_laswp_cores = HPL_NUM_LASWP_CORES;
 #else
@@ -186,9 +212,177 @@ void HPL_readruntimeconfig(void)
     global_runtime_config.interleave_memory = 1;
 #else
     global_runtime_config.interleave_memory = 0;
+#endif
+#ifdef HPL_MEM_HUGEPAGES
+    global_runtime_config.mem_hugepages = HPL_MEM_HUGEPAGES;
+#else
+    global_runtime_config.mem_hugepages = 0;
+#endif
+#ifdef HPL_MEM_PLACEMENT_MATRIX
+    global_runtime_config.mem_placement_matrix = HPL_MEM_PLACEMENT_MATRIX;
+#else
+    global_runtime_config.mem_placement_matrix = 0;
+#endif
+#ifdef HPL_MEM_PLACEMENT_PANEL
+    global_runtime_config.mem_placement_panel = HPL_MEM_PLACEMENT_PANEL;
+#else
+    global_runtime_config.mem_placement_panel = 0;
+#endif
+#ifdef HPL_MEM_REPORT
+    global_runtime_config.mem_report = 1;
+#else
+    global_runtime_config.mem_report = 0;
 #endif
     global_runtime_config.hpl_nb_multiplier_count = 0;
     for (i = 0;i < HPL_MAX_RUNTIME_CONFIG_ARRAY;i++) global_runtime_config.hpl_nb_multiplier_factor[i] = 1;
+#ifdef HPL_KERNEL_CAPTURE
+    global_runtime_config.kernel_capture = 1;
+#else
+    global_runtime_config.kernel_capture = 0;
+#endif
+#ifdef HPL_STREAMING_VERIFY
+    global_runtime_config.streaming_verify = 1;
+#else
+    global_runtime_config.streaming_verify = 0;
+#endif
+#ifdef HPL_LOOKAHEAD_2B
+    global_runtime_config.lookahead_2b = 1;
+#else
+    global_runtime_config.lookahead_2b = 0;
+#endif
+#ifdef HPL_LOOKAHEAD_2B_FIXED_STEPSIZE
+    global_runtime_config.lookahead_2b_fixed_stepsize = HPL_LOOKAHEAD_2B_FIXED_STEPSIZE;
+#else
+    global_runtime_config.lookahead_2b_fixed_stepsize = 0;
+#endif
+#ifdef HPL_LOOKAHEAD_2B_MULTIPLIER
+    global_runtime_config.lookahead_2b_multiplier = HPL_LOOKAHEAD_2B_MULTIPLIER;
+#else
+    global_runtime_config.lookahead_2b_multiplier = 3;
+#endif
+#ifdef HPL_LOCSWP_DEPTH
+    global_runtime_config.locswp_depth = HPL_LOCSWP_DEPTH;
+#else
+    global_runtime_config.locswp_depth = 32;
+#endif
+#ifdef HPL_MAX_MPI_SEND_SIZE
+    global_runtime_config.max_mpi_send_size = HPL_MAX_MPI_SEND_SIZE;
+#else
+    global_runtime_config.max_mpi_send_size = (4 * 1024 * 1024);
+#endif
+#ifdef HPL_MAX_MPI_BCAST_SIZE
+    global_runtime_config.max_mpi_bcast_size = HPL_MAX_MPI_BCAST_SIZE;
+#else
+    global_runtime_config.max_mpi_bcast_size = 0;
+#endif
+#ifdef HPL_RESTRICT_CPUS
+    global_runtime_config.restrict_cpus = HPL_RESTRICT_CPUS;
+#else
+    global_runtime_config.restrict_cpus = 2;
+#endif
+#ifdef HPL_HALF_BLOCKING
+    global_runtime_config.half_blocking = HPL_HALF_BLOCKING;
+#else
+    global_runtime_config.half_blocking = 0;
+#endif
+#ifdef HPL_START_PERCENTAGE
+    global_runtime_config.start_percentage = HPL_START_PERCENTAGE;
+#else
+    global_runtime_config.start_percentage = 0;
+#endif
+#ifdef HPL_START_COL
+    global_runtime_config.start_col = HPL_START_COL;
+#else
+    global_runtime_config.start_col = 0;
+#endif
+#ifdef HPL_END_N
+    global_runtime_config.end_n = HPL_END_N;
+#else
+    global_runtime_config.end_n = 0;
+#endif
+#ifdef HPL_ASYNC_DLATCPY
+    global_runtime_config.async_dlatcpy = 1;
+#else
+    global_runtime_config.async_dlatcpy = 0;
+#endif
+#ifdef HPL_COPYL_DURING_FACT
+    global_runtime_config.copyl_during_fact = 1;
+#else
+    global_runtime_config.copyl_during_fact = 0;
+#endif
+#ifdef HPL_PAUSE
+    global_runtime_config.pause = HPL_PAUSE;
+#else
+    global_runtime_config.pause = 0.;
+#endif
+#ifdef HPL_AUTOTUNE
+    global_runtime_config.autotune = 1;
+#else
+    global_runtime_config.autotune = 0;
+#endif
+#ifdef HPL_AUTOTUNE_WINDOW
+    global_runtime_config.autotune_window = HPL_AUTOTUNE_WINDOW;
+#else
+    global_runtime_config.autotune_window = 4;
+#endif
+#ifdef HPL_AUTOTUNE_SEGMENTS
+    global_runtime_config.autotune_segments = HPL_AUTOTUNE_SEGMENTS;
+#else
+    global_runtime_config.autotune_segments = 4;
+#endif
+    global_runtime_config.autotune_lookahead2_turnoff_count = 0;
+    global_runtime_config.autotune_lookahead3_turnoff_count = 0;
+    global_runtime_config.autotune_nb_multiplier_scale_count = 0;
+#ifdef HPL_ADAPTIVE_NB
+    global_runtime_config.adaptive_nb = HPL_ADAPTIVE_NB;
+#else
+    global_runtime_config.adaptive_nb = 0;
+#endif
+#ifdef HPL_ADAPTIVE_NB_INTERVAL
+    global_runtime_config.adaptive_nb_interval = HPL_ADAPTIVE_NB_INTERVAL;
+#else
+    global_runtime_config.adaptive_nb_interval = 4;
+#endif
+#ifdef HPL_ADAPTIVE_NB_RATIO
+    global_runtime_config.adaptive_nb_ratio = HPL_ADAPTIVE_NB_RATIO;
+#else
+    global_runtime_config.adaptive_nb_ratio = 50;
+#endif
+#ifdef HPL_REBALANCE
+    global_runtime_config.rebalance = HPL_REBALANCE;
+#else
+    global_runtime_config.rebalance = 0;
+#endif
+#ifdef HPL_REBALANCE_THRESHOLD
+    global_runtime_config.rebalance_threshold = HPL_REBALANCE_THRESHOLD;
+#else
+    global_runtime_config.rebalance_threshold = 10;
+#endif
+#ifdef HPL_REBALANCE_RESERVE
+    global_runtime_config.rebalance_reserve = HPL_REBALANCE_RESERVE;
+#else
+    global_runtime_config.rebalance_reserve = 10;
+#endif
+#ifdef HPL_CALIBRATE
+    global_runtime_config.calibrate = HPL_CALIBRATE;
+#else
+    global_runtime_config.calibrate = 0;
+#endif
+#ifdef HPL_TAIL_GATHER
+    global_runtime_config.tail_gather = HPL_TAIL_GATHER;
+#else
+    global_runtime_config.tail_gather = 0;
+#endif
+#ifdef HPL_SWAP
+    global_runtime_config.swap = HPL_SWAP;
+#else
+    global_runtime_config.swap = 1;
+#endif
+#ifdef HPL_SWAP_THRESHOLD
+    global_runtime_config.swap_threshold = HPL_SWAP_THRESHOLD;
+#else
+    global_runtime_config.swap_threshold = 64;
+#endif
 
     //Read HPL_GPU_CONFIG runtime config file
 #ifdef HPL_GPU_RUNTIME_CONFIG
@@ -356,6 +550,23 @@ finishline:
 	{
 		global_runtime_config.warmup = option[0] ? atoi(option) : 1;
 	}
+	else if (strcmp(cmd, "HPL_WARMUP_N") == 0)
+	{
+		global_runtime_config.warmup_n = atoi(option);
+	}
+	else if (strcmp(cmd, "HPL_N_AUTO") == 0)
+	{
+		global_runtime_config.n_auto = atoi(option);
+	}
+	else if (strcmp(cmd, "HPL_OOC_PATH") == 0)
+	{
+		free(global_runtime_config.ooc_path);
+		global_runtime_config.ooc_path = option[0] ? strdup(option) : NULL;
+	}
+	else if (strcmp(cmd, "HPL_OOC_WINDOW") == 0)
+	{
+		global_runtime_config.ooc_window = atoi(option);
+	}
 	else if (strcmp(cmd, "HPL_FASTRAND") == 0)
 	{
 		global_runtime_config.fastrand = option[0] ? atoi(option) : 2;
@@ -416,6 +627,150 @@ finishline:
 	{
 		global_runtime_config.interleave_memory = atoi(option);
 	}
+	else if (strcmp(cmd, "HPL_MEM_HUGEPAGES") == 0)
+	{
+		global_runtime_config.mem_hugepages = atoi(option);
+	}
+	else if (strcmp(cmd, "HPL_MEM_PLACEMENT_MATRIX") == 0)
+	{
+		global_runtime_config.mem_placement_matrix = atoi(option);
+	}
+	else if (strcmp(cmd, "HPL_MEM_PLACEMENT_PANEL") == 0)
+	{
+		global_runtime_config.mem_placement_panel = atoi(option);
+	}
+	else if (strcmp(cmd, "HPL_MEM_REPORT") == 0)
+	{
+		global_runtime_config.mem_report = option[0] ? atoi(option) : 1;
+	}
+	else if (strcmp(cmd, "HPL_KERNEL_CAPTURE") == 0)
+	{
+		global_runtime_config.kernel_capture = option[0] ? atoi(option) : 1;
+	}
+	else if (strcmp(cmd, "HPL_STREAMING_VERIFY") == 0)
+	{
+		global_runtime_config.streaming_verify = option[0] ? atoi(option) : 1;
+	}
+	else if (strcmp(cmd, "HPL_LOOKAHEAD_2B") == 0)
+	{
+		global_runtime_config.lookahead_2b = option[0] ? atoi(option) : 1;
+	}
+	else if (strcmp(cmd, "HPL_LOOKAHEAD_2B_FIXED_STEPSIZE") == 0)
+	{
+		global_runtime_config.lookahead_2b_fixed_stepsize = atoi(option);
+	}
+	else if (strcmp(cmd, "HPL_LOOKAHEAD_2B_MULTIPLIER") == 0)
+	{
+		global_runtime_config.lookahead_2b_multiplier = atoi(option);
+	}
+	else if (strcmp(cmd, "HPL_LOCSWP_DEPTH") == 0)
+	{
+		global_runtime_config.locswp_depth = atoi(option);
+	}
+	else if (strcmp(cmd, "HPL_MAX_MPI_SEND_SIZE") == 0)
+	{
+		global_runtime_config.max_mpi_send_size = atoi(option);
+	}
+	else if (strcmp(cmd, "HPL_MAX_MPI_BCAST_SIZE") == 0)
+	{
+		global_runtime_config.max_mpi_bcast_size = atoi(option);
+	}
+	else if (strcmp(cmd, "HPL_RESTRICT_CPUS") == 0)
+	{
+		global_runtime_config.restrict_cpus = atoi(option);
+	}
+	else if (strcmp(cmd, "HPL_HALF_BLOCKING") == 0)
+	{
+		global_runtime_config.half_blocking = atoi(option);
+	}
+	else if (strcmp(cmd, "HPL_START_PERCENTAGE") == 0)
+	{
+		global_runtime_config.start_percentage = atoi(option);
+	}
+	else if (strcmp(cmd, "HPL_START_COL") == 0)
+	{
+		global_runtime_config.start_col = atoi(option);
+	}
+	else if (strcmp(cmd, "HPL_END_N") == 0)
+	{
+		global_runtime_config.end_n = atoi(option);
+	}
+	else if (strcmp(cmd, "HPL_ASYNC_DLATCPY") == 0)
+	{
+		global_runtime_config.async_dlatcpy = option[0] ? atoi(option) : 1;
+	}
+	else if (strcmp(cmd, "HPL_COPYL_DURING_FACT") == 0)
+	{
+		global_runtime_config.copyl_during_fact = option[0] ? atoi(option) : 1;
+	}
+	else if (strcmp(cmd, "HPL_PAUSE") == 0)
+	{
+		global_runtime_config.pause = atof(option);
+	}
+	else if (strcmp(cmd, "HPL_AUTOTUNE") == 0)
+	{
+		global_runtime_config.autotune = option[0] ? atoi(option) : 1;
+	}
+	else if (strcmp(cmd, "HPL_AUTOTUNE_WINDOW") == 0)
+	{
+		global_runtime_config.autotune_window = atoi(option);
+	}
+	else if (strcmp(cmd, "HPL_AUTOTUNE_SEGMENTS") == 0)
+	{
+		global_runtime_config.autotune_segments = atoi(option);
+	}
+	else if (strcmp(cmd, "HPL_AUTOTUNE_LOOKAHEAD2_TURNOFF") == 0)
+	{
+		get_runtime_array(option, global_runtime_config.autotune_lookahead2_turnoff, &global_runtime_config.autotune_lookahead2_turnoff_count);
+	}
+	else if (strcmp(cmd, "HPL_AUTOTUNE_LOOKAHEAD3_TURNOFF") == 0)
+	{
+		get_runtime_array(option, global_runtime_config.autotune_lookahead3_turnoff, &global_runtime_config.autotune_lookahead3_turnoff_count);
+	}
+	else if (strcmp(cmd, "HPL_AUTOTUNE_NB_MULTIPLIER_SCALE") == 0)
+	{
+		get_runtime_array(option, global_runtime_config.autotune_nb_multiplier_scale, &global_runtime_config.autotune_nb_multiplier_scale_count);
+	}
+	else if (strcmp(cmd, "HPL_ADAPTIVE_NB") == 0)
+	{
+		global_runtime_config.adaptive_nb = atoi(option);
+	}
+	else if (strcmp(cmd, "HPL_ADAPTIVE_NB_INTERVAL") == 0)
+	{
+		global_runtime_config.adaptive_nb_interval = atoi(option);
+	}
+	else if (strcmp(cmd, "HPL_ADAPTIVE_NB_RATIO") == 0)
+	{
+		global_runtime_config.adaptive_nb_ratio = atoi(option);
+	}
+	else if (strcmp(cmd, "HPL_REBALANCE") == 0)
+	{
+		global_runtime_config.rebalance = atoi(option);
+	}
+	else if (strcmp(cmd, "HPL_REBALANCE_THRESHOLD") == 0)
+	{
+		global_runtime_config.rebalance_threshold = atoi(option);
+	}
+	else if (strcmp(cmd, "HPL_REBALANCE_RESERVE") == 0)
+	{
+		global_runtime_config.rebalance_reserve = atoi(option);
+	}
+	else if (strcmp(cmd, "HPL_CALIBRATE") == 0)
+	{
+		global_runtime_config.calibrate = atoi(option);
+	}
+	else if (strcmp(cmd, "HPL_TAIL_GATHER") == 0)
+	{
+		global_runtime_config.tail_gather = atoi(option);
+	}
+	else if (strcmp(cmd, "HPL_SWAP") == 0)
+	{
+		global_runtime_config.swap = atoi(option);
+	}
+	else if (strcmp(cmd, "HPL_SWAP_THRESHOLD") == 0)
+	{
+		global_runtime_config.swap_threshold = atoi(option);
+	}
 	else if (strcmp(cmd, "HPL_PARAMDEFS") == 0)
 	{
 		int len = strlen(option);
@@ -428,6 +783,18 @@ finishline:
 			strcat(global_runtime_config.paramdefs, option);
 		}
 	}
+	else if (strcmp(cmd, "HPL_RULE") == 0)
+	{
+		int len = strlen(option);
+		if (len)
+		{
+			if (strlen(global_runtime_config.rules)) len++;
+			len += strlen(global_runtime_config.rules);
+			global_runtime_config.rules = (char*) realloc(global_runtime_config.rules, len + 1);
+			if (strlen(global_runtime_config.rules)) strcat(global_runtime_config.rules, "\n");
+			strcat(global_runtime_config.rules, option);
+		}
+	}
 	else
 	{
 		HPL_fprintf(stderr, "Unknown HPL Runtime option: %s\n", cmd);
@@ -441,6 +808,23 @@ finishline:
 	{
 		global_runtime_config.warmup = atoi(envPtr);
 	}
+	if ((envPtr = getenv("HPL_WARMUP_N")))
+	{
+		global_runtime_config.warmup_n = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_N_AUTO")))
+	{
+		global_runtime_config.n_auto = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_OOC_PATH")))
+	{
+		free(global_runtime_config.ooc_path);
+		global_runtime_config.ooc_path = envPtr[0] ? strdup(envPtr) : NULL;
+	}
+	if ((envPtr = getenv("HPL_OOC_WINDOW")))
+	{
+		global_runtime_config.ooc_window = atoi(envPtr);
+	}
 	if ((envPtr = getenv("HPL_FASTRAND")))
 	{
 		global_runtime_config.fastrand = atoi(envPtr);
@@ -501,6 +885,150 @@ finishline:
 	{
 		global_runtime_config.interleave_memory = atoi(envPtr);
 	}
+	if ((envPtr = getenv("HPL_MEM_HUGEPAGES")))
+	{
+		global_runtime_config.mem_hugepages = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_MEM_PLACEMENT_MATRIX")))
+	{
+		global_runtime_config.mem_placement_matrix = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_MEM_PLACEMENT_PANEL")))
+	{
+		global_runtime_config.mem_placement_panel = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_MEM_REPORT")))
+	{
+		global_runtime_config.mem_report = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_KERNEL_CAPTURE")))
+	{
+		global_runtime_config.kernel_capture = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_STREAMING_VERIFY")))
+	{
+		global_runtime_config.streaming_verify = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_LOOKAHEAD_2B")))
+	{
+		global_runtime_config.lookahead_2b = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_LOOKAHEAD_2B_FIXED_STEPSIZE")))
+	{
+		global_runtime_config.lookahead_2b_fixed_stepsize = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_LOOKAHEAD_2B_MULTIPLIER")))
+	{
+		global_runtime_config.lookahead_2b_multiplier = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_LOCSWP_DEPTH")))
+	{
+		global_runtime_config.locswp_depth = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_MAX_MPI_SEND_SIZE")))
+	{
+		global_runtime_config.max_mpi_send_size = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_MAX_MPI_BCAST_SIZE")))
+	{
+		global_runtime_config.max_mpi_bcast_size = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_RESTRICT_CPUS")))
+	{
+		global_runtime_config.restrict_cpus = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_HALF_BLOCKING")))
+	{
+		global_runtime_config.half_blocking = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_START_PERCENTAGE")))
+	{
+		global_runtime_config.start_percentage = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_START_COL")))
+	{
+		global_runtime_config.start_col = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_END_N")))
+	{
+		global_runtime_config.end_n = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_ASYNC_DLATCPY")))
+	{
+		global_runtime_config.async_dlatcpy = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_COPYL_DURING_FACT")))
+	{
+		global_runtime_config.copyl_during_fact = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_PAUSE")))
+	{
+		global_runtime_config.pause = atof(envPtr);
+	}
+	if ((envPtr = getenv("HPL_AUTOTUNE")))
+	{
+		global_runtime_config.autotune = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_AUTOTUNE_WINDOW")))
+	{
+		global_runtime_config.autotune_window = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_AUTOTUNE_SEGMENTS")))
+	{
+		global_runtime_config.autotune_segments = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_AUTOTUNE_LOOKAHEAD2_TURNOFF")))
+	{
+		get_runtime_array(envPtr, global_runtime_config.autotune_lookahead2_turnoff, &global_runtime_config.autotune_lookahead2_turnoff_count);
+	}
+	if ((envPtr = getenv("HPL_AUTOTUNE_LOOKAHEAD3_TURNOFF")))
+	{
+		get_runtime_array(envPtr, global_runtime_config.autotune_lookahead3_turnoff, &global_runtime_config.autotune_lookahead3_turnoff_count);
+	}
+	if ((envPtr = getenv("HPL_AUTOTUNE_NB_MULTIPLIER_SCALE")))
+	{
+		get_runtime_array(envPtr, global_runtime_config.autotune_nb_multiplier_scale, &global_runtime_config.autotune_nb_multiplier_scale_count);
+	}
+	if ((envPtr = getenv("HPL_ADAPTIVE_NB")))
+	{
+		global_runtime_config.adaptive_nb = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_ADAPTIVE_NB_INTERVAL")))
+	{
+		global_runtime_config.adaptive_nb_interval = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_ADAPTIVE_NB_RATIO")))
+	{
+		global_runtime_config.adaptive_nb_ratio = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_REBALANCE")))
+	{
+		global_runtime_config.rebalance = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_REBALANCE_THRESHOLD")))
+	{
+		global_runtime_config.rebalance_threshold = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_REBALANCE_RESERVE")))
+	{
+		global_runtime_config.rebalance_reserve = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_CALIBRATE")))
+	{
+		global_runtime_config.calibrate = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_TAIL_GATHER")))
+	{
+		global_runtime_config.tail_gather = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_SWAP")))
+	{
+		global_runtime_config.swap = atoi(envPtr);
+	}
+	if ((envPtr = getenv("HPL_SWAP_THRESHOLD")))
+	{
+		global_runtime_config.swap_threshold = atoi(envPtr);
+	}
 	if ((envPtr = getenv("HPL_PARAMDEFS")))
 	{
 		int len = strlen(envPtr);
@@ -513,7 +1041,60 @@ finishline:
 			strcat(global_runtime_config.paramdefs, envPtr);
 		}
 	}
+	if ((envPtr = getenv("HPL_RULE")))
+	{
+		int len = strlen(envPtr);
+		if (len)
+		{
+			if (strlen(global_runtime_config.rules)) len++;
+			len += strlen(global_runtime_config.rules);
+			global_runtime_config.rules = (char*) realloc(global_runtime_config.rules, len + 1);
+			if (strlen(global_runtime_config.rules)) strcat(global_runtime_config.rules, "\n");
+			strcat(global_runtime_config.rules, envPtr);
+		}
+	}
 #endif
+	//The local swap of the panel factorization is instantiated only for these unroll depths
+	const int locswp_depth = global_runtime_config.locswp_depth;
+	if (locswp_depth < 1 || locswp_depth > 64 || (locswp_depth & (locswp_depth - 1)))
+	{
+		HPL_fprintf(stderr, "Invalid HPL_LOCSWP_DEPTH %d, must be a power of 2 between 1 and 64\n", locswp_depth);
+		exit(1);
+	}
+	//The MPI wrappers split messages into chunks of this size, 0 would never advance
+	if (global_runtime_config.max_mpi_send_size <= 0 || global_runtime_config.max_mpi_bcast_size < 0)
+	{
+		HPL_fprintf(stderr, "Invalid HPL_MAX_MPI_SEND_SIZE %d / HPL_MAX_MPI_BCAST_SIZE %d, must be positive (0 for the broadcast uses the send size)\n", global_runtime_config.max_mpi_send_size, global_runtime_config.max_mpi_bcast_size);
+		exit(1);
+	}
+	//The LASWP pipeline advances by the step size, which is multiplied by the multiplier after every chunk
+	if (global_runtime_config.lookahead_2b_fixed_stepsize < 0 || global_runtime_config.lookahead_2b_multiplier < 1)
+	{
+		HPL_fprintf(stderr, "Invalid HPL_LOOKAHEAD_2B_FIXED_STEPSIZE %d / HPL_LOOKAHEAD_2B_MULTIPLIER %d, the step size must not be negative (0 for automatic) and the multiplier at least 1\n", global_runtime_config.lookahead_2b_fixed_stepsize, global_runtime_config.lookahead_2b_multiplier);
+		exit(1);
+	}
+	//Options that cannot be combined, checked on every rank before the first collective
+	if (global_runtime_config.adaptive_nb && (global_runtime_config.hpl_nb_multiplier_count || global_runtime_config.half_blocking))
+	{
+		HPL_fprintf(stderr, "HPL_ADAPTIVE_NB cannot be combined with HPL_NB_MULTIPLIER or HPL_HALF_BLOCKING\n");
+		exit(1);
+	}
+	if (global_runtime_config.rebalance && (global_runtime_config.ooc_path || global_runtime_config.fastrand == 2))
+	{
+		HPL_fprintf(stderr, "HPL_REBALANCE cannot be combined with HPL_OOC_PATH or HPL_FASTRAND=2\n");
+		exit(1);
+	}
+	if (global_runtime_config.tail_gather && global_runtime_config.ooc_path)
+	{
+		HPL_fprintf(stderr, "HPL_TAIL_GATHER cannot be combined with HPL_OOC_PATH\n");
+		exit(1);
+	}
+	if (global_runtime_config.swap < 0 || global_runtime_config.swap > 2)
+	{
+		HPL_fprintf(stderr, "HPL_SWAP must be 0 (binary exchange), 1 (spread and roll) or 2 (mix)\n");
+		exit(1);
+	}
+	if (HPL_rules_parse(global_runtime_config.rules)) exit(1);
 }
 
 void HPL_pdinfo
@@ -899,10 +1480,7 @@ void HPL_pdinfo
  * Checking threshold value (TEST->thrsh)
  */
       (void) fgets( line, HPL_LINE_MAX - 2, infp );
-#if defined(HPL_START_PERCENTAGE) | defined(HPL_END_N)
-      TEST->thrsh = -1;
-#else
-	  if (global_runtime_config.fastrand == 1)
+	  if (global_runtime_config.fastrand == 1 || global_runtime_config.start_percentage || global_runtime_config.start_col || global_runtime_config.end_n)
 	  {
 		  TEST->thrsh = -1;
 	  }
@@ -910,7 +1488,6 @@ void HPL_pdinfo
 	  {
          (void) sscanf( line, "%s", num ); TEST->thrsh = atof( num );
 	  }
-#endif
 
 /*
  * Panel factorization algorithm (PF)
@@ -62,14 +62,15 @@
 #include "hpl.h"
 #include <sys/mman.h>
 #include "util_cal.h"
+#include "util_capture.h"
+#include "util_mempolicy.h"
+#include "util_ooc.h"
 #include <pthread.h>
 #include <unistd.h>
 #include <math.h>
 
 #include "fastmatgen.h"
 
-extern int max_gpu_nb_factor;
-
 void debugmatgen(HPL_T_grid* GRID, HPL_T_pmat* A)
 {
 	srand(453534);
@@ -88,6 +89,237 @@ void debugmatgen(HPL_T_grid* GRID, HPL_T_pmat* A)
 	}
 }
 
+#ifndef HPL_STREAMING_VERIFY_WIDTH
+#define HPL_STREAMING_VERIFY_WIDTH 32
+#endif
+
+void HPL_pdtest_streamverify(HPL_T_grid* GRID, HPL_T_pmat* mat, const int nq, const int SEED, double* AX, double* Anorm1, double* AnormI)
+{
+	//Regenerate A a few local columns at a time, accumulate the sums of |a_ij| per column and per row for the norms and the local part of A x in AX.
+	//On the process column owning b, b is regenerated into its place after the local columns of A.
+	const int N = mat->n, NB = mat->nb, mp = mat->mp;
+	const int ld = Mmax(1, mp);
+	void (*matgen)(const HPL_T_grid*, const int, const int, const int, double*, const int, const int, const int, const int) = global_runtime_config.fastrand == 3 ? HPL_pdmatgen_counter : HPL_pdmatgen_cols;
+	double* buffer = (double*) malloc((size_t) ld * HPL_STREAMING_VERIFY_WIDTH * sizeof(double));
+	double* rowsum = (double*) malloc(ld * sizeof(double));
+	double* colsum = (double*) malloc(Mmax(1, nq) * sizeof(double));
+	if (buffer == NULL || rowsum == NULL || colsum == NULL) HPL_pabort(__LINE__, "HPL_pdtest_streamverify", "Memory allocation failed for streaming verification");
+
+	for (int i = 0;i < mp;i++) AX[i] = rowsum[i] = HPL_rzero;
+	for (int jj = 0;jj < nq;jj += HPL_STREAMING_VERIFY_WIDTH)
+	{
+		const int jb = Mmin(HPL_STREAMING_VERIFY_WIDTH, nq - jj);
+		matgen(GRID, N, N + 1, NB, buffer, ld, SEED, jj, jb);
+		for (int j = 0;j < jb;j++)
+		{
+			const double* col = buffer + (size_t) j * ld;
+			double sum = HPL_rzero;
+			for (int i = 0;i < mp;i++)
+			{
+				sum += Mabs(col[i]);
+				rowsum[i] += Mabs(col[i]);
+			}
+			colsum[jj + j] = sum;
+		}
+		if (mp > 0) HPL_dgemv(HplColumnMajor, HplNoTrans, mp, jb, HPL_rone, buffer, ld, mat->X + jj, 1, HPL_rone, AX, 1);
+	}
+	if (GRID->mycol == HPL_indxg2p_col(N, NB, GRID)) matgen(GRID, N, N + 1, NB, Mptr(mat->A, 0, nq, mat->ld), mat->ld, SEED, nq, 1);
+
+	//Same reductions as HPL_pdlange: sum the column sums within the process column and the row sums within the process row, then take the maximum
+	*Anorm1 = HPL_rzero;
+	if (nq > 0)
+	{
+		(void) HPL_all_reduce((void*) colsum, nq, HPL_DOUBLE, HPL_sum, GRID->col_comm);
+		for (int j = 0;j < nq;j++) if (colsum[j] > *Anorm1) *Anorm1 = colsum[j];
+	}
+	(void) HPL_all_reduce((void*) Anorm1, 1, HPL_DOUBLE, HPL_max, GRID->row_comm);
+	*AnormI = HPL_rzero;
+	if (mp > 0)
+	{
+		(void) HPL_all_reduce((void*) rowsum, mp, HPL_DOUBLE, HPL_sum, GRID->row_comm);
+		for (int i = 0;i < mp;i++) if (rowsum[i] > *AnormI) *AnormI = rowsum[i];
+	}
+	(void) HPL_all_reduce((void*) AnormI, 1, HPL_DOUBLE, HPL_max, GRID->col_comm);
+
+	free(buffer);
+	free(rowsum);
+	free(colsum);
+}
+
+static void HPL_pdtest_matgen(HPL_T_grid* GRID, HPL_T_pmat* mat, const int SEED)
+{
+	//Generate [ A | b ] with the generator selected by HPL_FASTRAND
+	if (global_runtime_config.fastrand == 0)
+	{
+		HPL_pdmatgen(GRID, mat->n, mat->n + 1, mat->nb, mat->A, mat->ld, SEED);
+	}
+	else if (global_runtime_config.fastrand == 3)
+	{
+		HPL_pdmatgen_counter(GRID, mat->n, mat->n + 1, mat->nb, mat->A, mat->ld, SEED, 0, HPL_numcol(mat->n + 1, mat->nb, GRID->mycol, GRID));
+	}
+	else
+	{
+#ifndef QON_TEST
+		fastmatgen(SEED + GRID->myrow * GRID->npcol + GRID->mycol, mat->A, mat->X - mat->A);
+#else
+		debugmatgen(GRID, mat);
+#endif
+	}
+}
+
+static int HPL_pdtest_lda(HPL_T_palg* ALGO, const int mp)
+{
+	//Ensure that lda is a multiple of ALIGN and not a power of 2, and an uneven multiple of cache line size
+	int ld, ii, ip2;
+	ld = ( ( Mmax( 1, mp ) - 1 ) / ALGO->align ) * ALGO->align;
+	if (ld % 64) ld += 64 - ld % 64;
+	if (ld % 128 == 0) ld += 64;
+	do
+	{
+		ii = ( ld += ALGO->align ); ip2 = 1;
+		while( ii > 1 ) { ii >>= 1; ip2 <<= 1; }
+	}
+	while( ld == ip2 );
+	return(ld);
+}
+
+static void HPL_pdtest_free(void* vptr, void* pptr)
+{
+	//In out-of-core mode the matrix is a file mapping and the panel memory a separate allocation
+	if (pptr) HPL_mem_free(pptr);
+	if (vptr == NULL) return;
+	if (HPL_ooc_active()) HPL_ooc_free(vptr);
+	else HPL_mem_free(vptr);
+}
+
+size_t HPL_pdtest_memory(HPL_T_grid* GRID, HPL_T_palg* ALGO, const int N, const int NB)
+{
+	//Bytes allocated by HPL_pdtest on this process: [ A | b ] unless it is out-of-core, the panel arena, the binary exchange buffers and the matrix of a separate warmup run
+	int mp = HPL_numrow(N, NB, GRID->myrow, GRID->nprow, GRID);
+	int nq = HPL_numcol(N, NB, GRID->mycol, GRID) + 1;
+	if (global_runtime_config.rebalance) nq += (nq - 1) * global_runtime_config.rebalance_reserve / 100;
+	size_t bytes = global_runtime_config.ooc_path ? 0 : ((size_t)(ALGO->align) + (size_t)(HPL_pdtest_lda(ALGO, mp) + 1) * (size_t)(nq)) * sizeof(double);
+	bytes += panel_estimate_max_size(GRID, ALGO, N, NB);
+	bytes += HPL_pdlaswp00T_memory(GRID, N, NB);
+	const int warmup_n = global_runtime_config.warmup ? Mmin(global_runtime_config.warmup_n, N) : 0;
+	if (warmup_n > 0)
+	{
+		mp = HPL_numrow(warmup_n, NB, GRID->myrow, GRID->nprow, GRID);
+		nq = HPL_numcol(warmup_n, NB, GRID->mycol, GRID) + 1;
+		bytes += ((size_t)(ALGO->align) + (size_t)(HPL_pdtest_lda(ALGO, mp) + 1) * (size_t)(nq)) * sizeof(double);
+	}
+	return(bytes);
+}
+
+int HPL_pdtest_auto_n(HPL_T_grid* GRID, HPL_T_palg* ALGO, const int NMAX, const int NB, const size_t BYTES)
+{
+	//Largest multiple of NB up to NMAX for which HPL_pdtest fits into BYTES on every process
+	int lo = 0, hi = NMAX / NB;
+	while (lo < hi)
+	{
+		const int mid = (lo + hi + 1) / 2;
+		int fail = HPL_pdtest_memory(GRID, ALGO, mid * NB, NB) > BYTES;
+		(void) HPL_all_reduce((void*) &fail, 1, HPL_INT, HPL_max, GRID->all_comm);
+		if (fail) hi = mid - 1;
+		else lo = mid;
+	}
+	return(lo * NB);
+}
+
+double HPL_pdtest_flops(const int N, const int J0, const int J1)
+{
+	//Flops of the factorization steps for the columns J0 to J1, with 2/3 n^3 + 3/2 n^2 for the remaining order n as in the Gflops of the full run
+	const double n0 = N - J0, n1 = N - J1;
+	return((2.0 / 3.0) * (n0 * n0 * n0 - n1 * n1 * n1) + (3.0 / 2.0) * (n0 * n0 - n1 * n1));
+}
+
+int HPL_pdtest_column(const int N, const double PERCENTAGE)
+{
+	//Column at which the given percentage of the factorization work is done, the remaining work scales with the cube of the remaining order
+	if (PERCENTAGE >= 100.) return(N);
+	return(N - (int) ((double) N * cbrt(1. - PERCENTAGE / 100.)));
+}
+
+double HPL_pdtest_estimate(const HPL_T_grid* GRID, const int N, const int NB, const int COUNT, const int* n, const int* jb, const double* time)
+{
+	//Estimate the time of the full factorization from the iterations of a partial run. The time of an iteration is modeled as a * flops + b * n,
+	//the second term covering the panel factorization, row swaps and broadcasts, which scale with the remaining order n for a fixed panel width.
+	//a and b are fitted by least squares. If the fit is degenerate or yields a negative term, the time is scaled with the flops only.
+	double sff = 0., sfg = 0., sgg = 0., sft = 0., sgt = 0., a, b;
+	int i, j, jj;
+	for (i = 0;i < COUNT;i++)
+	{
+		const double f = HPL_pdtest_flops(N, N - n[i], N - n[i] + jb[i]), g = n[i];
+		sff += f * f; sfg += f * g; sgg += g * g;
+		sft += f * time[i]; sgt += g * time[i];
+	}
+	const double det = sff * sgg - sfg * sfg;
+	a = b = -1.;
+	if (COUNT >= 2 && det > 1e-9 * sff * sgg)
+	{
+		a = (sft * sgg - sgt * sfg) / det;
+		b = (sgt * sff - sft * sfg) / det;
+	}
+	if (a <= 0. || b < 0.)
+	{
+		if (sff <= 0.) return(0.);
+		a = sft / sff;
+		b = 0.;
+	}
+
+	double total = 0.;
+	for (j = 0;j < N;j += jj)
+	{
+		jj = HPL_pdgesv_get_width(GRID, NB, j, N - j);
+		total += a * HPL_pdtest_flops(N, j, j + jj) + b * (double) (N - j);
+	}
+	return(total);
+}
+
+int HPL_pdtest_windows(HPL_T_grid* GRID, HPL_T_palg* ALGO, const int N, const int NB, const int SEED, const int NWIN, const int* JSTART, const int* JEND, double* TIME, double* FLOPS)
+{
+	//Run the factorization from column JSTART[i] up to column JEND[i] on a freshly generated matrix each, for the autotuner.
+	//Returns the maximum wall time over all processes and the flops of the columns actually processed, or nonzero if the matrix does not fit.
+	HPL_T_pmat mat;
+	int info, i, j0, j1;
+	double t;
+	mat.n = N; mat.nb = NB; mat.info = 0;
+	mat.mp = HPL_numrow(N, NB, GRID->myrow, GRID->nprow, GRID);
+	mat.nq = HPL_numcol(N, NB, GRID->mycol, GRID) + 1;
+	mat.ld = HPL_pdtest_lda(ALGO, mat.mp);
+	const size_t matrix_size = (size_t)(ALGO->align) + (size_t)(mat.ld + 1) * (size_t)(mat.nq);
+	void* vptr = HPL_mem_alloc(matrix_size * sizeof(double), panel_estimate_max_size(GRID, ALGO, N, NB), (size_t) mat.ld * NB * sizeof(double), global_runtime_config.interleave_memory == 2);
+	info = vptr == NULL;
+	(void) HPL_all_reduce((void*) &info, 1, HPL_INT, HPL_max, GRID->all_comm);
+	if (info)
+	{
+		if (vptr) HPL_mem_free(vptr);
+		return(1);
+	}
+	mat.A = (double*) HPL_PTR(vptr, ((size_t)(ALGO->align) * sizeof(double)));
+	mat.X = Mptr(mat.A, 0, mat.nq, mat.ld);
+
+	panel_preset_pointers(((double*) vptr) + matrix_size);
+	HPL_pdgesv_prepare_panel(GRID, ALGO, &mat);
+	for (i = 0;i < NWIN;i++)
+	{
+		if (i) panel_preset_pointers(((double*) vptr) + matrix_size);
+		HPL_pdtest_matgen(GRID, &mat, SEED);
+		CALDGEMM_reset();
+		HPL_barrier(GRID->all_comm);
+		t = HPL_ptimer_walltime();
+		HPL_pdgesv(GRID, ALGO, &mat, 0, JSTART[i], JEND[i]);
+		t = HPL_ptimer_walltime() - t;
+		(void) HPL_all_reduce((void*) &t, 1, HPL_DOUBLE, HPL_max, GRID->all_comm);
+		HPL_pdgesv_window(&j0, &j1);
+		TIME[i] = t;
+		FLOPS[i] = HPL_pdtest_flops(N, j0, j1);
+	}
+	HPL_pdgesv_delete_panel();
+	HPL_mem_free(vptr);
+	return(0);
+}
+
 void HPL_pdtest
 (
    HPL_T_test *                     TEST,
@@ -156,17 +388,21 @@ void HPL_pdtest
 #ifdef HPL_DETAILED_TIMING
    double                     HPL_w[HPL_TIMING_N];
    double                     HPL_c[HPL_TIMING_N];
+   double                     HPL_wpiv, HPL_cpiv;
+   double                     HPL_wooc, HPL_cooc;
 #endif
    HPL_T_pmat                 mat;
    double                     walltime[1];
    double                     cputime[1];
    int                        info[3];
    double                     Anorm1 = 0, AnormI = 0, Gflops, Xnorm1 = 0, XnormI = 0,
-                              BnormI = 0, resid0 = 0, resid1 = 0;
-   double                     * Bptr;
-   void                       * vptr = NULL;
+                              BnormI = 0, resid0 = 0, resid1 = 0, norms[3];
+   double                     * Bptr, * AX = NULL;
+   void                       * vptr = NULL, * pptr = NULL;
+   double                     * panel_base;
    static int                 first=1;
-   int                        ii, ip2, mycol, myrow, npcol, nprow, nq;
+   static int                 capture_run=0;
+   int                        ii, mycol, myrow, npcol, nprow, nq;
    char                       ctop, cpfact, crfact;
    
    int mp;
@@ -178,31 +414,22 @@ void HPL_pdtest
    (void) HPL_grid_info( GRID, &nprow, &npcol, &myrow, &mycol );
 
    mat.n  = N; mat.nb = NB; mat.info = 0;
-   mat.mp = HPL_numrow( N, NB, myrow, nprow );
+   mat.mp = HPL_numrow( N, NB, myrow, nprow, GRID );
    nq     = HPL_numcol( N, NB, mycol, GRID );
    mat.nq = nq + 1;
+   if (global_runtime_config.rebalance) mat.nq += nq * global_runtime_config.rebalance_reserve / 100;
 /*
  * Allocate matrix, right-hand-side, and vector solution x. [ A | b ] is
  * N by N+1.  One column is added in every process column for the solve.
  * The  result  however  is stored in a 1 x N vector replicated in every
  * process row. In every process, A is lda * (nq+1), x is 1 * nq and the
  * workspace is mp. 
+ * With HPL_REBALANCE, A gets HPL_REBALANCE_RESERVE percent additional
+ * columns for the block columns migrated to this process column.
  *
  * Ensure that lda is a multiple of ALIGN and not a power of 2
  */
- 
-   mat.ld = ( ( Mmax( 1, mat.mp ) - 1 ) / ALGO->align ) * ALGO->align;
-   
-   //Make sure LDA is an uneven multiple of cache line size
-   if (mat.ld % 64) mat.ld += 64 - mat.ld % 64;
-   if (mat.ld % 128 == 0) mat.ld += 64;
-   
-   do
-   {
-      ii = ( mat.ld += ALGO->align ); ip2 = 1;
-      while( ii > 1 ) { ii >>= 1; ip2 <<= 1; }
-   }
-   while( mat.ld == ip2 );
+   mat.ld = HPL_pdtest_lda( ALGO, mat.mp );
 /*
  * Allocate dynamic memory
  */
@@ -225,15 +452,25 @@ void HPL_pdtest
       printf("Row %d Col %d Host %s Size %lld\n", myrow, mycol, hostname, (long long int) matrix_bytes);
    }
 #endif
-   size_t total_bytes = matrix_bytes + panel_estimate_max_size(GRID, ALGO, N, N + 1, NB * max_gpu_nb_factor);
-   if (myrow == 0 && mycol == 0) fprintf(stderr, "Allocating memory: %lld bytes...", (long long int) total_bytes);
+   size_t total_bytes = matrix_bytes + panel_estimate_max_size(GRID, ALGO, N, NB);
+   if (myrow == 0 && mycol == 0) fprintf(stderr, "Allocating memory: %lld bytes%s...", (long long int) total_bytes, global_runtime_config.ooc_path ? " (matrix out-of-core)" : "");
    HPL_barrier( GRID->all_comm );
-   vptr = CALDGEMM_alloc( total_bytes, interleave);
+   if (global_runtime_config.ooc_path)
+   {
+      vptr = HPL_ooc_alloc( matrix_bytes );
+      pptr = HPL_mem_alloc( 0, total_bytes - matrix_bytes, 0, interleave );
+      panel_base = (double*) pptr;
+   }
+   else
+   {
+      vptr = HPL_mem_alloc( matrix_bytes, total_bytes - matrix_bytes, (size_t) mat.ld * NB * sizeof(double), interleave );
+      panel_base = ((double*) vptr) + matrix_size;
+   }
    HPL_barrier( GRID->all_comm );
    if (myrow == 0 && mycol == 0) fprintf(stderr, "\n");
-   panel_preset_pointers(((double*) vptr) + matrix_size);
+   panel_preset_pointers(panel_base);
                          
-   info[0] = (vptr == NULL); info[1] = myrow; info[2] = mycol;
+   info[0] = (vptr == NULL || (global_runtime_config.ooc_path && pptr == NULL)); info[1] = myrow; info[2] = mycol;
    (void) HPL_all_reduce( (void *)(info), 3, HPL_INT, HPL_max,
                           GRID->all_comm );
    if( info[0] != 0 )
@@ -243,6 +480,7 @@ void HPL_pdtest
                     "[%d,%d] %s", info[1], info[2],
                     "Memory allocation failed for A, x and b. Skip." );
       (TEST->kskip)++;
+      HPL_pdtest_free( vptr, pptr );
       return;
    }
 
@@ -252,19 +490,19 @@ void HPL_pdtest
  */
    mat.A  = (double *) HPL_PTR( vptr, ((size_t)(ALGO->align) * sizeof(double) ) );
    mat.X  = Mptr( mat.A, 0, mat.nq, mat.ld );
-   
-   if (global_runtime_config.fastrand == 0)
-   {
-	  HPL_pdmatgen( GRID, N, N+1, NB, mat.A, mat.ld, SEED );
-   }
-   else
-   {
-#ifndef QON_TEST
-      fastmatgen( SEED + myrow * npcol + mycol, mat.A, mat.X - mat.A);
-#else
-      debugmatgen(GRID, &mat);
-#endif
-   }
+/*
+ * With a separate warmup problem, the full matrix is generated only once,
+ * after the warmup iteration, instead of before and after it.
+ */
+   const int warmup_n = global_runtime_config.warmup ? Mmin( global_runtime_config.warmup_n, N ) : 0;
+   if (warmup_n <= 0) HPL_pdtest_matgen( GRID, &mat, SEED );
+/*
+ * Partial run: start at HPL_START_COL or at the column where
+ * HPL_START_PERCENTAGE of the work is done, stop at column HPL_END_N.
+ */
+   const int jstart = global_runtime_config.start_col ? global_runtime_config.start_col :
+      ( global_runtime_config.start_percentage ? HPL_pdtest_column( N, global_runtime_config.start_percentage ) : 0 );
+   const int jend = global_runtime_config.end_n;
 
 /*
  * Solve linear system
@@ -278,24 +516,41 @@ void HPL_pdtest
    {
 	   if (myrow == 0 && mycol == 0) HPL_fprintf(TEST->outfp, "\nRunning warmup iteration\n");
 	   CALDGEMM_reset();
-	   HPL_pdgesv(GRID, ALGO, &mat, 1);
-       
-	   if (global_runtime_config.fastrand == 0)
+	   if (warmup_n > 0)
 	   {
-	      HPL_pdmatgen(GRID, N, N + 1, NB, mat.A, mat.ld, SEED);
+	      //Warm up on a small matrix of its own, the full matrix is generated afterwards
+	      HPL_T_pmat wmat;
+	      wmat.n = warmup_n; wmat.nb = NB; wmat.info = 0;
+	      wmat.mp = HPL_numrow( warmup_n, NB, myrow, nprow, GRID );
+	      wmat.nq = HPL_numcol( warmup_n, NB, mycol, GRID ) + 1;
+	      wmat.ld = HPL_pdtest_lda( ALGO, wmat.mp );
+	      void* wptr = HPL_mem_alloc( ((size_t)(ALGO->align) + (size_t)(wmat.ld+1) * (size_t)(wmat.nq)) * sizeof(double), 0, (size_t) wmat.ld * NB * sizeof(double), interleave );
+	      if (wptr == NULL) HPL_pabort( __LINE__, "HPL_pdtest", "Memory allocation failed for warmup matrix" );
+	      wmat.A = (double *) HPL_PTR( wptr, ((size_t)(ALGO->align) * sizeof(double) ) );
+	      wmat.X = Mptr( wmat.A, 0, wmat.nq, wmat.ld );
+	      HPL_pdtest_matgen( GRID, &wmat, SEED );
+	      HPL_pdgesv(GRID, ALGO, &wmat, 1, 0, 0);
+	      HPL_mem_free( wptr );
+	      HPL_pdtest_matgen( GRID, &mat, SEED );
 	   }
 	   else
 	   {
-#ifndef QON_TEST
-	      fastmatgen( SEED + myrow * npcol + mycol, mat.A, mat.X - mat.A);
-#else
-	      debugmatgen(GRID, &mat);
-#endif
+	      HPL_pdgesv(GRID, ALGO, &mat, 1, jstart, jend);
+	      HPL_pdtest_matgen( GRID, &mat, SEED );
 	   }
-	   panel_preset_pointers(((double*)vptr) + matrix_size);
+	   panel_preset_pointers(panel_base);
 	   if (myrow == 0 && mycol == 0) HPL_fprintf(TEST->outfp, "\n");
 	   HPL_barrier(GRID->all_comm);
    }
+/*
+ * Report the placement once the pages are touched: the matrix after its
+ * generation, the panel arena after the first run that used it.
+ */
+   if (global_runtime_config.mem_report)
+   {
+      if (!global_runtime_config.ooc_path) HPL_mem_report( "matrix", vptr, matrix_bytes, myrow, mycol );
+      if (global_runtime_config.warmup) HPL_mem_report( "panel", panel_base, total_bytes - matrix_bytes, myrow, mycol );
+   }
 
    CALDGEMM_reset();
    if (global_runtime_config.duration_find_helper)
@@ -307,9 +562,14 @@ void HPL_pdtest
       }
       HPL_barrier( GRID->all_comm );
    }
+   if (global_runtime_config.kernel_capture) openCaptureFile( "kernel_capture", capture_run++, GRID->iam );
+   HPL_ooc_reset_stats();
    HPL_ptimer( 0 );
-   HPL_pdgesv( GRID, ALGO, &mat, 0 );
+   HPL_pdgesv( GRID, ALGO, &mat, 0, jstart, jend );
    HPL_ptimer( 0 );
+   nq = HPL_numcol( N, NB, mycol, GRID ); /* HPL_REBALANCE may have moved block columns */
+   if (global_runtime_config.kernel_capture) closeCaptureFile();
+   if (global_runtime_config.mem_report && !global_runtime_config.warmup) HPL_mem_report( "panel", panel_base, total_bytes - matrix_bytes, myrow, mycol );
    if (global_runtime_config.duration_find_helper)
    {
       if (myrow == 0 && mycol == 0)
@@ -320,6 +580,33 @@ void HPL_pdtest
       HPL_barrier( GRID->all_comm );
    }
    HPL_pdgesv_delete_panel();
+   {
+      //Reserved and peak used panel memory, maximum over all processes
+      double panelmem[2] = { (double) panel_arena_reserved(), (double) panel_arena_peak() };
+      (void) HPL_all_reduce( (void*) panelmem, 2, HPL_DOUBLE, HPL_max, GRID->all_comm );
+      if (myrow == 0 && mycol == 0) HPL_fprintf( TEST->outfp, "Panel memory: %.1f MiB reserved, %.1f MiB peak use\n", panelmem[0] / 1048576., panelmem[1] / 1048576. );
+   }
+   if (global_runtime_config.ooc_path)
+   {
+      //I/O thread busy time, time the factorization waited for read-ahead, and traffic, maximum over all processes
+      double oocstats[4];
+      HPL_ooc_stats( &oocstats[0], &oocstats[1], &oocstats[2], &oocstats[3] );
+      (void) HPL_all_reduce( (void*) oocstats, 4, HPL_DOUBLE, HPL_max, GRID->all_comm );
+      if (myrow == 0 && mycol == 0) HPL_fprintf( TEST->outfp, "Out-of-core: I/O %.2f s, stalled %.2f s (%.1f%% overlapped), %.1f GiB read, %.1f GiB written\n",
+         oocstats[0], oocstats[1], oocstats[0] > 0. ? 100. * (1. - oocstats[1] / oocstats[0]) : 100., oocstats[2] / 1073741824., oocstats[3] / 1073741824. );
+   }
+   if (global_runtime_config.rebalance && myrow == 0 && mycol == 0)
+   {
+      //Measured throughput of the process columns relative to the fastest one
+      const float* weights;
+      const int applied = HPL_pdrebalance_weights( &weights );
+      if (weights)
+      {
+         HPL_fprintf( TEST->outfp, "Effective process column weights%s:", applied ? "" : " (mapping kept)" );
+         for (ii = 0;ii < npcol;ii++) HPL_fprintf( TEST->outfp, " %.3f", weights[ii] );
+         HPL_fprintf( TEST->outfp, "\n" );
+      }
+   }
 
 /*
  * Gather max of all CPU and WALL clock timings and print timing results
@@ -328,6 +615,27 @@ void HPL_pdtest
                        1, 0, walltime );
    HPL_ptimer_combine( GRID->all_comm, HPL_AMAX_PTIME, HPL_CPU_TIME,
                        1, 0, cputime );
+/*
+ * Partial run: exact flops of the processed columns, and the full run time
+ * estimated from the iteration times (maximum over all processes)
+ */
+   int wstart, wend, partial;
+   double wflops, westimate = HPL_rzero;
+   HPL_pdgesv_window( &wstart, &wend );
+   wflops = HPL_pdtest_flops( N, wstart, wend );
+   partial = wstart > 0 || wend < N;
+   if( partial )
+   {
+      const int * itn, * itjb;
+      const double * ittime;
+      const int its = HPL_pdgesv_iterations( &itn, &itjb, &ittime );
+      double * itmax = (double *) malloc( (size_t) Mmax( its, 1 ) * sizeof( double ) );
+      if( itmax == NULL ) HPL_pabort( __LINE__, "HPL_pdtest", "Memory allocation failed for iteration times" );
+      for( ii = 0; ii < its; ii++ ) itmax[ii] = ittime[ii];
+      if( its > 0 ) (void) HPL_all_reduce( (void *) itmax, its, HPL_DOUBLE, HPL_max, GRID->all_comm );
+      westimate = HPL_pdtest_estimate( GRID, N, NB, its, itn, itjb, itmax );
+      free( itmax );
+   }
                        
    fflush(stdout);
    MPI_Barrier( GRID->all_comm );
@@ -349,11 +657,14 @@ void HPL_pdtest
       }
 /*
  * 2/3 N^3 - 1/2 N^2 flops for LU factorization + 2 N^2 flops for solve.
- * Print WALL time
+ * Print WALL time. A partial run reports the rate of the columns it did.
  */
-      Gflops = ( ( (double)(N) /   1.0e+9 ) * 
-                 ( (double)(N) / walltime[0] ) ) * 
-                 ( ( 2.0 / 3.0 ) * (double)(N) + ( 3.0 / 2.0 ) );
+      if( partial )
+         Gflops = wflops / walltime[0] / 1.0e+9;
+      else
+         Gflops = ( ( (double)(N) /   1.0e+9 ) * 
+                    ( (double)(N) / walltime[0] ) ) * 
+                    ( ( 2.0 / 3.0 ) * (double)(N) + ( 3.0 / 2.0 ) );
 
       cpfact = ( ( (HPL_T_FACT)(ALGO->pfact) == 
                    (HPL_T_FACT)(HPL_LEFT_LOOKING) ) ?  (char)('L') :
@@ -378,6 +689,11 @@ void HPL_pdtest
              ( GRID->order == HPL_ROW_MAJOR ? 'R' : 'C' ),
              ALGO->depth, ctop, crfact, ALGO->nbdiv, cpfact, ALGO->nbmin,
              N, NB, nprow, npcol, walltime[0], cputime[0], Gflops );
+      if( partial )
+         HPL_fprintf( TEST->outfp,
+             "Partial run: columns %d to %d, %.4e flops (%.2f %% of the full run), estimated full run %.2f s, %.2f Gflops\n",
+             wstart, wend, wflops, 100.0 * wflops / HPL_pdtest_flops( N, 0, N ), westimate,
+             westimate > HPL_rzero ? HPL_pdtest_flops( N, 0, N ) / westimate / 1.0e+9 : HPL_rzero );
 #ifdef HPL_PRINT_AVG_MATRIX_SIZE
       float avgSize = (float) ( N ) * N * 8 / nprow / npcol / 1024 / 1024 / 1024;
       HPL_fprintf( TEST->outfp, "Avg. matri size per node: %.2f GiB\n", avgSize );
@@ -388,6 +704,14 @@ void HPL_pdtest
                        HPL_TIMING_N, HPL_TIMING_BEG, HPL_w );
    HPL_ptimer_combine( GRID->all_comm, HPL_AMAX_PTIME, HPL_CPU_TIME,
                        HPL_TIMING_N, HPL_TIMING_BEG, HPL_c );
+   HPL_ptimer_combine( GRID->all_comm, HPL_AMAX_PTIME, HPL_WALL_PTIME,
+                       1, HPL_TIMING_PIVINDEX, &HPL_wpiv );
+   HPL_ptimer_combine( GRID->all_comm, HPL_AMAX_PTIME, HPL_CPU_PTIME,
+                       1, HPL_TIMING_PIVINDEX, &HPL_cpiv );
+   HPL_ptimer_combine( GRID->all_comm, HPL_AMAX_PTIME, HPL_WALL_PTIME,
+                       1, HPL_TIMING_OOCWAIT, &HPL_wooc );
+   HPL_ptimer_combine( GRID->all_comm, HPL_AMAX_PTIME, HPL_CPU_PTIME,
+                       1, HPL_TIMING_OOCWAIT, &HPL_cooc );
    if( ( myrow == 0 ) && ( mycol == 0 ) )
    {
       HPL_fprintf( TEST->outfp, "%s%s\n",
@@ -420,6 +744,20 @@ void HPL_pdtest
                       HPL_w[HPL_TIMING_LASWP-HPL_TIMING_BEG], HPL_c[HPL_TIMING_LASWP-HPL_TIMING_BEG],
                       HPL_c[HPL_TIMING_LASWP-HPL_TIMING_BEG] / HPL_w[HPL_TIMING_LASWP-HPL_TIMING_BEG]
                  );
+/*
+ * Update (pivot index arrays)
+ */
+      if( HPL_wpiv > HPL_rzero )
+         HPL_fprintf( TEST->outfp,
+                      "+ Max aggregated wall time pividx  . : %18.2f %6.2f %4.2f\n",
+                      HPL_wpiv, HPL_cpiv, HPL_cpiv / HPL_wpiv );
+/*
+ * Waiting for out-of-core read-ahead
+ */
+      if( HPL_wooc > HPL_rzero )
+         HPL_fprintf( TEST->outfp,
+                      "+ Max aggregated wall time ooc wait  : %18.2f %6.2f %4.2f\n",
+                      HPL_wooc, HPL_cooc, HPL_cooc / HPL_wooc );
 /*
  * Upper triangular system solve
  */
@@ -440,7 +778,7 @@ void HPL_pdtest
  * Quick return, if I am not interested in checking the computations
  */
    if( TEST->thrsh <= HPL_rzero )
-   { (TEST->kpass)++; if( vptr ) CALDGEMM_free( vptr ); return; }
+   { (TEST->kpass)++; HPL_pdtest_free( vptr, pptr ); return; }
 /*
  * Check info returned by solve
  */
@@ -450,18 +788,30 @@ void HPL_pdtest
          HPL_pwarn( TEST->outfp, __LINE__, "HPL_pdtest", "%s %d, %s", 
                     "Error code returned by solve is", mat.info, "fail" );
       //(TEST->kskip)++;
-      if( vptr ) CALDGEMM_free( vptr );
+      HPL_pdtest_free( vptr, pptr );
    }
    else
    {
 /*
  * Check computation, re-generate [ A | b ], compute norm 1 and inf of A and x,
- * and norm inf of b - A x. Display residual checks.
+ * and norm inf of b - A x. Display residual checks. The streaming verifica-
+ * tion regenerates A piece by piece, computing the norms and A x on the fly.
  */
-   if (global_runtime_config.fastrand < 2)
+   const int streamverify = global_runtime_config.streaming_verify && (global_runtime_config.fastrand < 2 || global_runtime_config.fastrand == 3);
+   if (streamverify)
+   {
+      AX = (double*) malloc( Mmax( 1, mat.mp ) * sizeof(double) );
+      if( AX == NULL ) HPL_pabort( __LINE__, "HPL_pdtest", "Memory allocation failed for streaming verification" );
+      HPL_pdtest_streamverify( GRID, &mat, nq, SEED, AX, &Anorm1, &AnormI );
+   }
+   else if (global_runtime_config.fastrand < 2)
    {
       HPL_pdmatgen( GRID, N, N+1, NB, mat.A, mat.ld, SEED );
    }
+   else if (global_runtime_config.fastrand == 3)
+   {
+      HPL_pdmatgen_counter( GRID, N, N+1, NB, mat.A, mat.ld, SEED, 0, HPL_numcol( N+1, NB, mycol, GRID ) );
+   }
    else
    {
 #ifndef QON_TEST
@@ -471,7 +821,7 @@ void HPL_pdtest
 #endif
    }
 
-   Mnumrow( mp, 1, NB, myrow, nprow );
+   Mnumrow( mp, 1, NB, myrow, nprow, GRID );
    Mnumcol( nq, N, NB, mycol, GRID );
    if( mp )
    {
@@ -482,13 +832,16 @@ void HPL_pdtest
 	}
    }
 
-   Anorm1 = HPL_pdlange( GRID, HPL_NORM_1, N, N, NB, mat.A, mat.ld );
-   AnormI = HPL_pdlange( GRID, HPL_NORM_I, N, N, NB, mat.A, mat.ld );
+   if (!streamverify)
+   {
+      HPL_pdlange_fused( GRID, N, N, NB, mat.A, mat.ld, norms );
+      Anorm1 = norms[0]; AnormI = norms[1];
+   }
 /*
  * Because x is distributed in process rows, switch the norms
  */
-   XnormI = HPL_pdlange( GRID, HPL_NORM_1, 1, N, NB, mat.X, 1 );
-   Xnorm1 = HPL_pdlange( GRID, HPL_NORM_I, 1, N, NB, mat.X, 1 );
+   HPL_pdlange_fused( GRID, 1, N, NB, mat.X, 1, norms );
+   XnormI = norms[0]; Xnorm1 = norms[1];
 /*
  * If I am in the col that owns b, (1) compute local BnormI, (2) all_reduce to
  * find the max (in the col). Then (3) broadcast along the rows so that every
@@ -512,7 +865,13 @@ void HPL_pdtest
 /*
  * If I own b, compute ( b - A x ) and ( - A x ) otherwise
  */
-   if( mycol == HPL_indxg2p_col( N, NB, GRID ) )
+   if (streamverify)
+   {
+      if( mycol == HPL_indxg2p_col( N, NB, GRID ) ) { for( ii = 0; ii < mat.mp; ii++ ) Bptr[ii] -= AX[ii]; }
+      else { for( ii = 0; ii < mat.mp; ii++ ) Bptr[ii] = -AX[ii]; }
+      free( AX );
+   }
+   else if( mycol == HPL_indxg2p_col( N, NB, GRID ) )
    {
       HPL_dgemv( HplColumnMajor, HplNoTrans, mat.mp, nq, -HPL_rone,
                  mat.A, mat.ld, mat.X, 1, HPL_rone, Bptr, 1 );
@@ -605,7 +964,7 @@ void HPL_pdtest
          "========================================",
          "========================================" );
    }
-   if( vptr ) CALDGEMM_free( vptr );
+   HPL_pdtest_free( vptr, pptr );
 /*
  * End of HPL_pdtest
  */
@@ -0,0 +1,229 @@
+/**
+ * Autotuner: successive halving over the HPL.dat parameter lists on partial runs
+ *
+ * Copyright 2010:
+ *  - David Rohr (drohr@jwdt.org)
+ *  - Matthias Bach (bach@compeng.uni-frankfurt.de)
+ *  - Matthias Kretz (kretz@compeng.uni-frankfurt.de)
+ *
+ * This file is part of HPL-GPU.
+ *
+ * HPL-GPU is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * HPL-GPU is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with HPL-GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition to the rules layed out by the GNU General Public License
+ * the following exception is granted:
+ *
+ * Use with the Original BSD License.
+ *
+ * Notwithstanding any other provision of the GNU General Public License
+ * Version 3, you have permission to link or combine any covered work with
+ * a work licensed under the 4-clause BSD license into a single combined
+ * work, and to convey the resulting work.  The terms of this License will
+ * continue to apply to the part which is the covered work, but the special
+ * requirements of the 4-clause BSD license, clause 3, concerning the
+ * requirement of acknowledgement in advertising materials will apply to
+ * the combination as such.
+ */
+
+#include "hpl.h"
+
+typedef struct
+{
+	int nb, nbmin, nbdiv, depth;
+	HPL_T_FACT pfact, rfact;
+	HPL_T_TOP btopo;
+	int lookahead2_turnoff, lookahead3_turnoff, nb_multiplier_scale;
+	double gflops;
+} HPL_T_tune;
+
+static int HPL_pdtune_compare(const void* a, const void* b)
+{
+	const double ga = ((const HPL_T_tune*) a)->gflops, gb = ((const HPL_T_tune*) b)->gflops;
+	return(ga > gb ? -1 : (ga < gb ? 1 : 0));
+}
+
+static double HPL_pdtune_run(HPL_T_grid* GRID, const HPL_T_ORDER PMAPPING, HPL_T_test* TEST, const HPL_T_tune* cand, const int N, const int SEED, const int ALIGN, const double WINDOW)
+{
+	//Estimate the Gflops of the full run of a candidate from one window at the start of each of the HPL_AUTOTUNE_SEGMENTS segments of equal work.
+	//Every window covers WINDOW percent of the total work split evenly over the segments, the time of each segment is extrapolated from its window.
+	const int segments = WINDOW >= 100. ? 1 : Mmin(Mmax(global_runtime_config.autotune_segments, 1), HPL_MAX_PARAM);
+	int jstart[HPL_MAX_PARAM], jend[HPL_MAX_PARAM], s;
+	double segflops[HPL_MAX_PARAM], wtime[HPL_MAX_PARAM], wflops[HPL_MAX_PARAM];
+	for (s = 0;s < segments;s++)
+	{
+		const int p0 = s * 100 / segments, p1 = (s + 1) * 100 / segments;
+		jstart[s] = HPL_pdtest_column(N, p0);
+		jend[s] = Mmax(HPL_pdtest_column(N, Mmin((double) p0 + WINDOW / segments, (double) p1)), HPL_pdtest_column(N, p0) + 1);
+		segflops[s] = HPL_pdtest_flops(N, HPL_pdtest_column(N, p0), HPL_pdtest_column(N, p1));
+	}
+
+	HPL_T_palg algo;
+	algo.btopo = cand->btopo; algo.depth = cand->depth;
+	algo.nbmin = cand->nbmin; algo.nbdiv = cand->nbdiv;
+	algo.pfact = cand->pfact;
+	if( cand->pfact == HPL_LEFT_LOOKING ) algo.pffun = HPL_pdpanllT;
+	else if( cand->pfact == HPL_CROUT   ) algo.pffun = HPL_pdpancrT;
+	else                                  algo.pffun = HPL_pdpanrlT;
+	algo.rfact = cand->rfact;
+	if( cand->rfact == HPL_LEFT_LOOKING ) algo.rffun = HPL_pdrpanllT;
+	else if( cand->rfact == HPL_CROUT   ) algo.rffun = HPL_pdrpancrT;
+	else                                  algo.rffun = HPL_pdrpanrlT;
+	algo.align = ALIGN;
+
+	const int lookahead2_turnoff = global_runtime_config.lookahead2_turnoff, lookahead3_turnoff = global_runtime_config.lookahead3_turnoff;
+	const int rebalance = global_runtime_config.rebalance;
+	int thresholds[HPL_MAX_RUNTIME_CONFIG_ARRAY];
+	for (s = 0;s < global_runtime_config.hpl_nb_multiplier_count;s++)
+	{
+		thresholds[s] = global_runtime_config.hpl_nb_multiplier_threshold[s];
+		global_runtime_config.hpl_nb_multiplier_threshold[s] = (int) ((double) thresholds[s] * cand->nb_multiplier_scale / 100.);
+	}
+	global_runtime_config.lookahead2_turnoff = cand->lookahead2_turnoff;
+	global_runtime_config.lookahead3_turnoff = cand->lookahead3_turnoff;
+	//The windows are too short to measure the throughput, and the candidates are compared on the same mapping
+	global_runtime_config.rebalance = 0;
+
+	HPL_pddriver_mapping(TEST, GRID, PMAPPING, N, cand->nb);
+	const int fail = HPL_pdtest_windows(GRID, &algo, N, cand->nb, SEED, segments, jstart, jend, wtime, wflops);
+	HPL_pddriver_unmapping(GRID);
+
+	global_runtime_config.lookahead2_turnoff = lookahead2_turnoff;
+	global_runtime_config.lookahead3_turnoff = lookahead3_turnoff;
+	global_runtime_config.rebalance = rebalance;
+	for (s = 0;s < global_runtime_config.hpl_nb_multiplier_count;s++) global_runtime_config.hpl_nb_multiplier_threshold[s] = thresholds[s];
+	if (fail) return(0.);
+
+	double total = 0.;
+	for (s = 0;s < segments;s++)
+	{
+		if (wflops[s] <= 0.) return(0.);
+		total += wtime[s] * segflops[s] / wflops[s];
+	}
+	return(total > 0. ? HPL_pdtest_flops(N, 0, N) / total / 1.0e+9 : 0.);
+}
+
+void HPL_pdtune
+(
+   HPL_T_test *                     TEST,
+   HPL_T_grid *                     GRID,
+   const HPL_T_ORDER                PMAPPING,
+   const int                        N,
+   const int                        SEED,
+   const int                        NBS,
+   const int *                      NB,
+   const int                        NBMS,
+   const int *                      NBM,
+   const int                        NDVS,
+   const int *                      NDV,
+   const int                        NPFS,
+   const HPL_T_FACT *               PF,
+   const int                        NRFS,
+   const HPL_T_FACT *               RF,
+   const int                        NTPS,
+   const HPL_T_TOP *                TP,
+   const int                        NDHS,
+   const int *                      DH,
+   const int                        ALIGN
+)
+{
+/*
+ * Purpose
+ * =======
+ *
+ * HPL_pdtune searches the cross product of the parameter lists of
+ * HPL.dat and of the HPL_AUTOTUNE_* lists of HPL-GPU.conf for the best
+ * configuration of problem size N by successive halving. Every round
+ * scores all remaining candidates on partial runs, keeps the better half
+ * and doubles the window, until one candidate is left or the windows
+ * cover the full run. The winner is printed as HPL.dat and HPL-GPU.conf
+ * fragments.
+ *
+ * ---------------------------------------------------------------------
+ */
+	const int n2 = Mmax(global_runtime_config.autotune_lookahead2_turnoff_count, 1);
+	const int n3 = Mmax(global_runtime_config.autotune_lookahead3_turnoff_count, 1);
+	const int nm = global_runtime_config.hpl_nb_multiplier_count ? Mmax(global_runtime_config.autotune_nb_multiplier_scale_count, 1) : 1;
+	const int ncand = NBS * NBMS * NDVS * NPFS * NRFS * NTPS * NDHS * n2 * n3 * nm;
+	int i, i2, i3, im, inb, inbm, indv, ipfa, irfa, itop, indh, round;
+	const int root = GRID->myrow == 0 && GRID->mycol == 0;
+
+	HPL_T_tune* cand = (HPL_T_tune*) malloc(ncand * sizeof(HPL_T_tune));
+	if (cand == NULL) HPL_pabort(__LINE__, "HPL_pdtune", "Memory allocation failed for autotuning candidates");
+	i = 0;
+	for (inb = 0;inb < NBS;inb++) for (inbm = 0;inbm < NBMS;inbm++) for (indv = 0;indv < NDVS;indv++)
+	for (ipfa = 0;ipfa < NPFS;ipfa++) for (irfa = 0;irfa < NRFS;irfa++) for (itop = 0;itop < NTPS;itop++) for (indh = 0;indh < NDHS;indh++)
+	for (i2 = 0;i2 < n2;i2++) for (i3 = 0;i3 < n3;i3++) for (im = 0;im < nm;im++)
+	{
+		cand[i].nb = NB[inb]; cand[i].nbmin = NBM[inbm]; cand[i].nbdiv = NDV[indv];
+		cand[i].pfact = PF[ipfa]; cand[i].rfact = RF[irfa]; cand[i].btopo = TP[itop]; cand[i].depth = DH[indh];
+		cand[i].lookahead2_turnoff = global_runtime_config.autotune_lookahead2_turnoff_count ? global_runtime_config.autotune_lookahead2_turnoff[i2] : global_runtime_config.lookahead2_turnoff;
+		cand[i].lookahead3_turnoff = global_runtime_config.autotune_lookahead3_turnoff_count ? global_runtime_config.autotune_lookahead3_turnoff[i3] : global_runtime_config.lookahead3_turnoff;
+		cand[i].nb_multiplier_scale = global_runtime_config.autotune_nb_multiplier_scale_count ? global_runtime_config.autotune_nb_multiplier_scale[im] : 100;
+		cand[i].gflops = 0.;
+		i++;
+	}
+
+	if (root) HPL_fprintf(TEST->outfp, "\nAutotuning N %d: %d candidates, %d segments, initial window %.1f %% of the work\n", N, ncand,
+		Mmax(global_runtime_config.autotune_segments, 1), (double) global_runtime_config.autotune_window);
+	int alive = ncand;
+	double window = Mmax(global_runtime_config.autotune_window, 1);
+	if (global_runtime_config.warmup) (void) HPL_pdtune_run(GRID, PMAPPING, TEST, &cand[0], N, SEED, ALIGN, window);
+	for (round = 0;;round++)
+	{
+		if (window > 100.) window = 100.;
+		for (i = 0;i < alive;i++) cand[i].gflops = HPL_pdtune_run(GRID, PMAPPING, TEST, &cand[i], N, SEED, ALIGN, window);
+		qsort(cand, alive, sizeof(HPL_T_tune), HPL_pdtune_compare);
+		if (root)
+		{
+			HPL_fprintf(TEST->outfp, "Autotuning round %d, window %.1f %%:\n", round, window);
+			HPL_fprintf(TEST->outfp, "      NB  NBMIN  NDIV  PFACT  RFACT  BCAST  DEPTH  LA2OFF  LA3OFF  NBMSCALE    est. Gflops\n");
+			for (i = 0;i < alive;i++)
+			{
+				HPL_fprintf(TEST->outfp, "%8d %6d %5d %6d %6d %6d %6d %7d %7d %8d%% %14.2f\n", cand[i].nb, cand[i].nbmin, cand[i].nbdiv,
+					(int) (cand[i].pfact - HPL_LEFT_LOOKING), (int) (cand[i].rfact - HPL_LEFT_LOOKING), (int) (cand[i].btopo - HPL_1RING), cand[i].depth,
+					cand[i].lookahead2_turnoff, cand[i].lookahead3_turnoff, cand[i].nb_multiplier_scale, cand[i].gflops);
+			}
+		}
+		if (alive == 1 || window >= 100.) break;
+		alive = (alive + 1) / 2;
+		window *= 2.;
+	}
+
+	if (root)
+	{
+		const HPL_T_tune* best = &cand[0];
+		HPL_fprintf(TEST->outfp, "\nBest configuration for N %d, estimated %.2f Gflops\n", N, best->gflops);
+		HPL_fprintf(TEST->outfp, "HPL.dat:\n");
+		HPL_fprintf(TEST->outfp, "1            # of NBs\n%-12d NBs\n", best->nb);
+		HPL_fprintf(TEST->outfp, "1            # of panel fact\n%-12d PFACTs (0=left, 1=Crout, 2=Right)\n", (int) (best->pfact - HPL_LEFT_LOOKING));
+		HPL_fprintf(TEST->outfp, "1            # of recursive stopping criterium\n%-12d NBMINs (>= 1)\n", best->nbmin);
+		HPL_fprintf(TEST->outfp, "1            # of panels in recursion\n%-12d NDIVs\n", best->nbdiv);
+		HPL_fprintf(TEST->outfp, "1            # of recursive panel fact.\n%-12d RFACTs (0=left, 1=Crout, 2=Right)\n", (int) (best->rfact - HPL_LEFT_LOOKING));
+		HPL_fprintf(TEST->outfp, "1            # of broadcast\n%-12d BCASTs (0=1rg,1=1rM,2=2rg,3=2rM,4=Lng,5=LnM,6=MPI)\n", (int) (best->btopo - HPL_1RING));
+		HPL_fprintf(TEST->outfp, "1            # of lookahead options\n%-12d LOOKAHEADs (enable = 1)\n", best->depth);
+		HPL_fprintf(TEST->outfp, "HPL-GPU.conf:\n");
+		HPL_fprintf(TEST->outfp, "HPL_LOOKAHEAD2_TURNOFF: %d\nHPL_LOOKAHEAD3_TURNOFF: %d\n", best->lookahead2_turnoff, best->lookahead3_turnoff);
+		if (global_runtime_config.hpl_nb_multiplier_count)
+		{
+			HPL_fprintf(TEST->outfp, "HPL_NB_MULTIPLIER_THRESHOLD: ");
+			for (i = 0;i < global_runtime_config.hpl_nb_multiplier_count;i++)
+			{
+				HPL_fprintf(TEST->outfp, "%s%d", i ? ";" : "", (int) ((double) global_runtime_config.hpl_nb_multiplier_threshold[i] * best->nb_multiplier_scale / 100.));
+			}
+			HPL_fprintf(TEST->outfp, "\n");
+		}
+		HPL_fprintf(TEST->outfp, "\n");
+	}
+	free(cand);
+}
@@ -73,6 +73,7 @@ extern "C"
 #define enum
 #include "util_cal.h"
 #undef enum
+#include "util_capture.h"
 #include "util_runtimeconfig.h"
 
 #define fprintfdvv( a, b )	//Disable verbose verbose debug output
@@ -230,10 +231,6 @@ int CALDGEMM_Init(int rank)
 	cal_info.SlowCPU = true;
 #endif
 
-#ifndef HPL_RESTRICT_CPUS
-#define HPL_RESTRICT_CPUS 2
-#endif
-
 #ifdef HPL_INITIAL_GPU_RATIO
 	cal_info.GPURatio = -HPL_INITIAL_GPU_RATIO;
 #endif
@@ -242,7 +239,7 @@ int CALDGEMM_Init(int rank)
 	cal_info.AlternateLookahead = HPL_ALTERNATE_LOOKAHEAD;
 #endif
 
-	cal_info.HPLFactorizeRestrictCPUs = HPL_RESTRICT_CPUS;
+	cal_info.HPLFactorizeRestrictCPUs = global_runtime_config.restrict_cpus;
 #ifdef HPL_RESTRICT_CALLBACK
 	cal_info.HPLFactorizeRestrictCallback = HPL_Restrict_Callback_Function;
 #endif
@@ -360,7 +357,9 @@ void CALDGEMM_async_dtrsm(const HPL_ORDER ORDER, const HPL_SIDE SIDE, const HPL_
 void CALDGEMM_async_dtrsm2(const HPL_ORDER ORDER, const HPL_SIDE SIDE, const HPL_UPLO UPLO, const HPL_TRANS TRANS, const HPL_DIAG DIAG, const int M, const int N,
    const double ALPHA, const double *A, const int LDA, double *B, const int LDB)
 {
-	if (global_m_remain < global_runtime_config.caldgemm_async_dtrsm && (global_runtime_config.caldgemm_async_dtrsm_min_nb == 0 || (M >= global_runtime_config.caldgemm_async_dtrsm_min_nb && N >= global_runtime_config.caldgemm_async_dtrsm_min_nb)))
+	CAPTURE_START
+	const int gpu = global_m_remain < global_runtime_config.caldgemm_async_dtrsm && (global_runtime_config.caldgemm_async_dtrsm_min_nb == 0 || (M >= global_runtime_config.caldgemm_async_dtrsm_min_nb && N >= global_runtime_config.caldgemm_async_dtrsm_min_nb));
+	if (gpu)
 	{
 		if (cal_dgemm->RunAsyncSingleTileDTRSM(ORDER, SIDE, UPLO, TRANS, DIAG, M, N, ALPHA, A, LDA, B, LDB))
 		{
@@ -372,6 +371,7 @@ void CALDGEMM_async_dtrsm2(const HPL_ORDER ORDER, const HPL_SIDE SIDE, const HPL
 	{
 		cblas_dtrsm(ORDER, SIDE, UPLO, TRANS, DIAG, M, N, ALPHA, (double*) A, LDA, B, LDB);
 	}
+	CAPTURE_CALL(CAPTURE_DTRSM2, 0, NULL, 0, NULL, ORDER, SIDE, UPLO, TRANS, DIAG, M, N, LDA, LDB, gpu)
 }
 
 
@@ -452,6 +452,19 @@ void CALDGEMM_UpdateParameters()
 #endif
 }
 
+double CALDGEMM_set_gpu_ratio(double ratio)
+{
+	const double old = cal_info.GPURatio;
+	cal_info.GPURatio = ratio;
+	return(old);
+}
+
+void CALDGEMM_set_num_devices(int num)
+{
+	//num <= 0 restores the number of devices caldgemm was initialized with
+	cal_dgemm->SetNumberDevices(num > 0 ? num : cal_info.NumDevices);
+}
+
 void CALDGEMM_Wait(int n)
 {
 	if (cal_dgemm->WaitForCALDGEMMProgress(n))
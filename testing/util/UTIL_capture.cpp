@@ -0,0 +1,119 @@
+/**
+ * Capturing of kernel calls for offline replay
+ *
+ * Copyright 2010:
+ *  - David Rohr (drohr@jwdt.org)
+ *  - Matthias Bach (bach@compeng.uni-frankfurt.de)
+ *  - Matthias Kretz (kretz@compeng.uni-frankfurt.de)
+ *
+ * This file is part of HPL-GPU.
+ *
+ * HPL-GPU is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * HPL-GPU is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with HPL-GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition to the rules layed out by the GNU General Public License
+ * the following exception is granted:
+ *
+ * Use with the Original BSD License.
+ *
+ * Notwithstanding any other provision of the GNU General Public License
+ * Version 3, you have permission to link or combine any covered work with
+ * a work licensed under the 4-clause BSD license into a single combined
+ * work, and to convey the resulting work.  The terms of this License will
+ * continue to apply to the part which is the covered work, but the special
+ * requirements of the 4-clause BSD license, clause 3, concerning the
+ * requirement of acknowledgement in advertising materials will apply to
+ * the combination as such.
+ */
+
+#include "util_capture.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+extern "C" {
+#include "hpl.h"
+}
+
+volatile int util_capture_enabled = 0;
+
+static FILE* capturefile = NULL;
+static pthread_mutex_t capturemutex = PTHREAD_MUTEX_INITIALIZER;
+
+uint64_t util_captureTimestamp( void )
+{
+	struct timespec now;
+	clock_gettime( CLOCK_MONOTONIC, &now );
+	return (uint64_t) now.tv_sec * 1000000000ull + (uint64_t) now.tv_nsec;
+}
+
+void openCaptureFile( const char *basename, const int run, const int rank )
+{
+	if( capturefile ) closeCaptureFile();
+
+	char* filename = (char*) malloc( strlen( basename ) + 2 * 5 + 6 );
+	if( ! filename )
+		HPL_pabort( __LINE__, "openCaptureFile", "Failed to allocate mem for filename generation" );
+
+	sprintf( filename, "%s.%.5d.%.5d.bin", basename, run, rank );
+
+	capturefile = fopen( filename, "wb" );
+	if( ! capturefile )
+		HPL_pabort( __LINE__, "openCaptureFile", "Failed to open capture file %s", filename );
+	free( filename );
+
+	capture_file_header_t header;
+	memset( &header, 0, sizeof( header ) );
+	memcpy( header.magic, CAPTURE_FILE_MAGIC, sizeof( header.magic ) );
+	header.rank = rank;
+	header.run = run;
+	fwrite( &header, sizeof( header ), 1, capturefile );
+
+	util_capture_enabled = 1;
+}
+
+void closeCaptureFile()
+{
+	pthread_mutex_lock( &capturemutex );
+	util_capture_enabled = 0;
+	if( capturefile )
+	{
+		fclose( capturefile );
+		capturefile = NULL;
+	}
+	pthread_mutex_unlock( &capturemutex );
+}
+
+void captureCall( const int kernel, const uint64_t start, const int nargs, const int *args,
+	const int n1, const int *idx1, const int n2, const int *idx2 )
+{
+	capture_record_header_t record;
+	record.duration = util_captureTimestamp() - start;
+	record.kernel = kernel;
+	record.nargs = nargs;
+	record.n1 = idx1 ? n1 : 0;
+	record.n2 = idx2 ? n2 : 0;
+
+	// the kernels can be called from the factorization and the broadcast threads concurrently
+	pthread_mutex_lock( &capturemutex );
+	if( capturefile )
+	{
+		fwrite( &record, sizeof( record ), 1, capturefile );
+		fwrite( args, sizeof( int ), nargs, capturefile );
+		if( record.n1 ) fwrite( idx1, sizeof( int ), record.n1, capturefile );
+		if( record.n2 ) fwrite( idx2, sizeof( int ), record.n2, capturefile );
+	}
+	pthread_mutex_unlock( &capturemutex );
+}
@@ -0,0 +1,348 @@
+/**
+ * Huge page and NUMA placement policy for the matrix and panel allocations
+ *
+ * Copyright 2010:
+ *  - David Rohr (drohr@jwdt.org)
+ *  - Matthias Bach (bach@compeng.uni-frankfurt.de)
+ *  - Matthias Kretz (kretz@compeng.uni-frankfurt.de)
+ *
+ * This file is part of HPL-GPU.
+ *
+ * HPL-GPU is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * HPL-GPU is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with HPL-GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition to the rules layed out by the GNU General Public License
+ * the following exception is granted:
+ *
+ * Use with the Original BSD License.
+ *
+ * Notwithstanding any other provision of the GNU General Public License
+ * Version 3, you have permission to link or combine any covered work with
+ * a work licensed under the 4-clause BSD license into a single combined
+ * work, and to convey the resulting work.  The terms of this License will
+ * continue to apply to the part which is the covered work, but the special
+ * requirements of the 4-clause BSD license, clause 3, concerning the
+ * requirement of acknowledgement in advertising materials will apply to
+ * the combination as such.
+ */
+
+#include "util_mempolicy.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#include <map>
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+extern "C" {
+#include "hpl.h"
+#include "util_cal.h"
+}
+
+#ifndef MAP_HUGETLB
+#define MAP_HUGETLB 0x40000
+#endif
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#ifndef MADV_HUGEPAGE
+#define MADV_HUGEPAGE 14
+#endif
+
+#define MEM_MAX_NODES 256
+#define MEM_REPORT_SAMPLES 4096
+#define MEM_THP_SIZE (2 * 1024 * 1024)
+
+struct mem_allocation
+{
+	size_t size;
+	size_t pagesize;
+};
+
+static std::map<void*, mem_allocation> mem_allocations;
+
+static int mem_num_nodes()
+{
+	//Highest online node + 1, 1 if the kernel has no NUMA support
+	static int nodes = 0;
+	if (nodes) return(nodes);
+	nodes = 1;
+	FILE* fp = fopen("/sys/devices/system/node/online", "r");
+	if (fp)
+	{
+		char buffer[256];
+		if (fgets(buffer, sizeof(buffer), fp))
+		{
+			char* ptr = buffer;
+			while (*ptr)
+			{
+				char* next;
+				long node = strtol(ptr, &next, 10);
+				if (next == ptr) break;
+				if (node + 1 > nodes) nodes = node + 1;
+				ptr = next;
+				if (*ptr == ',' || *ptr == '-') ptr++;
+			}
+		}
+		fclose(fp);
+	}
+	if (nodes > MEM_MAX_NODES) nodes = MEM_MAX_NODES;
+	return(nodes);
+}
+
+static int mem_current_node()
+{
+	unsigned int cpu, node;
+	if (syscall(SYS_getcpu, &cpu, &node, NULL)) return(0);
+	return(node);
+}
+
+static void mem_bind(char* start, char* end, size_t pagesize, int mode, int node, unsigned int flags)
+{
+	//Apply the policy to all pages starting in [start, end). node < 0 selects all nodes.
+	const size_t bits = 8 * sizeof(unsigned long);
+	unsigned long mask[MEM_MAX_NODES / (8 * sizeof(unsigned long))];
+	memset(mask, 0, sizeof(mask));
+	for (int i = 0;i < mem_num_nodes();i++) if (node < 0 || node == i) mask[i / bits] |= 1ul << (i % bits);
+
+	const size_t begin = ((size_t) start + pagesize - 1) / pagesize * pagesize;
+	const size_t finish = ((size_t) end + pagesize - 1) / pagesize * pagesize;
+	if (finish <= begin) return;
+	if (syscall(SYS_mbind, begin, finish - begin, mode, mask, MEM_MAX_NODES + 1, flags))
+	{
+		static int warned = 0;
+		if (!warned) fprintf(stderr, "Warning: mbind failed: %s, NUMA placement not applied\n", strerror(errno));
+		warned = 1;
+	}
+}
+
+class mem_touch_impl
+{
+private:
+	char* const base;
+	const size_t size, block, pagesize;
+
+public:
+	mem_touch_impl(char* _base, size_t _size, size_t _block, size_t _pagesize) : base(_base), size(_size), block(_block), pagesize(_pagesize) {}
+
+	void operator()(const tbb::blocked_range<size_t>& range) const
+	{
+		//Every page is touched by the worker handling the block column it starts in
+		for (size_t k = range.begin();k < range.end();k++)
+		{
+			const size_t end = Mmin((k + 1) * block, size);
+			for (size_t offset = (k * block + pagesize - 1) / pagesize * pagesize;offset < end;offset += pagesize)
+			{
+				*(volatile char*) (base + offset) = 0;
+			}
+		}
+	}
+};
+
+static void mem_place(char* start, char* end, size_t pagesize, int placement, size_t col_block_bytes, unsigned int flags)
+{
+	//col_block_bytes is 0 for the panel region
+	const int nodes = mem_num_nodes();
+	switch (placement)
+	{
+	case MEM_PLACEMENT_INTERLEAVE:
+		mem_bind(start, end, pagesize, MPOL_INTERLEAVE, -1, flags);
+		break;
+	case MEM_PLACEMENT_BIND:
+		if (col_block_bytes)
+		{
+			size_t k = 0;
+			for (char* ptr = start;ptr < end;ptr += col_block_bytes, k++) mem_bind(ptr, Mmin(ptr + col_block_bytes, end), pagesize, MPOL_BIND, k % nodes, flags);
+		}
+		else
+		{
+			mem_bind(start, end, pagesize, MPOL_BIND, mem_current_node(), flags);
+		}
+		break;
+	case MEM_PLACEMENT_FIRST_TOUCH:
+		//With flags set the pages were already touched by the backend, nothing to be done then
+		if (flags) break;
+		if (col_block_bytes)
+		{
+			//The matrix is touched by the TBB workers that also run LASWP, with the same split into block columns
+			const size_t size = end - start;
+			tbb::parallel_for(tbb::blocked_range<size_t>(0, (size + col_block_bytes - 1) / col_block_bytes), mem_touch_impl(start, size, col_block_bytes, pagesize));
+		}
+		else
+		{
+			mem_touch_impl(start, end - start, end - start, pagesize)(tbb::blocked_range<size_t>(0, 1));
+		}
+		break;
+	}
+}
+
+static void* mem_map(size_t size, size_t* mapsize, size_t* pagesize)
+{
+	const int hugepages = global_runtime_config.mem_hugepages;
+	static const int shifts[2] = {30, 21};
+	for (int i = hugepages >= MEM_HUGEPAGES_1G ? 0 : 1;hugepages >= MEM_HUGEPAGES_2M && i < 2;i++)
+	{
+		const size_t hugepagesize = (size_t) 1 << shifts[i];
+		const size_t len = (size + hugepagesize - 1) / hugepagesize * hugepagesize;
+		void* ptr = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (shifts[i] << MAP_HUGE_SHIFT), -1, 0);
+		if (ptr != MAP_FAILED)
+		{
+			*mapsize = len;
+			*pagesize = hugepagesize;
+			return(ptr);
+		}
+		fprintf(stderr, "Warning: could not allocate %lld bytes with %d MiB huge pages (%s), falling back\n", (long long int) len, (int) (hugepagesize >> 20), strerror(errno));
+	}
+
+	//Normal pages, aligned to the THP size so that the kernel can use huge pages for the whole range
+	const size_t len = (size + MEM_THP_SIZE - 1) / MEM_THP_SIZE * MEM_THP_SIZE;
+	char* ptr = (char*) mmap(NULL, len + MEM_THP_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (ptr == (char*) MAP_FAILED) return(NULL);
+	const size_t head = (MEM_THP_SIZE - (size_t) ptr % MEM_THP_SIZE) % MEM_THP_SIZE;
+	if (head) munmap(ptr, head);
+	munmap(ptr + head + len, MEM_THP_SIZE - head);
+	ptr += head;
+	if (hugepages >= MEM_HUGEPAGES_THP && madvise(ptr, len, MADV_HUGEPAGE)) fprintf(stderr, "Warning: madvise(MADV_HUGEPAGE) failed: %s\n", strerror(errno));
+	*mapsize = len;
+	*pagesize = sysconf(_SC_PAGESIZE);
+	return(ptr);
+}
+
+void* HPL_mem_alloc(size_t matrix_bytes, size_t panel_bytes, size_t col_block_bytes, int interleave)
+{
+	const size_t size = matrix_bytes + panel_bytes;
+	int placement_matrix = global_runtime_config.mem_placement_matrix;
+	int placement_panel = global_runtime_config.mem_placement_panel;
+	if (global_runtime_config.mem_hugepages == MEM_HUGEPAGES_BACKEND && placement_matrix == MEM_PLACEMENT_BACKEND && placement_panel == MEM_PLACEMENT_BACKEND)
+	{
+		return(CALDGEMM_alloc(size, interleave));
+	}
+	if (interleave)
+	{
+		if (placement_matrix == MEM_PLACEMENT_BACKEND) placement_matrix = MEM_PLACEMENT_INTERLEAVE;
+		if (placement_panel == MEM_PLACEMENT_BACKEND) placement_panel = MEM_PLACEMENT_INTERLEAVE;
+	}
+
+#ifdef HPL_REGISTER_MEMORY
+	//The backend registers the memory for GPU access and thus has to own the allocation. THP and placement are applied on
+	//top as far as the kernel allows, by migrating the pages already faulted in. The report shows what was obtained.
+	char* ptr = (char*) CALDGEMM_alloc(size, interleave);
+	if (ptr == NULL) return(NULL);
+	const size_t pagesize = sysconf(_SC_PAGESIZE);
+	if (global_runtime_config.mem_hugepages >= MEM_HUGEPAGES_THP)
+	{
+		char* begin = (char*) (((size_t) ptr + MEM_THP_SIZE - 1) / MEM_THP_SIZE * MEM_THP_SIZE);
+		if (begin < ptr + size) madvise(begin, (ptr + size - begin) / pagesize * pagesize, MADV_HUGEPAGE);
+	}
+	mem_place(ptr, ptr + matrix_bytes, pagesize, placement_matrix, col_block_bytes, MPOL_MF_MOVE);
+	mem_place(ptr + matrix_bytes, ptr + size, pagesize, placement_panel, 0, MPOL_MF_MOVE);
+	return(ptr);
+#else
+	size_t mapsize, pagesize;
+	char* ptr = (char*) mem_map(size, &mapsize, &pagesize);
+	if (ptr == NULL) return(NULL);
+	mem_place(ptr, ptr + matrix_bytes, pagesize, placement_matrix, col_block_bytes, 0);
+	mem_place(ptr + matrix_bytes, ptr + mapsize, pagesize, placement_panel, 0, 0);
+#ifdef HPL_PAGELOCKED_MEM
+	if (mlock(ptr, mapsize)) fprintf(stderr, "Warning: could not lock %lld bytes of memory: %s\n", (long long int) mapsize, strerror(errno));
+#endif
+	mem_allocation& allocation = mem_allocations[ptr];
+	allocation.size = mapsize;
+	allocation.pagesize = pagesize;
+	return(ptr);
+#endif
+}
+
+void HPL_mem_free(void* ptr)
+{
+	std::map<void*, mem_allocation>::iterator it = mem_allocations.find(ptr);
+	if (it == mem_allocations.end())
+	{
+		CALDGEMM_free(ptr);
+		return;
+	}
+	munmap(ptr, it->second.size);
+	mem_allocations.erase(it);
+}
+
+void HPL_mem_report(const char* name, const void* ptr, size_t size, int myrow, int mycol)
+{
+	const size_t begin = (size_t) ptr, end = begin + size;
+
+	//Page sizes and resident, THP and hugetlbfs amounts of all mappings overlapping the range
+	long long int rss = 0, thp = 0, hugetlb = 0;
+	long long int pagesizes[4];
+	int npagesizes = 0;
+	FILE* fp = fopen("/proc/self/smaps", "r");
+	if (fp)
+	{
+		char line[512], key[64];
+		int inside = 0;
+		while (fgets(line, sizeof(line), fp))
+		{
+			unsigned long long int a, b;
+			long long int value;
+			if (sscanf(line, "%llx-%llx", &a, &b) == 2)
+			{
+				inside = a < end && b > begin;
+			}
+			else if (inside && sscanf(line, "%63[^:]: %lld kB", key, &value) == 2)
+			{
+				if (strcmp(key, "Rss") == 0) rss += value;
+				else if (strcmp(key, "AnonHugePages") == 0) thp += value;
+				else if (strcmp(key, "Private_Hugetlb") == 0 || strcmp(key, "Shared_Hugetlb") == 0) hugetlb += value;
+				else if (strcmp(key, "KernelPageSize") == 0)
+				{
+					int i;
+					for (i = 0;i < npagesizes && pagesizes[i] != value;i++);
+					if (i == npagesizes && npagesizes < 4) pagesizes[npagesizes++] = value;
+				}
+			}
+		}
+		fclose(fp);
+	}
+
+	//Node of a sample of the pages
+	const size_t pagesize = sysconf(_SC_PAGESIZE);
+	const size_t npages = (size + pagesize - 1) / pagesize;
+	const size_t step = Mmax((size_t) 1, (npages + MEM_REPORT_SAMPLES - 1) / MEM_REPORT_SAMPLES);
+	void* pages[MEM_REPORT_SAMPLES];
+	int status[MEM_REPORT_SAMPLES];
+	long nsamples = 0;
+	for (size_t i = 0;i < npages && nsamples < MEM_REPORT_SAMPLES;i += step) pages[nsamples++] = (void*) (begin / pagesize * pagesize + i * pagesize);
+	long counts[MEM_MAX_NODES + 1];
+	memset(counts, 0, sizeof(counts));
+	if (nsamples && syscall(SYS_move_pages, 0, nsamples, pages, NULL, status, 0) == 0)
+	{
+		for (long i = 0;i < nsamples;i++) counts[status[i] >= 0 && status[i] < MEM_MAX_NODES ? status[i] : MEM_MAX_NODES]++;
+	}
+	else
+	{
+		counts[MEM_MAX_NODES] = nsamples;
+	}
+
+	char hostname[64];
+	gethostname(hostname, 64);
+	char buffer[1024];
+	int pos = snprintf(buffer, sizeof(buffer), "Row %d Col %d Host %s %s: %lld MiB, page size", myrow, mycol, hostname, name, (long long int) (size >> 20));
+	for (int i = 0;i < npagesizes;i++) pos += snprintf(buffer + pos, sizeof(buffer) - pos, "%s %lld kB", i ? "," : "", pagesizes[i]);
+	pos += snprintf(buffer + pos, sizeof(buffer) - pos, ", resident %lld MiB (THP %lld MiB, hugetlbfs %lld MiB), nodes", rss >> 10, thp >> 10, hugetlb >> 10);
+	for (int i = 0;i < MEM_MAX_NODES && pos < (int) sizeof(buffer) - 32;i++) if (counts[i]) pos += snprintf(buffer + pos, sizeof(buffer) - pos, " %d: %.1f%%", i, 100. * counts[i] / nsamples);
+	if (counts[MEM_MAX_NODES] && pos < (int) sizeof(buffer) - 32) pos += snprintf(buffer + pos, sizeof(buffer) - pos, " not present: %.1f%%", 100. * counts[MEM_MAX_NODES] / nsamples);
+	printf("%s\n", buffer);
+}
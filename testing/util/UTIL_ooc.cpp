@@ -0,0 +1,273 @@
+/**
+ * Out-of-core storage of the local matrix in a memory-mapped file
+ *
+ * Copyright 2010:
+ *  - David Rohr (drohr@jwdt.org)
+ *  - Matthias Bach (bach@compeng.uni-frankfurt.de)
+ *  - Matthias Kretz (kretz@compeng.uni-frankfurt.de)
+ *
+ * This file is part of HPL-GPU.
+ *
+ * HPL-GPU is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * HPL-GPU is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with HPL-GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition to the rules layed out by the GNU General Public License
+ * the following exception is granted:
+ *
+ * Use with the Original BSD License.
+ *
+ * Notwithstanding any other provision of the GNU General Public License
+ * Version 3, you have permission to link or combine any covered work with
+ * a work licensed under the 4-clause BSD license into a single combined
+ * work, and to convey the resulting work.  The terms of this License will
+ * continue to apply to the part which is the covered work, but the special
+ * requirements of the 4-clause BSD license, clause 3, concerning the
+ * requirement of acknowledgement in advertising materials will apply to
+ * the combination as such.
+ */
+
+#include "util_ooc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <deque>
+extern "C" {
+#include "hpl.h"
+}
+
+struct ooc_request
+{
+	char* ptr;
+	size_t size;
+	int evict;
+};
+
+static char* ooc_base = NULL;
+static size_t ooc_size = 0;
+static int ooc_fd = -1;
+static size_t ooc_pagesize;
+
+static pthread_t ooc_thread;
+static pthread_mutex_t ooc_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t ooc_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t ooc_done_cond = PTHREAD_COND_INITIALIZER;
+static std::deque<ooc_request> ooc_queue;
+static char* ooc_inflight = NULL;
+static int ooc_terminate = 0;
+
+static double ooc_busy, ooc_stall, ooc_read, ooc_written;
+
+static double ooc_time()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return((double) now.tv_sec + (double) now.tv_nsec * 1e-9);
+}
+
+static void ooc_process(const ooc_request& request)
+{
+	char* const begin = request.ptr;
+	const size_t size = request.size;
+	if (request.evict)
+	{
+		//Write back synchronously, then drop the pages from the mapping and the page cache
+		if (msync(begin, size, MS_SYNC)) fprintf(stderr, "Warning: out-of-core write back failed: %s\n", strerror(errno));
+		madvise(begin, size, MADV_DONTNEED);
+		posix_fadvise(ooc_fd, begin - ooc_base, size, POSIX_FADV_DONTNEED);
+		ooc_written += size;
+	}
+	else
+	{
+		//Count the pages not yet resident, then fault them in from this thread
+		const size_t npages = size / ooc_pagesize;
+		unsigned char* resident = (unsigned char*) malloc(npages);
+		size_t missing = npages;
+		if (resident && mincore(begin, size, resident) == 0)
+		{
+			missing = 0;
+			for (size_t i = 0;i < npages;i++) if (!(resident[i] & 1)) missing++;
+		}
+		free(resident);
+		madvise(begin, size, MADV_WILLNEED);
+		for (size_t offset = 0;offset < size;offset += ooc_pagesize) (void) *(volatile char*) (begin + offset);
+		ooc_read += (double) missing * ooc_pagesize;
+	}
+}
+
+static void* ooc_thread_function(void*)
+{
+	pthread_mutex_lock(&ooc_mutex);
+	while (true)
+	{
+		while (ooc_queue.empty() && !ooc_terminate) pthread_cond_wait(&ooc_cond, &ooc_mutex);
+		if (ooc_queue.empty()) break;
+		ooc_request request = ooc_queue.front();
+		ooc_queue.pop_front();
+		if (!request.evict) ooc_inflight = request.ptr;
+		pthread_mutex_unlock(&ooc_mutex);
+
+		const double start = ooc_time();
+		ooc_process(request);
+		const double busy = ooc_time() - start;
+
+		pthread_mutex_lock(&ooc_mutex);
+		ooc_busy += busy;
+		if (!request.evict)
+		{
+			ooc_inflight = NULL;
+			pthread_cond_broadcast(&ooc_done_cond);
+		}
+	}
+	pthread_mutex_unlock(&ooc_mutex);
+	return(NULL);
+}
+
+static int ooc_enqueue(const void* ptr, size_t size, int evict)
+{
+	//Restrict to whole pages inside the mapping
+	if (ooc_base == NULL) return(0);
+	size_t begin = (size_t) ptr, end = begin + size;
+	if (begin < (size_t) ooc_base) begin = (size_t) ooc_base;
+	if (end > (size_t) ooc_base + ooc_size) end = (size_t) ooc_base + ooc_size;
+	if (evict)
+	{
+		//Only pages completely inside the range, neighbouring columns may still be in use
+		begin = (begin + ooc_pagesize - 1) / ooc_pagesize * ooc_pagesize;
+		end = end / ooc_pagesize * ooc_pagesize;
+	}
+	else
+	{
+		begin = begin / ooc_pagesize * ooc_pagesize;
+		end = (end + ooc_pagesize - 1) / ooc_pagesize * ooc_pagesize;
+	}
+	if (end <= begin) return(0);
+
+	ooc_request request;
+	request.ptr = (char*) begin;
+	request.size = end - begin;
+	request.evict = evict;
+	pthread_mutex_lock(&ooc_mutex);
+	ooc_queue.push_back(request);
+	pthread_cond_signal(&ooc_cond);
+	pthread_mutex_unlock(&ooc_mutex);
+	return(1);
+}
+
+void* HPL_ooc_alloc(size_t size)
+{
+	if (ooc_base) HPL_pabort(__LINE__, "HPL_ooc_alloc", "Only one out-of-core matrix is supported");
+	const char* path = global_runtime_config.ooc_path;
+	char* filename = (char*) malloc(strlen(path) + 32);
+	if (filename == NULL) HPL_pabort(__LINE__, "HPL_ooc_alloc", "Memory allocation failed");
+	sprintf(filename, "%s/hpl-ooc.XXXXXX", path);
+	ooc_fd = mkstemp(filename);
+	if (ooc_fd == -1)
+	{
+		fprintf(stderr, "Error creating out-of-core file %s: %s\n", filename, strerror(errno));
+		free(filename);
+		return(NULL);
+	}
+	unlink(filename);
+	free(filename);
+
+	ooc_pagesize = sysconf(_SC_PAGESIZE);
+	ooc_size = (size + ooc_pagesize - 1) / ooc_pagesize * ooc_pagesize;
+	void* ptr = MAP_FAILED;
+	if (ftruncate(ooc_fd, ooc_size) == 0) ptr = mmap(NULL, ooc_size, PROT_READ | PROT_WRITE, MAP_SHARED, ooc_fd, 0);
+	if (ptr == MAP_FAILED)
+	{
+		fprintf(stderr, "Error mapping out-of-core file of %lld bytes: %s\n", (long long int) ooc_size, strerror(errno));
+		close(ooc_fd);
+		ooc_fd = -1;
+		return(NULL);
+	}
+	ooc_base = (char*) ptr;
+	ooc_terminate = 0;
+	HPL_ooc_reset_stats();
+	if (pthread_create(&ooc_thread, NULL, ooc_thread_function, NULL)) HPL_pabort(__LINE__, "HPL_ooc_alloc", "Error creating out-of-core I/O thread");
+	return(ptr);
+}
+
+void HPL_ooc_free(void* ptr)
+{
+	if (ptr == NULL || ptr != ooc_base) return;
+	pthread_mutex_lock(&ooc_mutex);
+	ooc_terminate = 1;
+	pthread_cond_signal(&ooc_cond);
+	pthread_mutex_unlock(&ooc_mutex);
+	pthread_join(ooc_thread, NULL);
+	munmap(ooc_base, ooc_size);
+	close(ooc_fd);
+	ooc_base = NULL;
+	ooc_fd = -1;
+}
+
+int HPL_ooc_active(void)
+{
+	return(ooc_base != NULL);
+}
+
+void HPL_ooc_prefetch(const void* ptr, size_t size)
+{
+	ooc_enqueue(ptr, size, 0);
+}
+
+void HPL_ooc_evict(const void* ptr, size_t size)
+{
+	ooc_enqueue(ptr, size, 1);
+}
+
+static int ooc_prefetch_pending(const char* end)
+{
+	if (ooc_inflight && ooc_inflight < end) return(1);
+	for (std::deque<ooc_request>::const_iterator it = ooc_queue.begin();it != ooc_queue.end();++it)
+	{
+		if (!it->evict && it->ptr < end) return(1);
+	}
+	return(0);
+}
+
+void HPL_ooc_wait(const void* end)
+{
+	if (ooc_base == NULL) return;
+	if (end == NULL) end = ooc_base + ooc_size;
+	const double start = ooc_time();
+	pthread_mutex_lock(&ooc_mutex);
+	while (ooc_prefetch_pending((const char*) end)) pthread_cond_wait(&ooc_done_cond, &ooc_mutex);
+	ooc_stall += ooc_time() - start;
+	pthread_mutex_unlock(&ooc_mutex);
+}
+
+void HPL_ooc_reset_stats(void)
+{
+	pthread_mutex_lock(&ooc_mutex);
+	ooc_busy = ooc_stall = ooc_read = ooc_written = 0.;
+	pthread_mutex_unlock(&ooc_mutex);
+}
+
+void HPL_ooc_stats(double* busy, double* stall, double* read, double* written)
+{
+	pthread_mutex_lock(&ooc_mutex);
+	*busy = ooc_busy;
+	*stall = ooc_stall;
+	*read = ooc_read;
+	*written = ooc_written;
+	pthread_mutex_unlock(&ooc_mutex);
+}
@@ -0,0 +1,334 @@
+/**
+ * Per-iteration parameter rules read from HPL_RULE lines of HPL-GPU.conf
+ *
+ * Copyright 2010:
+ *  - David Rohr (drohr@jwdt.org)
+ *  - Matthias Bach (bach@compeng.uni-frankfurt.de)
+ *  - Matthias Kretz (kretz@compeng.uni-frankfurt.de)
+ *
+ * This file is part of HPL-GPU.
+ *
+ * HPL-GPU is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * HPL-GPU is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with HPL-GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition to the rules layed out by the GNU General Public License
+ * the following exception is granted:
+ *
+ * Use with the Original BSD License.
+ *
+ * Notwithstanding any other provision of the GNU General Public License
+ * Version 3, you have permission to link or combine any covered work with
+ * a work licensed under the 4-clause BSD license into a single combined
+ * work, and to convey the resulting work.  The terms of this License will
+ * continue to apply to the part which is the covered work, but the special
+ * requirements of the 4-clause BSD license, clause 3, concerning the
+ * requirement of acknowledgement in advertising materials will apply to
+ * the combination as such.
+ */
+
+#include "util_rules.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <string>
+#include <vector>
+extern "C" {
+#include "hpl.h"
+#include "util_cal.h"
+#include "util_runtimeconfig.h"
+
+#if defined(HPL_CPUFREQ) | defined(HPL_CPUPOWER)
+void setcpufreq(int freq, int dgemmfreq);
+#endif
+}
+
+enum rule_var {RULE_J, RULE_N, RULE_M_REMAIN, RULE_ITER};
+enum rule_op {RULE_LT, RULE_LE, RULE_GT, RULE_GE, RULE_EQ, RULE_NE};
+enum rule_param {RULE_NBMIN, RULE_NBDIV, RULE_LOOKAHEAD, RULE_LASWP_CORES, RULE_GPU_RATIO, RULE_DEVICES,
+	RULE_ASYNC_FACT_DGEMM, RULE_ASYNC_DTRSM, RULE_ASYNC_FACT_DTRSM, RULE_CPUFREQ, RULE_CPUFREQ_DGEMM, RULE_NUM_PARAMS};
+
+static const char* const rule_var_names[] = {"j", "n", "m_remain", "iter"};
+static const char* const rule_op_names[] = {"<=", ">=", "==", "!=", "<", ">"};
+static const rule_op rule_op_values[] = {RULE_LE, RULE_GE, RULE_EQ, RULE_NE, RULE_LT, RULE_GT};
+static const char* const rule_param_names[] = {"nbmin", "nbdiv", "lookahead", "laswp_cores", "gpu_ratio", "devices",
+	"async_fact_dgemm", "async_dtrsm", "async_fact_dtrsm", "cpufreq", "cpufreq_dgemm"};
+
+struct rule_cond
+{
+	rule_var var;
+	rule_op op;
+	int value;
+};
+
+struct rule_action
+{
+	rule_param param;
+	double value;
+};
+
+struct rule
+{
+	std::vector<rule_cond> conds;
+	std::vector<rule_action> actions;
+};
+
+static std::vector<rule> rules;
+
+//Value requested for each parameter (set), and the value in effect (applied)
+static double rules_value[RULE_NUM_PARAMS];
+static int rules_set[RULE_NUM_PARAMS];
+static double rules_applied[RULE_NUM_PARAMS];
+static int rules_changed[RULE_NUM_PARAMS];
+
+static int rules_saved_nbmin, rules_saved_nbdiv;
+static int rules_saved_async_fact_dgemm, rules_saved_async_dtrsm, rules_saved_async_fact_dtrsm;
+static double rules_saved_gpu_ratio;
+
+static const char* rules_skip(const char* ptr)
+{
+	while (*ptr == ' ' || *ptr == '\t') ptr++;
+	return(ptr);
+}
+
+static int rules_match(const char*& ptr, const char* const* names, const int count)
+{
+	for (int i = 0;i < count;i++)
+	{
+		const size_t len = strlen(names[i]);
+		if (strncmp(ptr, names[i], len) == 0 && !(isalnum(ptr[len]) || ptr[len] == '_'))
+		{
+			ptr += len;
+			return(i);
+		}
+	}
+	return(-1);
+}
+
+static int rules_parse_number(const char*& ptr, double& value)
+{
+	char* end;
+	value = strtod(ptr, &end);
+	if (end == ptr) return(1);
+	ptr = end;
+	return(0);
+}
+
+static int rules_parse_rule(const char* ptr, rule& r)
+{
+	ptr = rules_skip(ptr);
+	if (strncmp(ptr, "always", 6) == 0)
+	{
+		ptr = rules_skip(ptr + 6);
+	}
+	else while (true)
+	{
+		rule_cond cond;
+		double value;
+		int var = rules_match(ptr, rule_var_names, sizeof(rule_var_names) / sizeof(rule_var_names[0]));
+		if (var == -1) return(1);
+		ptr = rules_skip(ptr);
+		int op;
+		for (op = 0;op < (int) (sizeof(rule_op_names) / sizeof(rule_op_names[0]));op++)
+		{
+			if (strncmp(ptr, rule_op_names[op], strlen(rule_op_names[op])) == 0) break;
+		}
+		if (op == sizeof(rule_op_names) / sizeof(rule_op_names[0])) return(1);
+		ptr = rules_skip(ptr + strlen(rule_op_names[op]));
+		if (rules_parse_number(ptr, value)) return(1);
+		cond.var = (rule_var) var;
+		cond.op = rule_op_values[op];
+		cond.value = (int) value;
+		r.conds.push_back(cond);
+		ptr = rules_skip(ptr);
+		if (strncmp(ptr, "&&", 2)) break;
+		ptr = rules_skip(ptr + 2);
+	}
+	if (strncmp(ptr, "=>", 2)) return(1);
+	ptr = rules_skip(ptr + 2);
+	while (true)
+	{
+		rule_action action;
+		int param = rules_match(ptr, rule_param_names, sizeof(rule_param_names) / sizeof(rule_param_names[0]));
+		if (param == -1) return(1);
+		ptr = rules_skip(ptr);
+		if (*ptr != '=') return(1);
+		ptr = rules_skip(ptr + 1);
+		if (rules_parse_number(ptr, action.value)) return(1);
+		action.param = (rule_param) param;
+		r.actions.push_back(action);
+		ptr = rules_skip(ptr);
+		if (*ptr != ',') break;
+		ptr = rules_skip(ptr + 1);
+	}
+	return(*ptr != 0);
+}
+
+static int rules_check(const rule& r)
+{
+	//Parameters that change the panel sequence or the message pattern must be set identically on all ranks, m_remain is a local quantity
+	int local = 0;
+	for (size_t i = 0;i < r.conds.size();i++) if (r.conds[i].var == RULE_M_REMAIN) local = 1;
+	for (size_t i = 0;i < r.actions.size();i++)
+	{
+		const rule_action& a = r.actions[i];
+		if (local && (a.param == RULE_NBMIN || a.param == RULE_NBDIV || a.param == RULE_LOOKAHEAD))
+		{
+			HPL_fprintf(stderr, "HPL_RULE: %s must not depend on m_remain, it must be identical on all ranks\n", rule_param_names[a.param]);
+			return(1);
+		}
+		if (a.value < (a.param == RULE_NBMIN ? 1 : (a.param == RULE_NBDIV ? 2 : 0)))
+		{
+			HPL_fprintf(stderr, "HPL_RULE: invalid value %g for %s\n", a.value, rule_param_names[a.param]);
+			return(1);
+		}
+#if !(defined(HPL_CPUFREQ) | defined(HPL_CPUPOWER))
+		if (a.param == RULE_CPUFREQ || a.param == RULE_CPUFREQ_DGEMM)
+		{
+			HPL_fprintf(stderr, "HPL_RULE: %s requires HPL_CPUFREQ or HPL_CPUPOWER\n", rule_param_names[a.param]);
+			return(1);
+		}
+#endif
+	}
+	return(0);
+}
+
+int HPL_rules_parse(const char* text)
+{
+	rules.clear();
+	if (text == NULL) return(0);
+	while (*text)
+	{
+		const char* end = strchr(text, '\n');
+		if (end == NULL) end = text + strlen(text);
+		const std::string line(text, end);
+		text = *end ? end + 1 : end;
+		if (*rules_skip(line.c_str()) == 0) continue;
+
+		rule r;
+		if (rules_parse_rule(line.c_str(), r))
+		{
+			HPL_fprintf(stderr, "Error parsing HPL_RULE: %s\n", line.c_str());
+			return(1);
+		}
+		if (rules_check(r)) return(1);
+		rules.push_back(r);
+	}
+	return(0);
+}
+
+int HPL_rules_active()
+{
+	return(rules.size() != 0);
+}
+
+static inline int rules_eval(const rule_cond& cond, const int* vars)
+{
+	const int v = vars[cond.var];
+	switch (cond.op)
+	{
+	case RULE_LT: return(v < cond.value);
+	case RULE_LE: return(v <= cond.value);
+	case RULE_GT: return(v > cond.value);
+	case RULE_GE: return(v >= cond.value);
+	case RULE_EQ: return(v == cond.value);
+	default: return(v != cond.value);
+	}
+}
+
+void HPL_rules_begin(HPL_T_palg* ALGO)
+{
+	if (rules.size() == 0) return;
+	memset(rules_set, 0, sizeof(rules_set));
+	memset(rules_changed, 0, sizeof(rules_changed));
+	rules_saved_nbmin = ALGO->nbmin;
+	rules_saved_nbdiv = ALGO->nbdiv;
+	rules_saved_async_fact_dgemm = global_runtime_config.caldgemm_async_fact_dgemm;
+	rules_saved_async_dtrsm = global_runtime_config.caldgemm_async_dtrsm;
+	rules_saved_async_fact_dtrsm = global_runtime_config.caldgemm_async_fact_dtrsm;
+}
+
+void HPL_rules_apply(HPL_T_palg* ALGO, int iter, int j, int n, int m_remain)
+{
+	if (rules.size() == 0) return;
+	const int vars[] = {j, n, m_remain, iter};
+	for (size_t i = 0;i < rules.size();i++)
+	{
+		const rule& r = rules[i];
+		size_t k;
+		for (k = 0;k < r.conds.size();k++) if (!rules_eval(r.conds[k], vars)) break;
+		if (k < r.conds.size()) continue;
+		for (k = 0;k < r.actions.size();k++)
+		{
+			rules_value[r.actions[k].param] = r.actions[k].value;
+			rules_set[r.actions[k].param] = 1;
+		}
+	}
+
+	for (int i = 0;i < RULE_NUM_PARAMS;i++)
+	{
+		//Only act on values that differ from the ones in effect, some of the actions restart threads
+		if (!rules_set[i] || (rules_changed[i] && rules_applied[i] == rules_value[i])) continue;
+		const double value = rules_value[i];
+		switch ((rule_param) i)
+		{
+		case RULE_NBMIN: ALGO->nbmin = (int) value; break;
+		case RULE_NBDIV: ALGO->nbdiv = (int) value; break;
+		case RULE_LOOKAHEAD: break;
+#ifndef USE_ORIGINAL_LASWP
+		case RULE_LASWP_CORES: HPL_laswp_set_threads((int) value); break;
+#else
+		case RULE_LASWP_CORES: break;
+#endif
+		case RULE_GPU_RATIO:
+		{
+			const double old = CALDGEMM_set_gpu_ratio(value);
+			if (!rules_changed[i]) rules_saved_gpu_ratio = old;
+			break;
+		}
+		case RULE_DEVICES: CALDGEMM_set_num_devices((int) value); break;
+		case RULE_ASYNC_FACT_DGEMM: global_runtime_config.caldgemm_async_fact_dgemm = (int) value; break;
+		case RULE_ASYNC_DTRSM: global_runtime_config.caldgemm_async_dtrsm = (int) value; break;
+		case RULE_ASYNC_FACT_DTRSM: global_runtime_config.caldgemm_async_fact_dtrsm = (int) value; break;
+#if defined(HPL_CPUFREQ) | defined(HPL_CPUPOWER)
+		case RULE_CPUFREQ: setcpufreq((int) value, rules_set[RULE_CPUFREQ_DGEMM] ? (int) rules_value[RULE_CPUFREQ_DGEMM] : 0); break;
+#endif
+		default: break; //cpufreq_dgemm is passed along with cpufreq
+		}
+		rules_applied[i] = value;
+		rules_changed[i] = 1;
+	}
+}
+
+void HPL_rules_end(HPL_T_palg* ALGO)
+{
+	if (rules.size() == 0) return;
+	ALGO->nbmin = rules_saved_nbmin;
+	ALGO->nbdiv = rules_saved_nbdiv;
+	global_runtime_config.caldgemm_async_fact_dgemm = rules_saved_async_fact_dgemm;
+	global_runtime_config.caldgemm_async_dtrsm = rules_saved_async_dtrsm;
+	global_runtime_config.caldgemm_async_fact_dtrsm = rules_saved_async_fact_dtrsm;
+#ifndef USE_ORIGINAL_LASWP
+	if (rules_changed[RULE_LASWP_CORES]) HPL_laswp_set_threads(0);
+#endif
+	if (rules_changed[RULE_GPU_RATIO]) CALDGEMM_set_gpu_ratio(rules_saved_gpu_ratio);
+	if (rules_changed[RULE_DEVICES]) CALDGEMM_set_num_devices(0);
+	memset(rules_set, 0, sizeof(rules_set));
+	memset(rules_changed, 0, sizeof(rules_changed));
+}
+
+int HPL_rules_lookahead()
+{
+	return(rules_set[RULE_LOOKAHEAD] ? (int) rules_value[RULE_LOOKAHEAD] : -1);
+}
@@ -1,6 +1,36 @@
+/*
+ * Benchmark and validation tool for the LASWP and copy kernels of HPL-GPU
+ * (HPL_dlaswp00N, HPL_dlaswp01T, HPL_dlaswp06T, HPL_dlaswp10N, HPL_dlacpy,
+ * HPL_dlatcpy).
+ *
+ * The tool sweeps over the kernel dimensions and the number of TBB worker
+ * threads and reports the achieved bandwidth relative to a STREAM-like copy
+ * peak measured with the same thread count. Index arrays are either
+ * generated synthetically or taken from files captured with TRACE_LASWP
+ * (see HPL_dlaswp01T.cpp); the kernel and the dimensions are then derived
+ * from the file name, e.g. "dlaswp01T.2496.23809.29640.23816. 0.4362s.dat".
+ *
+ * In validation mode each optimized kernel is compared bitwise with the
+ * reference implementation that is used with USE_ORIGINAL_LASWP, for the
+ * copy kernels with a plain loop.
+ *
+ * HPL_dlatcpy selects its transpose engine by size, the pattern column shows
+ * the engine used ("incache" or "stream"). Sweep -M and -N across
+ * HPL_DLATCPY_INCACHE_SIZE to obtain the bandwidth of both, e.g.
+ * "-k dlatcpy -M 64,256,1920 -N 64,256,1920,23808".
+ *
+ * Run ./bench_laswp -h for the list of options.
+ */
+
 #include <stdio.h>
 #include <stdlib.h>
-#include <algorithm>
+#include <string.h>
+#include <vector>
+#include <string>
+
+#include <tbb/task_scheduler_init.h>
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
 
 extern "C" {
 #include "hpl_auxil.h"
@@ -13,146 +43,568 @@ extern "C" {
 
 #define quit(...) {fprintf(stderr, __VA_ARGS__); exit(1);}
 
-int main(int argc, char** argv)
+/*
+ * Reference kernels, these are the bodies used by the optimized kernels if
+ * compiled with USE_ORIGINAL_LASWP.
+ */
+static void ref_dlaswp00N(const int M, const int N, double *A, const int LDA, const int *IPIV)
 {
-	HighResTimer timer;
-	FILE* fp;
-	//dlacpy.24960.01920.28872.24960. 0.0808s.dat  dlaswp00N.1920.87169.89160. 0.3553s.dat  dlaswp01T.2496.23809.29640.23816. 0.4362s.dat  dlaswp06T.0590.23809.29640.23816. 0.1770s.dat  dlaswp10N.23040.01920.23048. 0.0441s.dat  dlatcpy.1920.23809.23816.29640. 0.0516s.dat
-	
-	fprintf(stderr, "Allocating swap vector memory\n");
-	
-	int benchmark_warmup = 10;
-	int benchmark_iterations = 50;
-	
-	int dlacpy_M = 24960;
-	int dlacpy_N = 1920;
-	int dlacpy_LDA = 28872;
-	int dlacpy_LDB = 24960;
-	
-	int dlatcpy_M = 1920;
-	int dlatcpy_N = 23809;
-	int dlatcpy_LDA = 23816;
-	int dlatcpy_LDB = 29640;
-	
-	int dlaswp00N_M = 1920;
-	int dlaswp00N_N = 87169;
-	int dlaswp00N_LDA = 89160;
-	int* dlaswp00N_IPIV = new int[dlaswp00N_M];
-	const char* dlaswp00N_FILE = "dlaswp00N.1920.87169.89160. 0.3553s.dat";
-	
-	int dlaswp01T_M = 2496;
-	int dlaswp01T_N = 23809;
-	int dlaswp01T_LDA = 29640;
-	int dlaswp01T_LDU = 23816;
-	int* dlaswp01T_LINDXA = new int[dlaswp01T_M];
-	int* dlaswp01T_LINDXAU = new int[dlaswp01T_M];
-	const char* dlaswp01T_FILE = "dlaswp01T.2496.23809.29640.23816. 0.4362s.dat";
-	
-	int dlaswp06T_M = 590;
-	int dlaswp06T_N = 23809;
-	int dlaswp06T_LDA = 29640;
-	int dlaswp06T_LDU = 23816;
-	int* dlaswp06T_LINDXA = new int[dlaswp06T_M];
-	const char* dlaswp06T_FILE = "dlaswp06T.0590.23809.29640.23816. 0.1770s.dat";
-	
-	int dlaswp10N_M = 23040;
-	int dlaswp10N_N = 1920;
-	int dlaswp10N_LDA = 23048;
-	int* dlaswp10N_IPIV = new int[dlaswp10N_N];
-	const char* dlaswp10N_FILE = "dlaswp10N.23040.01920.23048. 0.0441s.dat";
-	
-	if (dlaswp00N_IPIV == NULL || dlaswp01T_LINDXA == NULL || dlaswp01T_LINDXAU == NULL || dlaswp06T_LINDXA == NULL || dlaswp10N_IPIV == NULL) quit("Memmory allocation error (swap vectors)\n");
-	
-	fprintf(stderr, "Opening input files, reading swap vectors\n");
-
-	if ((fp = fopen(dlaswp00N_FILE, "rb")) == NULL) quit("Error opening file %s\n", dlaswp00N_FILE);
-	fread(dlaswp00N_IPIV, sizeof(dlaswp00N_IPIV[0]), dlaswp00N_M, fp);
-	fclose(fp);
+#include "../../src/pauxil/HPL_dlaswp00N.c"
+}
 
-	if ((fp = fopen(dlaswp01T_FILE, "rb")) == NULL) quit("Error opening file %s\n", dlaswp01T_FILE);
-	fread(dlaswp01T_LINDXA, sizeof(dlaswp01T_LINDXA[0]), dlaswp01T_M, fp);
-	fread(dlaswp01T_LINDXAU, sizeof(dlaswp01T_LINDXAU[0]), dlaswp01T_M, fp);
-	fclose(fp);
+static void ref_dlaswp01T(const int M, const int N, double *A, const int LDA, double *U, const int LDU, const int *LINDXA, const int *LINDXAU)
+{
+#include "../../src/pauxil/HPL_dlaswp01T.c"
+}
 
-	if ((fp = fopen(dlaswp06T_FILE, "rb")) == NULL) quit("Error opening file %s\n", dlaswp06T_FILE);
-	fread(dlaswp06T_LINDXA, sizeof(dlaswp06T_LINDXA[0]), dlaswp06T_M, fp);
-	fclose(fp);
+static void ref_dlaswp06T(const int M, const int N, double *A, const int LDA, double *U, const int LDU, const int *LINDXA)
+{
+#include "../../src/pauxil/HPL_dlaswp06T.c"
+}
+
+static void ref_dlaswp10N(const int M, const int N, double *A, const int LDA, const int *IPIV)
+{
+#include "../../src/pauxil/HPL_dlaswp10N.c"
+}
+
+static void ref_dlacpy(const int M, const int N, const double *A, const int LDA, double *B, const int LDB)
+{
+	for (int j = 0;j < N;j++) for (int i = 0;i < M;i++) B[(size_t) j * LDB + i] = A[(size_t) j * LDA + i];
+}
+
+static void ref_dlatcpy(const int M, const int N, const double *A, const int LDA, double *B, const int LDB)
+{
+	for (int j = 0;j < N;j++) for (int i = 0;i < M;i++) B[(size_t) j * LDB + i] = A[(size_t) i * LDA + j];
+}
+
+enum kernel_t {K_DLASWP00N, K_DLASWP01T, K_DLASWP06T, K_DLASWP10N, K_DLACPY, K_DLATCPY, K_COUNT};
+static const char* const kernel_names[K_COUNT] = {"dlaswp00N", "dlaswp01T", "dlaswp06T", "dlaswp10N", "dlacpy", "dlatcpy"};
+
+enum pattern_t {P_RANDOM, P_SEQUENTIAL, P_CAPTURED};
+static const char* const pattern_names[] = {"random", "sequential", "captured"};
+
+struct bench_case
+{
+	kernel_t kernel;
+	pattern_t pattern;
+	int M, N, LDA, LDU;			//LDU is LDB for the copy kernels
+	std::vector<int> idx1, idx2;	//IPIV or LINDXA, LINDXAU
+	std::string file;
+};
+
+struct bench_result
+{
+	double time_avg, time_min, bytes, gbps, peak, valid_error;
+	int threads, valid;
+};
+
+struct bench_options
+{
+	std::vector<int> kernels, M, N, LDA, LDU, threads, patterns;
+	std::vector<std::string> files;
+	int warmup, iterations, validate, seed;
+	size_t stream_size;
+	const char* csv;
+	const char* json;
+};
+
+static void usage()
+{
+	fprintf(stderr, "Usage: bench_laswp [options]\n"
+		"  -k list   kernels (dlaswp00N,dlaswp01T,dlaswp06T,dlaswp10N,dlacpy,dlatcpy), default all\n"
+		"  -M list   values for M (kernel argument M), default 1920\n"
+		"  -N list   values for N (kernel argument N), default 23808\n"
+		"  -A list   leading dimensions of A, 0 = minimal, default 0\n"
+		"  -U list   leading dimensions of U (B for dlacpy/dlatcpy), 0 = minimal, default 0\n"
+		"  -t list   TBB thread counts, 0 = TBB default, default 0\n"
+		"  -p list   index patterns (random,sequential), default random\n"
+		"  -f file   captured index file (TRACE_LASWP dump), may be repeated, disables the sweep\n"
+		"  -w n      warmup iterations, default 3\n"
+		"  -i n      timed iterations, default 20\n"
+		"  -s MB     buffer size for the STREAM-like peak measurement, default 1024\n"
+		"  -r seed   seed for patterns and matrix data, default 1\n"
+		"  -v        validate against the reference (USE_ORIGINAL_LASWP) kernels\n"
+		"  -c file   write results as CSV\n"
+		"  -j file   write results as JSON\n"
+		"Lists are comma separated.\n");
+	exit(1);
+}
+
+static void parse_list(const char* arg, std::vector<int>& list)
+{
+	list.clear();
+	const char* ptr = arg;
+	while (*ptr)
+	{
+		list.push_back(atoi(ptr));
+		while (*ptr && *ptr != ',') ptr++;
+		if (*ptr) ptr++;
+	}
+}
+
+static int parse_name(const char* name, const char* const* names, int count)
+{
+	for (int i = 0;i < count;i++) if (strcmp(name, names[i]) == 0) return(i);
+	quit("Unknown name %s\n", name);
+}
+
+static void parse_names(const char* arg, std::vector<int>& list, const char* const* names, int count)
+{
+	char tmp[256];
+	list.clear();
+	const char* ptr = arg;
+	while (*ptr)
+	{
+		size_t len = strcspn(ptr, ",");
+		if (len >= sizeof(tmp)) len = sizeof(tmp) - 1;
+		memcpy(tmp, ptr, len);
+		tmp[len] = 0;
+		list.push_back(parse_name(tmp, names, count));
+		ptr += len;
+		if (*ptr) ptr++;
+	}
+}
+
+static int min_lda(const bench_case& c)
+{
+	switch (c.kernel)
+	{
+	case K_DLASWP00N:
+	case K_DLASWP10N:
+	case K_DLACPY: return(c.M);
+	case K_DLATCPY: return(c.N);
+	default: return(c.M);	//01T and 06T: rows of A addressed by LINDXA, at least M distinct ones
+	}
+}
+
+static int min_ldu(const bench_case& c)
+{
+	switch (c.kernel)
+	{
+	case K_DLASWP01T:
+	case K_DLASWP06T: return(c.N);
+	case K_DLACPY:
+	case K_DLATCPY: return(c.M);
+	default: return(0);
+	}
+}
+
+//Number of columns of A and U
+static size_t cols_a(const bench_case& c) {return(c.kernel == K_DLATCPY ? c.M : c.N);}
+static size_t cols_u(const bench_case& c)
+{
+	switch (c.kernel)
+	{
+	case K_DLASWP01T:
+	case K_DLASWP06T: return(c.M);
+	case K_DLACPY:
+	case K_DLATCPY: return(c.N);
+	default: return(0);
+	}
+}
+
+static int round_ld(int ld)
+{
+	return((ld + 7) & ~7);
+}
+
+static int rand_range(int n)
+{
+	return((int) ((double) rand() / ((double) RAND_MAX + 1.) * n));
+}
+
+//Choose count distinct values out of [0, range) in random or sequential order
+static void distinct(std::vector<int>& out, int count, int range, pattern_t pattern)
+{
+	std::vector<int> tmp(range);
+	for (int i = 0;i < range;i++) tmp[i] = i;
+	if (pattern == P_RANDOM)
+	{
+		for (int i = 0;i < count;i++)
+		{
+			int j = i + rand_range(range - i);
+			int t = tmp[i]; tmp[i] = tmp[j]; tmp[j] = t;
+		}
+	}
+	out.assign(tmp.begin(), tmp.begin() + count);
+}
 
-	if ((fp = fopen(dlaswp10N_FILE, "rb")) == NULL) quit("Error opening file %s\n", dlaswp10N_FILE);
-	fread(dlaswp10N_IPIV, sizeof(dlaswp10N_IPIV[0]), dlaswp10N_N, fp);
+//Interchange sequence as generated by the LU factorization: IPIV[i] >= i
+static void interchanges(std::vector<int>& out, int count, int range, pattern_t pattern)
+{
+	out.resize(count);
+	for (int i = 0;i < count;i++)
+	{
+		if (pattern == P_RANDOM) out[i] = i + rand_range(range - i);
+		else out[i] = (!(i & 1) && i + 1 < range) ? i + 1 : i;
+	}
+}
+
+static void generate_indices(bench_case& c)
+{
+	c.idx1.clear();
+	c.idx2.clear();
+	switch (c.kernel)
+	{
+	case K_DLASWP00N:
+		interchanges(c.idx1, c.M, c.LDA, c.pattern);
+		break;
+	case K_DLASWP10N:
+		interchanges(c.idx1, c.N, c.N, c.pattern);
+		break;
+	case K_DLASWP06T:
+		distinct(c.idx1, c.M, c.LDA, c.pattern);
+		break;
+	case K_DLASWP01T:
+	{
+		//A quarter of the rows is moved within A (to rows not read by the kernel), the rest goes to U
+		distinct(c.idx1, c.M, c.LDA, c.pattern);
+		std::vector<char> used(c.LDA, 0);
+		for (int i = 0;i < c.M;i++) used[c.idx1[i]] = 1;
+		std::vector<int> free_rows;
+		for (int i = 1;i < c.LDA;i++) if (!used[i]) free_rows.push_back(i);
+		std::vector<int> upos;
+		distinct(upos, c.M, c.M, c.pattern);
+		c.idx2.resize(c.M);
+		size_t nfree = 0;
+		for (int i = 0;i < c.M;i++)
+		{
+			if (c.pattern == P_RANDOM && rand_range(4) == 0 && nfree < free_rows.size()) c.idx2[i] = -free_rows[nfree++];
+			else c.idx2[i] = upos[i];
+		}
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+static bool load_captured(const char* filename, bench_case& c)
+{
+	const char* base = strrchr(filename, '/');
+	base = base ? base + 1 : filename;
+	char name[64];
+	size_t len = strcspn(base, ".");
+	if (len >= sizeof(name)) return(false);
+	memcpy(name, base, len);
+	name[len] = 0;
+	c.kernel = (kernel_t) parse_name(name, kernel_names, K_COUNT);
+	c.pattern = P_CAPTURED;
+	c.file = filename;
+
+	int dims[4] = {0, 0, 0, 0};
+	const char* ptr = base + len;
+	for (int i = 0;i < 4 && *ptr == '.' && ptr[1] >= '0' && ptr[1] <= '9';i++)
+	{
+		dims[i] = atoi(ptr + 1);
+		ptr = strchr(ptr + 1, '.');
+		if (ptr == NULL) break;
+	}
+	c.M = dims[0]; c.N = dims[1]; c.LDA = dims[2]; c.LDU = dims[3];
+
+	size_t n1 = 0, n2 = 0;
+	if (c.kernel == K_DLASWP00N || c.kernel == K_DLASWP01T || c.kernel == K_DLASWP06T) n1 = c.M;
+	if (c.kernel == K_DLASWP10N) n1 = c.N;
+	if (c.kernel == K_DLASWP01T) n2 = c.M;
+	c.idx1.resize(n1);
+	c.idx2.resize(n2);
+	if (n1 + n2 == 0) return(true);
+
+	FILE* fp = fopen(filename, "rb");
+	if (fp == NULL) return(false);
+	bool ok = fread(&c.idx1[0], sizeof(int), n1, fp) == n1 && (n2 == 0 || fread(&c.idx2[0], sizeof(int), n2, fp) == n2);
 	fclose(fp);
+	return(ok);
+}
 
-	int max_size = std::max({dlacpy_M, dlacpy_N, dlacpy_LDA, dlacpy_LDB, dlatcpy_M, dlatcpy_N, dlatcpy_LDA, dlatcpy_LDB, dlaswp00N_M, dlaswp00N_N, dlaswp00N_LDA, dlaswp01T_M, dlaswp01T_N, dlaswp01T_LDA, dlaswp01T_LDU, dlaswp06T_M, dlaswp06T_N, dlaswp06T_LDA, dlaswp06T_LDU, dlaswp10N_M, dlaswp10N_N, dlaswp10N_LDA});
-	size_t matrix_size = (size_t) max_size * (size_t) max_size * sizeof(double);
-	
-	fprintf(stderr, "Allocating matrix memory (size %lld KB)", (long long int) matrix_size / 1024);
-	
-	double* matrix_1 = (double*) qmalloc::qMalloc(matrix_size, false, false, true, NULL, true);
-	fprintf(stderr, ".");
-	double* matrix_2 = (double*) qmalloc::qMalloc(matrix_size, false, false, true, NULL, true);
-	fprintf(stderr, ".\n");
-	if (matrix_1 == NULL || matrix_2 == NULL) quit("Memory allocation error (matrices)\n");
-	
-	fprintf(stderr, "Filling matrices with random data\n");
-	fastmatgen(1, matrix_1, matrix_size / sizeof(double));
-	fastmatgen(2, matrix_2, matrix_size / sizeof(double));
-	
-	fprintf(stderr, "Initialization done, running benchmarks\n");
-	
-	for (int i = 0;i < benchmark_warmup + benchmark_iterations;i++)
+static double bytes_moved(const bench_case& c)
+{
+	double rows = 0;
+	switch (c.kernel)
 	{
-		HPL_dlacpy(dlacpy_M, dlacpy_N, matrix_1, dlacpy_LDA, matrix_2, dlacpy_LDB, 1);
-		if (i == benchmark_warmup) timer.ResetStart();
+	case K_DLASWP00N:
+	case K_DLASWP10N:
+		for (size_t i = 0;i < c.idx1.size();i++) if (c.idx1[i] != (int) i) rows++;
+		return(rows * (c.kernel == K_DLASWP00N ? c.N : c.M) * 4. * sizeof(double));
+	case K_DLASWP06T:
+		return((double) c.M * c.N * 4. * sizeof(double));
+	default:
+		return((double) c.M * c.N * 2. * sizeof(double));
 	}
-	fprintf(stderr, "Time dlacpy: %fs\n", timer.GetCurrentElapsedTime() / (double) benchmark_iterations);
+}
 
-	for (int i = 0;i < benchmark_warmup + benchmark_iterations;i++)
+static void run_kernel(const bench_case& c, double* A, double* U, bool reference)
+{
+	const int* i1 = c.idx1.size() ? &c.idx1[0] : NULL;
+	const int* i2 = c.idx2.size() ? &c.idx2[0] : NULL;
+	switch (c.kernel)
 	{
-		HPL_dlatcpy(dlatcpy_M, dlatcpy_N, matrix_1, dlatcpy_LDA, matrix_2, dlatcpy_LDB);
-		if (i == benchmark_warmup) timer.ResetStart();
+	case K_DLASWP00N: if (reference) ref_dlaswp00N(c.M, c.N, A, c.LDA, i1); else HPL_dlaswp00N(c.M, c.N, A, c.LDA, i1); break;
+	case K_DLASWP01T: if (reference) ref_dlaswp01T(c.M, c.N, A, c.LDA, U, c.LDU, i1, i2); else HPL_dlaswp01T(c.M, c.N, A, c.LDA, U, c.LDU, i1, i2); break;
+	case K_DLASWP06T: if (reference) ref_dlaswp06T(c.M, c.N, A, c.LDA, U, c.LDU, i1); else HPL_dlaswp06T(c.M, c.N, A, c.LDA, U, c.LDU, i1); break;
+	case K_DLASWP10N: if (reference) ref_dlaswp10N(c.M, c.N, A, c.LDA, i1); else HPL_dlaswp10N(c.M, c.N, A, c.LDA, i1); break;
+	case K_DLACPY: if (reference) ref_dlacpy(c.M, c.N, A, c.LDA, U, c.LDU); else HPL_dlacpy(c.M, c.N, A, c.LDA, U, c.LDU, 1); break;
+	case K_DLATCPY: if (reference) ref_dlatcpy(c.M, c.N, A, c.LDA, U, c.LDU); else HPL_dlatcpy(c.M, c.N, A, c.LDA, U, c.LDU); break;
+	default: break;
 	}
-	fprintf(stderr, "Time dlatcpy: %fs\n", timer.GetCurrentElapsedTime() / (double) benchmark_iterations);
+}
+
+class stream_copy
+{
+	const double* src;
+	double* dst;
+	public:
+		stream_copy(const double* _src, double* _dst) : src(_src), dst(_dst) {}
+		void operator()(const tbb::blocked_range<size_t>& r) const
+		{
+			memcpy(dst + r.begin(), src + r.begin(), (r.end() - r.begin()) * sizeof(double));
+		}
+};
+
+//STREAM-like copy bandwidth in GB/s (read + write, no write-allocate accounted), best of several runs
+static double measure_peak(size_t bytes, int iterations)
+{
+	size_t n = bytes / sizeof(double);
+	double* a = (double*) qmalloc::qMalloc(n * sizeof(double), false, false, true, NULL, true);
+	double* b = (double*) qmalloc::qMalloc(n * sizeof(double), false, false, true, NULL, true);
+	if (a == NULL || b == NULL) quit("Memory allocation error (stream buffers)\n");
+	fastmatgen(3, a, n);
+	memset(b, 0, n * sizeof(double));
 
-	for (int i = 0;i < benchmark_warmup + benchmark_iterations;i++)
+	HighResTimer timer;
+	double best = 0;
+	for (int i = 0;i < iterations + 1;i++)
 	{
-		HPL_dlaswp00N(dlaswp00N_M, dlaswp00N_N, matrix_1, dlaswp00N_LDA, dlaswp00N_IPIV);
-		if (i == benchmark_warmup) timer.ResetStart();
+		timer.ResetStart();
+		tbb::parallel_for(tbb::blocked_range<size_t>(0, n, 1 << 16), stream_copy(a, b));
+		double t = timer.GetCurrentElapsedTime();
+		if (i && (best == 0 || t < best)) best = t;
 	}
-	fprintf(stderr, "Time dlaswp00N: %fs\n", timer.GetCurrentElapsedTime() / (double) benchmark_iterations);
+	qmalloc::qFree(a);
+	qmalloc::qFree(b);
+	return(2. * n * sizeof(double) / best * 1e-9);
+}
+
+static double* alloc_matrix(size_t elements)
+{
+	if (elements == 0) return(NULL);
+	double* ptr = (double*) qmalloc::qMalloc(elements * sizeof(double), false, false, true, NULL, true);
+	if (ptr == NULL) quit("Memory allocation error (%lld KB)\n", (long long int) (elements * sizeof(double) / 1024));
+	return(ptr);
+}
 
-	for (int i = 0;i < benchmark_warmup + benchmark_iterations;i++)
+static void run_case(const bench_case& c, const bench_options& opt, int threads, double peak, bench_result& res)
+{
+	size_t sizeA = (size_t) c.LDA * cols_a(c);
+	size_t sizeU = (size_t) c.LDU * cols_u(c);
+	double* A = alloc_matrix(sizeA);
+	double* U = alloc_matrix(sizeU);
+	fastmatgen(opt.seed, A, sizeA);
+	if (U) fastmatgen(opt.seed + 1, U, sizeU);
+
+	res.threads = threads;
+	res.peak = peak;
+	res.valid = -1;
+	res.valid_error = 0;
+
+	if (opt.validate)
 	{
-		HPL_dlaswp01T(dlaswp01T_M, dlaswp01T_N, matrix_1, dlaswp01T_LDA, matrix_2, dlaswp01T_LDU, dlaswp01T_LINDXA, dlaswp01T_LINDXAU);
-		if (i == benchmark_warmup) timer.ResetStart();
+		double* A2 = alloc_matrix(sizeA);
+		double* U2 = alloc_matrix(sizeU);
+		memcpy(A2, A, sizeA * sizeof(double));
+		if (U) memcpy(U2, U, sizeU * sizeof(double));
+		run_kernel(c, A, U, false);
+		run_kernel(c, A2, U2, true);
+		size_t errors = 0;
+		for (size_t i = 0;i < sizeA;i++) if (memcmp(&A[i], &A2[i], sizeof(double))) errors++;
+		for (size_t i = 0;i < sizeU;i++) if (memcmp(&U[i], &U2[i], sizeof(double))) errors++;
+		res.valid = errors == 0;
+		res.valid_error = (double) errors;
+		qmalloc::qFree(A2);
+		if (U2) qmalloc::qFree(U2);
+	}
+
+	HighResTimer timer;
+	res.time_min = 0;
+	double total = 0;
+	for (int i = 0;i < opt.warmup + opt.iterations;i++)
+	{
+		timer.ResetStart();
+		run_kernel(c, A, U, false);
+		double t = timer.GetCurrentElapsedTime();
+		if (i < opt.warmup) continue;
+		total += t;
+		if (res.time_min == 0 || t < res.time_min) res.time_min = t;
+	}
+	res.time_avg = total / opt.iterations;
+	res.bytes = bytes_moved(c);
+	res.gbps = res.bytes / res.time_avg * 1e-9;
+
+	qmalloc::qFree(A);
+	if (U) qmalloc::qFree(U);
+}
+
+//The copy kernels have no index pattern, for dlatcpy the transpose engine chosen by size is reported instead
+static const char* case_pattern(const bench_case& c)
+{
+	if (c.kernel == K_DLATCPY) return(HPL_dlatcpy_streaming(c.M, c.N) ? "stream" : "incache");
+	return(pattern_names[c.pattern]);
+}
+
+static void write_csv(FILE* fp, const bench_case& c, const bench_result& r)
+{
+	fprintf(fp, "%s,%s,%d,%d,%d,%d,%d,%.9f,%.9f,%.0f,%.3f,%.3f,%.4f,%s\n", kernel_names[c.kernel], case_pattern(c), c.M, c.N, c.LDA, c.LDU, r.threads,
+		r.time_avg, r.time_min, r.bytes, r.gbps, r.peak, r.gbps / r.peak, r.valid < 0 ? "" : (r.valid ? "pass" : "fail"));
+}
+
+static void write_json(FILE* fp, const bench_case& c, const bench_result& r, bool first)
+{
+	fprintf(fp, "%s\n  {\"kernel\": \"%s\", \"pattern\": \"%s\", \"M\": %d, \"N\": %d, \"LDA\": %d, \"LDU\": %d, \"threads\": %d, "
+		"\"time_avg\": %.9f, \"time_min\": %.9f, \"bytes\": %.0f, \"gbps\": %.3f, \"peak_gbps\": %.3f, \"efficiency\": %.4f",
+		first ? "" : ",", kernel_names[c.kernel], case_pattern(c), c.M, c.N, c.LDA, c.LDU, r.threads,
+		r.time_avg, r.time_min, r.bytes, r.gbps, r.peak, r.gbps / r.peak);
+	if (c.file.size()) fprintf(fp, ", \"file\": \"%s\"", c.file.c_str());
+	if (r.valid >= 0) fprintf(fp, ", \"valid\": %s, \"mismatches\": %.0f", r.valid ? "true" : "false", r.valid_error);
+	fprintf(fp, "}");
+}
+
+int main(int argc, char** argv)
+{
+	bench_options opt;
+	int all_kernels[K_COUNT] = {K_DLASWP00N, K_DLASWP01T, K_DLASWP06T, K_DLASWP10N, K_DLACPY, K_DLATCPY};
+	opt.kernels.assign(all_kernels, all_kernels + K_COUNT);
+	opt.M.push_back(1920);
+	opt.N.push_back(23808);
+	opt.LDA.push_back(0);
+	opt.LDU.push_back(0);
+	opt.threads.push_back(0);
+	opt.patterns.push_back(P_RANDOM);
+	opt.warmup = 3;
+	opt.iterations = 20;
+	opt.validate = 0;
+	opt.seed = 1;
+	opt.stream_size = 1024;
+	opt.csv = NULL;
+	opt.json = NULL;
+
+	for (int i = 1;i < argc;i++)
+	{
+		if (argv[i][0] != '-' || argv[i][1] == 0 || argv[i][2] != 0) usage();
+		char o = argv[i][1];
+		if (o == 'v') {opt.validate = 1; continue;}
+		if (o == 'h' || i + 1 >= argc) usage();
+		const char* arg = argv[++i];
+		switch (o)
+		{
+		case 'k': parse_names(arg, opt.kernels, kernel_names, K_COUNT); break;
+		case 'M': parse_list(arg, opt.M); break;
+		case 'N': parse_list(arg, opt.N); break;
+		case 'A': parse_list(arg, opt.LDA); break;
+		case 'U': parse_list(arg, opt.LDU); break;
+		case 't': parse_list(arg, opt.threads); break;
+		case 'p': parse_names(arg, opt.patterns, pattern_names, P_CAPTURED); break;
+		case 'f': opt.files.push_back(arg); break;
+		case 'w': opt.warmup = atoi(arg); break;
+		case 'i': opt.iterations = atoi(arg); break;
+		case 's': opt.stream_size = atoi(arg); break;
+		case 'r': opt.seed = atoi(arg); break;
+		case 'c': opt.csv = arg; break;
+		case 'j': opt.json = arg; break;
+		default: usage();
+		}
+	}
+	if (opt.iterations < 1) opt.iterations = 1;
+	srand(opt.seed);
+
+	//Build the list of cases, either from captured files or from the sweep
+	std::vector<bench_case> cases;
+	if (opt.files.size())
+	{
+		for (size_t i = 0;i < opt.files.size();i++)
+		{
+			bench_case c;
+			if (!load_captured(opt.files[i].c_str(), c)) quit("Error reading captured index file %s\n", opt.files[i].c_str());
+			if (c.LDA < min_lda(c) || c.LDU < min_ldu(c)) quit("Invalid dimensions in file name %s\n", opt.files[i].c_str());
+			cases.push_back(c);
+		}
+	}
+	else
+	{
+		for (size_t ik = 0;ik < opt.kernels.size();ik++) for (size_t ip = 0;ip < opt.patterns.size();ip++)
+		for (size_t im = 0;im < opt.M.size();im++) for (size_t in = 0;in < opt.N.size();in++)
+		for (size_t ia = 0;ia < opt.LDA.size();ia++) for (size_t iu = 0;iu < opt.LDU.size();iu++)
+		{
+			bench_case c;
+			c.kernel = (kernel_t) opt.kernels[ik];
+			c.pattern = (pattern_t) opt.patterns[ip];
+			c.M = opt.M[im];
+			c.N = opt.N[in];
+			if (c.M <= 0 || c.N <= 0) continue;
+			c.LDA = opt.LDA[ia] ? opt.LDA[ia] : round_ld(min_lda(c));
+			c.LDU = opt.LDU[iu] ? opt.LDU[iu] : round_ld(min_ldu(c));
+			if (c.LDA < min_lda(c) || c.LDU < min_ldu(c) || (c.kernel == K_DLASWP10N && (c.LDA & 1)))
+			{
+				//The optimized dlaswp10N requires an even LDA
+				fprintf(stderr, "Skipping %s M=%d N=%d LDA=%d LDU=%d: invalid leading dimension\n", kernel_names[c.kernel], c.M, c.N, c.LDA, c.LDU);
+				continue;
+			}
+			if ((c.kernel == K_DLASWP00N || c.kernel == K_DLASWP10N) && iu) continue;	//LDU unused
+			if ((c.kernel == K_DLACPY || c.kernel == K_DLATCPY) && ip) continue;		//No index arrays
+			generate_indices(c);
+			cases.push_back(c);
+		}
+	}
+
+	FILE* fpcsv = NULL;
+	FILE* fpjson = NULL;
+	if (opt.csv)
+	{
+		if ((fpcsv = fopen(opt.csv, "w")) == NULL) quit("Error opening %s\n", opt.csv);
+		fprintf(fpcsv, "kernel,pattern,M,N,LDA,LDU,threads,time_avg,time_min,bytes,gbps,peak_gbps,efficiency,valid\n");
+	}
+	if (opt.json)
+	{
+		if ((fpjson = fopen(opt.json, "w")) == NULL) quit("Error opening %s\n", opt.json);
+		fprintf(fpjson, "[");
+	}
+
+	printf("%-10s %-10s %6s %6s %6s %6s %4s %11s %11s %8s %8s %6s %s\n", "kernel", "pattern", "M", "N", "LDA", "LDU", "thr", "avg [s]", "min [s]", "GB/s", "peak", "eff", opt.validate ? "valid" : "");
+
+	int failed = 0;
+	bool first = true;
+	for (size_t it = 0;it < opt.threads.size();it++)
+	{
+		int threads = opt.threads[it] ? opt.threads[it] : tbb::task_scheduler_init::default_num_threads();
+		tbb::task_scheduler_init init(threads);
+		double peak = measure_peak(opt.stream_size << 20, 5);
+		fprintf(stderr, "STREAM-like copy peak with %d threads: %.2f GB/s\n", threads, peak);
+
+		for (size_t ic = 0;ic < cases.size();ic++)
+		{
+			const bench_case& c = cases[ic];
+			bench_result r;
+			run_case(c, opt, threads, peak, r);
+			if (r.valid == 0) failed++;
+			printf("%-10s %-10s %6d %6d %6d %6d %4d %11.6f %11.6f %8.2f %8.2f %5.1f%% %s\n", kernel_names[c.kernel], case_pattern(c), c.M, c.N, c.LDA, c.LDU, threads,
+				r.time_avg, r.time_min, r.gbps, r.peak, 100. * r.gbps / r.peak, r.valid < 0 ? "" : (r.valid ? "pass" : "FAIL"));
+			fflush(stdout);
+			if (fpcsv) write_csv(fpcsv, c, r);
+			if (fpjson) write_json(fpjson, c, r, first);
+			first = false;
+		}
 	}
-	fprintf(stderr, "Time dlaswp01T: %fs\n", timer.GetCurrentElapsedTime() / (double) benchmark_iterations);
 
-	for (int i = 0;i < benchmark_warmup + benchmark_iterations;i++)
+	if (fpcsv) fclose(fpcsv);
+	if (fpjson)
 	{
-		HPL_dlaswp06T(dlaswp06T_M, dlaswp06T_N, matrix_1, dlaswp06T_LDA, matrix_2, dlaswp06T_LDU, dlaswp06T_LINDXA);
-		if (i == benchmark_warmup) timer.ResetStart();
+		fprintf(fpjson, "\n]\n");
+		fclose(fpjson);
 	}
-	fprintf(stderr, "Time dlaswp06T: %fs\n", timer.GetCurrentElapsedTime() / (double) benchmark_iterations);
 
-	for (int i = 0;i < benchmark_warmup + benchmark_iterations;i++)
+	if (opt.validate)
 	{
-		HPL_dlaswp10N(dlaswp10N_M, dlaswp10N_N, matrix_1, dlaswp10N_LDA, dlaswp10N_IPIV);
-		if (i == benchmark_warmup) timer.ResetStart();
+		if (failed) fprintf(stderr, "Validation failed for %d case(s)\n", failed);
+		else fprintf(stderr, "Validation passed\n");
 	}
-	fprintf(stderr, "Time dlaswp10N: %fs\n", timer.GetCurrentElapsedTime() / (double) benchmark_iterations);
-	
-	fprintf(stderr, "Benchmarks done, cleaning up\n");
-	
-	delete[] dlaswp00N_IPIV;
-	delete[] dlaswp01T_LINDXA;
-	delete[] dlaswp01T_LINDXAU;
-	delete[] dlaswp06T_LINDXA;
-	delete[] dlaswp10N_IPIV;
-	
-	qmalloc::qFree(matrix_1);
-	qmalloc::qFree(matrix_2);
-	
-	fprintf(stderr, "All done, exiting\n");
-	
-	return(0);
+	return(failed ? 1 : 0);
 }
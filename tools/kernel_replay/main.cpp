@@ -0,0 +1,394 @@
+/*
+ * Offline replay of kernel call captures of HPL-GPU.
+ *
+ * A run with HPL_KERNEL_CAPTURE enabled writes one capture file per rank
+ * (kernel_capture.<run>.<rank>.bin, see util_capture.h) that contains every
+ * call of the LASWP and copy kernels, of HPL_dtrsm2 and of the pivot row
+ * exchange in HPL_pdmxswp, in program order, with all scalar arguments, the
+ * index arrays and the measured duration of the call. This tool re-executes
+ * the sequence on synthetic buffers of the captured dimensions and reports
+ * the replayed duration next to the captured one, so kernel changes can be
+ * evaluated against the call mix of a real run without a cluster or a GPU.
+ *
+ * Two calls cannot be replayed exactly:
+ *  - HPL_dtrsm2 may have run on the GPU (last argument of the record), it is
+ *    always replayed with cblas_dtrsm on the host.
+ *  - HPL_pdmxswp is an MPI exchange, the replay copies the exchanged message
+ *    volume locally, the network latency is not modelled.
+ *
+ * Run ./kernel_replay -h for the list of options.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <string>
+
+#include <tbb/task_scheduler_init.h>
+
+extern "C" {
+#include "hpl_auxil.h"
+#include "hpl_pauxil.h"
+#include "hpl_blas.h"
+#include "util_capture.h"
+}
+#include "../../caldgemm/cmodules/timer.h"
+#include "../../caldgemm/cmodules/qmalloc.h"
+
+#include "../../testing/ptest/fastmatgen.h"
+
+#define quit(...) {fprintf(stderr, __VA_ARGS__); exit(1);}
+
+static const char* const kernel_names[CAPTURE_KERNEL_COUNT] = {"iteration", "dlaswp00N", "dlaswp01T", "dlaswp06T", "dlaswp10N", "dlatcpy", "dlacpy", "dtrsm2", "pdmxswp"};
+
+struct capture_record
+{
+	capture_record_header_t header;
+	std::vector<int> args, idx1, idx2;
+	int iteration;		//j of the enclosing iteration, -1 before the first marker
+};
+
+struct replay_stats
+{
+	size_t calls;
+	double captured, replayed;
+};
+
+struct replay_options
+{
+	std::vector<std::string> files;
+	int kernels[CAPTURE_KERNEL_COUNT];
+	int iterations, threads;
+	const char* csv;
+};
+
+static void usage()
+{
+	fprintf(stderr, "Usage: kernel_replay [options] capturefile [capturefile ...]\n"
+		"  -k list   replay only these kernels (dlaswp00N,dlaswp01T,dlaswp06T,dlaswp10N,dlatcpy,dlacpy,dtrsm2,pdmxswp), default all\n"
+		"  -i n      repetitions of every call, the minimum time is reported, default 1\n"
+		"  -t n      TBB thread count, 0 = TBB default, default 0\n"
+		"  -c file   write one line per replayed call as CSV\n"
+		"Lists are comma separated.\n");
+	exit(1);
+}
+
+static int parse_kernel(const char* name)
+{
+	for (int i = CAPTURE_ITERATION + 1;i < CAPTURE_KERNEL_COUNT;i++) if (strcmp(name, kernel_names[i]) == 0) return(i);
+	quit("Unknown kernel: %s\n", name);
+}
+
+static void parse_kernels(const char* arg, int* kernels)
+{
+	char tmp[64];
+	memset(kernels, 0, CAPTURE_KERNEL_COUNT * sizeof(int));
+	const char* ptr = arg;
+	while (*ptr)
+	{
+		size_t len = strcspn(ptr, ",");
+		if (len >= sizeof(tmp)) len = sizeof(tmp) - 1;
+		memcpy(tmp, ptr, len);
+		tmp[len] = 0;
+		kernels[parse_kernel(tmp)] = 1;
+		ptr += len;
+		if (*ptr) ptr++;
+	}
+}
+
+static void read_ints(FILE* fp, std::vector<int>& v, int n, const char* filename)
+{
+	v.resize(n);
+	if (n && fread(&v[0], sizeof(int), n, fp) != (size_t) n) quit("Truncated capture file %s\n", filename);
+}
+
+static void load_capture(const char* filename, std::vector<capture_record>& records, capture_file_header_t& header)
+{
+	FILE* fp = fopen(filename, "rb");
+	if (fp == NULL) quit("Cannot open capture file %s\n", filename);
+	if (fread(&header, sizeof(header), 1, fp) != 1 || memcmp(header.magic, CAPTURE_FILE_MAGIC, sizeof(header.magic))) quit("%s is no kernel capture file\n", filename);
+
+	int iteration = -1;
+	capture_record r;
+	while (fread(&r.header, sizeof(r.header), 1, fp) == 1)
+	{
+		if (r.header.kernel < 0 || r.header.kernel >= CAPTURE_KERNEL_COUNT || r.header.nargs < 0 || r.header.n1 < 0 || r.header.n2 < 0) quit("Corrupt record in capture file %s\n", filename);
+		read_ints(fp, r.args, r.header.nargs, filename);
+		read_ints(fp, r.idx1, r.header.n1, filename);
+		read_ints(fp, r.idx2, r.header.n2, filename);
+		if (r.header.kernel == CAPTURE_ITERATION && r.args.size()) iteration = r.args[0];
+		r.iteration = iteration;
+		records.push_back(r);
+	}
+	fclose(fp);
+}
+
+/*
+ * Buffers only grow, so the sequence of a full run needs a single allocation
+ * per buffer. New memory is initialized with random data in [-0.5, 0.5].
+ */
+struct replay_buffer
+{
+	double* ptr;
+	size_t size;
+	int seed;
+
+	replay_buffer(int _seed) : ptr(NULL), size(0), seed(_seed) {}
+	~replay_buffer() {if (ptr) qmalloc::qFree(ptr);}
+
+	double* get(size_t elements)
+	{
+		if (elements <= size) return(ptr);
+		if (ptr) qmalloc::qFree(ptr);
+		ptr = (double*) qmalloc::qMalloc(elements * sizeof(double), false, false, true, NULL, true);
+		if (ptr == NULL) quit("Memory allocation error (%lld KB)\n", (long long int) (elements * sizeof(double) / 1024));
+		fastmatgen(seed, ptr, elements);
+		size = elements;
+		return(ptr);
+	}
+};
+
+static replay_buffer bufA(1), bufB(2), bufB0(3), bufT(4);
+
+//Rows (or columns) addressed by an index array, negative entries of LINDXAU address rows of A
+static size_t max_index(const std::vector<int>& idx)
+{
+	size_t max = 0;
+	for (size_t i = 0;i < idx.size();i++)
+	{
+		size_t v = idx[i] < 0 ? -idx[i] : idx[i];
+		if (v + 1 > max) max = v + 1;
+	}
+	return(max);
+}
+
+//Rows of U addressed by the non-negative entries of LINDXAU
+static size_t max_positive_index(const std::vector<int>& idx)
+{
+	size_t max = 0;
+	for (size_t i = 0;i < idx.size();i++) if (idx[i] >= 0 && (size_t) idx[i] + 1 > max) max = idx[i] + 1;
+	return(max);
+}
+
+static size_t max2(size_t a, size_t b) {return(a > b ? a : b);}
+
+static size_t matrix_size(size_t ld, size_t rows, size_t cols)
+{
+	if (cols == 0) return(0);
+	if (ld < rows) ld = rows;
+	return(ld * cols);
+}
+
+//Triangular factor with unit diagonal and small off-diagonal entries, repeated solves then stay bounded
+static void prepare_triangular(double* A, int k, int lda)
+{
+	for (int j = 0;j < k;j++)
+	{
+		for (int i = 0;i < k;i++) A[(size_t) j * lda + i] *= 1. / k;
+		A[(size_t) j * lda + j] = 1.;
+	}
+}
+
+static bool triangular_prepared(const double* A, int k, int lda)
+{
+	static const double* last_A = NULL;
+	static int last_k = -1, last_lda = -1;
+	if (A == last_A && k == last_k && lda == last_lda) return(true);
+	last_A = A;
+	last_k = k;
+	last_lda = lda;
+	return(false);
+}
+
+//Allocates and initializes the buffers of a call, must not be timed
+static void prepare_call(const capture_record& r)
+{
+	const int* a = r.args.size() ? &r.args[0] : NULL;
+	switch (r.header.kernel)
+	{
+	case CAPTURE_DLASWP00N:
+		bufA.get(matrix_size(a[2], max2(max_index(r.idx1), a[0]), a[1]));
+		break;
+	case CAPTURE_DLASWP10N:
+		bufA.get(matrix_size(a[2], a[0], max2(max_index(r.idx1), a[1])));
+		break;
+	case CAPTURE_DLASWP01T:
+		bufA.get(matrix_size(a[2], max2(max_index(r.idx1), max_index(r.idx2)), a[1]));
+		bufB.get(matrix_size(a[3], a[1], max2(a[0], max_positive_index(r.idx2))));
+		break;
+	case CAPTURE_DLASWP06T:
+		bufA.get(matrix_size(a[2], max2(max_index(r.idx1), max_index(r.idx2)), a[1]));
+		bufB.get(matrix_size(a[3], a[1], a[0]));
+		break;
+	case CAPTURE_DLATCPY:
+		bufA.get(matrix_size(a[2], a[1], a[0]));
+		bufB.get(matrix_size(a[3], a[0], a[1]));
+		break;
+	case CAPTURE_DLACPY:
+		bufA.get(matrix_size(a[2], a[0], a[1]));
+		bufB.get(matrix_size(a[3], a[0], a[1]));
+		break;
+	case CAPTURE_DTRSM2:
+	{
+		const int k = a[1] == HplLeft ? a[5] : a[6];
+		const size_t sizeB = matrix_size(a[8], a[5], a[6]);
+		double* A = bufT.get(matrix_size(a[7], k, k));
+		if (!triangular_prepared(A, k, a[7])) prepare_triangular(A, k, a[7]);
+		memcpy(bufB.get(sizeB), bufB0.get(sizeB), sizeB * sizeof(double));
+		break;
+	}
+	case CAPTURE_PDMXSWP:
+		bufA.get(a[6]);
+		bufB.get(a[6]);
+		break;
+	default:
+		break;
+	}
+}
+
+static void replay_call(const capture_record& r)
+{
+	const int* a = r.args.size() ? &r.args[0] : NULL;
+	const int* i1 = r.idx1.size() ? &r.idx1[0] : NULL;
+	const int* i2 = r.idx2.size() ? &r.idx2[0] : NULL;
+	double* A = bufA.ptr;
+	double* B = bufB.ptr;
+	switch (r.header.kernel)
+	{
+	case CAPTURE_DLASWP00N: HPL_dlaswp00N(a[0], a[1], A, a[2], i1); break;
+	case CAPTURE_DLASWP10N: HPL_dlaswp10N(a[0], a[1], A, a[2], i1); break;
+	case CAPTURE_DLASWP01T: HPL_dlaswp01T(a[0], a[1], A, a[2], B, a[3], i1, i2); break;
+	case CAPTURE_DLASWP06T: HPL_dlaswp06T(a[0], a[1], A, a[2], B, a[3], i1); break;
+	case CAPTURE_DLATCPY: HPL_dlatcpy(a[0], a[1], A, a[2], B, a[3]); break;
+	case CAPTURE_DLACPY: HPL_dlacpy(a[0], a[1], A, a[2], B, a[3], a[4]); break;
+	case CAPTURE_DTRSM2:
+		cblas_dtrsm((HPL_ORDER) a[0], (HPL_SIDE) a[1], (HPL_UPLO) a[2], (HPL_TRANS) a[3], (HPL_DIAG) a[4], a[5], a[6], 1., bufT.ptr, a[7], B, a[8]);
+		break;
+	case CAPTURE_PDMXSWP:
+	{
+		//n0, nprow, mydist, ip2, hdim, cnt_, cnt0: local copies of the message volume of the binary exchange
+		const int n0 = a[0], nprow = a[1], mydist = a[2], ip2 = a[3], hdim = a[4], cnt_ = a[5], cnt0 = a[6];
+		if (nprow != ip2 && (mydist ^ ip2) < nprow) memcpy(B, A, cnt_ * sizeof(double));
+		if (mydist < ip2)
+		{
+			for (int k = 0;k < hdim;k++)
+			{
+				memcpy(B, A, ((mydist >> (k + 1)) == 0 ? cnt0 : cnt_) * sizeof(double));
+				memcpy(A, B, cnt_ * sizeof(double));
+			}
+		}
+		else
+		{
+			memcpy(B, A, n0 * sizeof(double));
+		}
+		if (nprow != ip2 && (mydist ^ ip2) < nprow) memcpy(B, A, cnt_ * sizeof(double));
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+static void write_csv_args(FILE* fp, const capture_record& r)
+{
+	fprintf(fp, "\"");
+	for (size_t i = 0;i < r.args.size();i++) fprintf(fp, "%s%d", i ? " " : "", r.args[i]);
+	fprintf(fp, "\"");
+}
+
+int main(int argc, char** argv)
+{
+	replay_options opt;
+	for (int i = 0;i < CAPTURE_KERNEL_COUNT;i++) opt.kernels[i] = i != CAPTURE_ITERATION;
+	opt.iterations = 1;
+	opt.threads = 0;
+	opt.csv = NULL;
+
+	for (int i = 1;i < argc;i++)
+	{
+		if (argv[i][0] != '-')
+		{
+			opt.files.push_back(argv[i]);
+			continue;
+		}
+		if (strcmp(argv[i], "-h") == 0) usage();
+		if (i + 1 >= argc) usage();
+		const char* arg = argv[++i];
+		switch (argv[i - 1][1])
+		{
+		case 'k': parse_kernels(arg, opt.kernels); break;
+		case 'i': opt.iterations = atoi(arg); break;
+		case 't': opt.threads = atoi(arg); break;
+		case 'c': opt.csv = arg; break;
+		default: usage();
+		}
+	}
+	if (opt.files.size() == 0 || opt.iterations < 1) usage();
+
+	tbb::task_scheduler_init tbb_init(opt.threads ? opt.threads : tbb::task_scheduler_init::automatic);
+
+	FILE* csv = NULL;
+	if (opt.csv)
+	{
+		csv = fopen(opt.csv, "w");
+		if (csv == NULL) quit("Cannot open %s\n", opt.csv);
+		fprintf(csv, "file,rank,call,iteration,kernel,args,captured_s,replayed_s,ratio\n");
+	}
+
+	HighResTimer timer;
+	for (size_t f = 0;f < opt.files.size();f++)
+	{
+		std::vector<capture_record> records;
+		capture_file_header_t header;
+		load_capture(opt.files[f].c_str(), records, header);
+
+		replay_stats stats[CAPTURE_KERNEL_COUNT];
+		memset(stats, 0, sizeof(stats));
+
+		for (size_t i = 0;i < records.size();i++)
+		{
+			const capture_record& r = records[i];
+			if (!opt.kernels[r.header.kernel]) continue;
+
+			double best = 0;
+			for (int k = 0;k < opt.iterations;k++)
+			{
+				prepare_call(r);
+				timer.ResetStart();
+				replay_call(r);
+				double t = timer.GetCurrentElapsedTime();
+				if (k == 0 || t < best) best = t;
+			}
+			const double captured = r.header.duration * 1e-9;
+
+			replay_stats& s = stats[r.header.kernel];
+			s.calls++;
+			s.captured += captured;
+			s.replayed += best;
+			if (csv)
+			{
+				fprintf(csv, "%s,%d,%lld,%d,%s,", opt.files[f].c_str(), header.rank, (long long int) i, r.iteration, kernel_names[r.header.kernel]);
+				write_csv_args(csv, r);
+				fprintf(csv, ",%.9f,%.9f,%.4f\n", captured, best, captured > 0 ? best / captured : 0.);
+			}
+		}
+
+		printf("%s (rank %d, run %d): %lld records\n", opt.files[f].c_str(), header.rank, header.run, (long long int) records.size());
+		printf("%-12s %10s %14s %14s %8s\n", "kernel", "calls", "captured [s]", "replayed [s]", "ratio");
+		replay_stats total;
+		memset(&total, 0, sizeof(total));
+		for (int k = CAPTURE_ITERATION + 1;k < CAPTURE_KERNEL_COUNT;k++)
+		{
+			if (stats[k].calls == 0) continue;
+			printf("%-12s %10lld %14.6f %14.6f %8.3f\n", kernel_names[k], (long long int) stats[k].calls, stats[k].captured, stats[k].replayed, stats[k].captured > 0 ? stats[k].replayed / stats[k].captured : 0.);
+			total.calls += stats[k].calls;
+			total.captured += stats[k].captured;
+			total.replayed += stats[k].replayed;
+		}
+		printf("%-12s %10lld %14.6f %14.6f %8.3f\n\n", "total", (long long int) total.calls, total.captured, total.replayed, total.captured > 0 ? total.replayed / total.captured : 0.);
+	}
+
+	if (csv) fclose(csv);
+	return(0);
+}